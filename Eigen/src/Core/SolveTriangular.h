@@ -77,6 +77,41 @@ struct triangular_solver_selector<Lhs,Rhs,Side,Mode,NoUnrolling,1>
   }
 };
 
+// The right hand sides are independent: parallelize_gemm splits them into panels which are solved by the threads,
+// each one using its own blocking space.
+template<typename Scalar, int Side, int OtherStorageOrder, typename Solver, typename BlockingType>
+struct trsm_functor
+{
+  trsm_functor(Index size, const Scalar* tri, Index triStride, Scalar* other, Index otherStride, BlockingType& blocking)
+    : m_size(size), m_tri(tri), m_triStride(triStride), m_other(other), m_otherStride(otherStride), m_blocking(blocking)
+  {}
+
+  void initParallelSession(Index) const {}
+
+  void operator() (Index row, Index rows, Index col, Index cols, GemmParallelInfo<Index>* info=0) const
+  {
+    Scalar* other = &blas_data_mapper<Scalar,Index,OtherStorageOrder>(m_other, m_otherStride)(row,col);
+    const Index otherSize = Side==OnTheLeft ? cols : rows;
+    if(info==0)
+      Solver::run(m_size, otherSize, m_tri, m_triStride, other, m_otherStride, m_blocking);
+    else
+    {
+      BlockingType blocking(rows, cols, m_size, 1, false);
+      Solver::run(m_size, otherSize, m_tri, m_triStride, other, m_otherStride, blocking);
+    }
+  }
+
+  typedef gebp_traits<Scalar,Scalar> Traits;
+
+  protected:
+    Index m_size;
+    const Scalar* m_tri;
+    Index m_triStride;
+    Scalar* m_other;
+    Index m_otherStride;
+    BlockingType& m_blocking;
+};
+
 // the rhs is a matrix
 template<typename Lhs, typename Rhs, int Side, int Mode>
 struct triangular_solver_selector<Lhs,Rhs,Side,Mode,NoUnrolling,Dynamic>
@@ -90,16 +125,21 @@ struct triangular_solver_selector<Lhs,Rhs,Side,Mode,NoUnrolling,Dynamic>
     typename internal::add_const_on_value_type<ActualLhsType>::type actualLhs = LhsProductTraits::extract(lhs);
 
     const Index size = lhs.rows();
-    const Index othersize = Side==OnTheLeft? rhs.cols() : rhs.rows();
 
     typedef internal::gemm_blocking_space<(Rhs::Flags&RowMajorBit) ? RowMajor : ColMajor,Scalar,Scalar,
               Rhs::MaxRowsAtCompileTime, Rhs::MaxColsAtCompileTime, Lhs::MaxRowsAtCompileTime,4> BlockingType;
 
     BlockingType blocking(rhs.rows(), rhs.cols(), size, 1, false);
 
-    triangular_solve_matrix<Scalar,Index,Side,Mode,LhsProductTraits::NeedToConjugate,(int(Lhs::Flags) & RowMajorBit) ? RowMajor : ColMajor,
-                               (Rhs::Flags&RowMajorBit) ? RowMajor : ColMajor>
-      ::run(size, othersize, &actualLhs.coeffRef(0,0), actualLhs.outerStride(), &rhs.coeffRef(0,0), rhs.outerStride(), blocking);
+    enum { OtherStorageOrder = (Rhs::Flags&RowMajorBit) ? RowMajor : ColMajor };
+    typedef triangular_solve_matrix<Scalar,Index,Side,Mode,LhsProductTraits::NeedToConjugate,(int(Lhs::Flags) & RowMajorBit) ? RowMajor : ColMajor,
+                               OtherStorageOrder> Solver;
+    typedef trsm_functor<Scalar,Side,OtherStorageOrder,Solver,BlockingType> Functor;
+
+    enum { MaxOtherSize = Side==OnTheLeft ? Rhs::MaxColsAtCompileTime : Rhs::MaxRowsAtCompileTime };
+    internal::parallelize_gemm<(MaxOtherSize>32 || MaxOtherSize==Dynamic)>
+        (Functor(size, &actualLhs.coeffRef(0,0), actualLhs.outerStride(), &rhs.coeffRef(0,0), rhs.outerStride(), blocking),
+         rhs.rows(), rhs.cols(), size, Side==OnTheRight);
   }
 };
 
@@ -38,6 +38,20 @@
 #define EIGEN_TUNE_TRIANGULAR_PANEL_WIDTH 8
 #endif
 
+/** Defines the maximal number of columns (or rows) of the result of a matrix product for which the
+  * large operand is read in place by the skinny product kernels instead of being packed. The default is 16.
+  */
+#ifndef EIGEN_SKINNY_PRODUCT_MAX_SIZE
+#define EIGEN_SKINNY_PRODUCT_MAX_SIZE 16
+#endif
+
+/** Defines the minimal number of coefficients of the matrix per thread for which the matrix * vector products
+  * (level 2 blas xGEMV, xSYMV and xTRMV) are split across several threads. The default is 65536.
+  */
+#ifndef EIGEN_GEMV_PARALLEL_THRESHOLD
+#define EIGEN_GEMV_PARALLEL_THRESHOLD 65536
+#endif
+
 
 /** Defines the default number of registers available for that architecture.
   * Currently it must be 8 or 16. Other values will fail.
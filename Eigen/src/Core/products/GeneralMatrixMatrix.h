@@ -467,6 +467,17 @@ struct generic_product_impl<Lhs,Rhs,DenseShape,DenseShape,GemmProduct>
     Scalar actualAlpha = alpha * LhsBlasTraits::extractScalarFactor(a_lhs)
                                * RhsBlasTraits::extractScalarFactor(a_rhs);
 
+#ifndef EIGEN_USE_BLAS
+    // when the result has only a few columns (or rows), packing the large operand costs as much as the product itself
+    if(is_same<LhsScalar,Scalar>::value && is_same<RhsScalar,Scalar>::value
+       && (numext::mini)(dst.rows(),dst.cols()) <= EIGEN_SKINNY_PRODUCT_MAX_SIZE
+       && (numext::maxi)(dst.rows(),dst.cols()) >= 4*EIGEN_SKINNY_PRODUCT_MAX_SIZE)
+    {
+      skinnyScaleAndAddTo(dst, lhs, rhs, actualAlpha);
+      return;
+    }
+#endif
+
     typedef internal::gemm_blocking_space<(Dest::Flags&RowMajorBit) ? RowMajor : ColMajor,LhsScalar,RhsScalar,
             Dest::MaxRowsAtCompileTime,Dest::MaxColsAtCompileTime,MaxDepthAtCompileTime> BlockingType;
 
@@ -483,6 +494,33 @@ struct generic_product_impl<Lhs,Rhs,DenseShape,DenseShape,GemmProduct>
     internal::parallelize_gemm<(Dest::MaxRowsAtCompileTime>32 || Dest::MaxRowsAtCompileTime==Dynamic)>
         (GemmFunctor(lhs, rhs, dst, actualAlpha, blocking), a_lhs.rows(), a_rhs.cols(), a_lhs.cols(), Dest::Flags&RowMajorBit);
   }
+
+  template<typename Dest>
+  static void skinnyScaleAndAddTo(Dest& dst, const ActualLhsTypeCleaned& lhs, const ActualRhsTypeCleaned& rhs, const Scalar& alpha)
+  {
+    enum {
+      LhsOrder = (ActualLhsTypeCleaned::Flags&RowMajorBit) ? RowMajor : ColMajor,
+      RhsOrder = (ActualRhsTypeCleaned::Flags&RowMajorBit) ? RowMajor : ColMajor,
+      DstOrder = (Dest::Flags&RowMajorBit) ? RowMajor : ColMajor
+    };
+    const Scalar* lhsData = reinterpret_cast<const Scalar*>(&lhs.coeffRef(0,0));
+    const Scalar* rhsData = reinterpret_cast<const Scalar*>(&rhs.coeffRef(0,0));
+    Scalar* dstData = &dst.coeffRef(0,0);
+    if(dst.cols() <= EIGEN_SKINNY_PRODUCT_MAX_SIZE)
+      internal::general_matrix_skinny_product<Index,
+        Scalar, LhsOrder, bool(LhsBlasTraits::NeedToConjugate),
+        RhsOrder, bool(RhsBlasTraits::NeedToConjugate), DstOrder>
+      ::run(dst.rows(), dst.cols(), lhs.cols(), lhsData, lhs.outerStride(), rhsData, rhs.outerStride(),
+            dstData, dst.outerStride(), alpha);
+    else
+      // dst^T += alpha * rhs^T * lhs^T, whose result has a few columns
+      internal::general_matrix_skinny_product<Index,
+        Scalar, int(RhsOrder)==int(RowMajor) ? ColMajor : RowMajor, bool(RhsBlasTraits::NeedToConjugate),
+        int(LhsOrder)==int(RowMajor) ? ColMajor : RowMajor, bool(LhsBlasTraits::NeedToConjugate),
+        int(DstOrder)==int(RowMajor) ? ColMajor : RowMajor>
+      ::run(dst.cols(), dst.rows(), lhs.cols(), rhsData, rhs.outerStride(), lhsData, lhs.outerStride(),
+            dstData, dst.outerStride(), alpha);
+  }
 };
 
 } // end namespace internal
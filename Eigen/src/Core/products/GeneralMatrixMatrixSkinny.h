@@ -0,0 +1,250 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GENERAL_MATRIX_MATRIX_SKINNY_H
+#define EIGEN_GENERAL_MATRIX_MATRIX_SKINNY_H
+
+namespace Eigen {
+
+namespace internal {
+
+/* Optimized products res += alpha * lhs * rhs where res has only a few columns, e.g., the product of a
+ * matrix by a handful of vectors:
+ *
+ * The general kernel copies both operands into packed blocks before using them, which costs an extra pass
+ * over the large operand lhs when res is that skinny. Here lhs is read in place, exactly once:
+ *  - a col-major lhs is processed by panels of rows, the rows of 4 columns of res being accumulated in registers
+ *    as linear combinations of the columns of lhs (axpy kernel). The depth is split such that the slices of
+ *    lhs and rhs which are used several times stay in cache.
+ *  - a row-major lhs is processed by pairs of rows, the coefficients of res being accumulated in registers as
+ *    the dot products of these rows by a few columns of rhs (dot kernel).
+ * Both kernels write a col-major or a row-major res in place. The products whose result has a few rows are
+ * the transpose of such products, see generic_product_impl::skinnyScaleAndAddTo.
+ */
+template<typename Index, typename Scalar, int LhsStorageOrder, bool ConjugateLhs,
+         int RhsStorageOrder, bool ConjugateRhs, int ResStorageOrder>
+struct general_matrix_skinny_product
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum { PacketSize = packet_traits<Scalar>::size };
+  typedef const_blas_data_mapper<Scalar, Index, RhsStorageOrder> RhsMapper;
+  typedef blas_data_mapper<Scalar, Index, ResStorageOrder> ResMapper;
+
+  // res(0:RowPackets*PacketSize, j:j+Cols) += alpha * lhs(0:RowPackets*PacketSize, 0:depth) * rhs(0:depth, j:j+Cols)
+  template<typename PacketType, int RowPackets, int Cols>
+  static EIGEN_STRONG_INLINE void axpy_block(const Scalar* lhs, Index lhsStride, const RhsMapper& rhs, Index j,
+                                             Index depth, const ResMapper& res, const Scalar& alpha)
+  {
+    enum { Size = unpacket_traits<PacketType>::size };
+    conj_helper<PacketType,PacketType,ConjugateLhs,ConjugateRhs> pcj;
+    PacketType acc[RowPackets][Cols];
+    for(int c = 0; c < Cols; ++c)
+      for(int r = 0; r < RowPackets; ++r)
+        acc[r][c] = pset1<PacketType>(Scalar(0));
+    for(Index k = 0; k < depth; ++k)
+    {
+      PacketType a[RowPackets];
+      for(int r = 0; r < RowPackets; ++r)
+        a[r] = ploadu<PacketType>(lhs + k*lhsStride + r*Size);
+      for(int c = 0; c < Cols; ++c)
+      {
+        const PacketType b = pset1<PacketType>(rhs(k, j+c));
+        for(int r = 0; r < RowPackets; ++r)
+          acc[r][c] = pcj.pmadd(a[r], b, acc[r][c]);
+      }
+    }
+    const PacketType palpha = pset1<PacketType>(alpha);
+    for(int c = 0; c < Cols; ++c)
+      for(int r = 0; r < RowPackets; ++r)
+      {
+        if(ResStorageOrder==ColMajor)
+        {
+          Scalar* p = &res(r*Size, j+c);
+          pstoreu(p, padd(ploadu<PacketType>(p), pmul(acc[r][c], palpha)));
+        }
+        else
+        {
+          Scalar tmp[Size];
+          pstoreu(tmp, pmul(acc[r][c], palpha));
+          for(int s = 0; s < Size; ++s)
+            res(r*Size+s, j+c) += tmp[s];
+        }
+      }
+  }
+
+  // res(0:RowPackets*PacketSize, j:cols) for cols-j <= Cols, in a single block
+  template<typename PacketType, int RowPackets, int Cols>
+  static EIGEN_STRONG_INLINE void axpy_tail(Index cols, const Scalar* lhs, Index lhsStride, const RhsMapper& rhs,
+                                            Index j, Index depth, const ResMapper& res, const Scalar& alpha)
+  {
+    if(cols-j==Cols)
+      axpy_block<PacketType,RowPackets,Cols>(lhs, lhsStride, rhs, j, depth, res, alpha);
+    else if(Cols>1)
+      axpy_tail<PacketType,RowPackets,(Cols>1 ? Cols-1 : 1)>(cols, lhs, lhsStride, rhs, j, depth, res, alpha);
+  }
+
+  template<typename PacketType, int RowPackets>
+  static EIGEN_STRONG_INLINE void axpy_panel(Index cols, const Scalar* lhs, Index lhsStride, const RhsMapper& rhs,
+                                             Index depth, const ResMapper& res, const Scalar& alpha)
+  {
+    Index j = 0;
+    for(; j+4 <= cols; j += 4)
+      axpy_block<PacketType,RowPackets,4>(lhs, lhsStride, rhs, j, depth, res, alpha);
+    if(j < cols)
+      axpy_tail<PacketType,RowPackets,3>(cols, lhs, lhsStride, rhs, j, depth, res, alpha);
+  }
+
+  // rows [r0,r1) of res += alpha * lhs * rhs, for a col-major lhs
+  static void run_axpy(Index r0, Index r1, Index cols, Index depth,
+                       const Scalar* lhs, Index lhsStride, const RhsMapper& rhs,
+                       const ResMapper& res, const Scalar& alpha)
+  {
+    // Up to 4 columns of res are accumulated in registers: lhs is then read once, and the slice of rhs fills half
+    // of L1. Otherwise the slice of a panel of lhs is read again for each block of 4 columns of res, and is kept
+    // short enough to remain in cache even when the stride of lhs maps all its lines to the same L1 set.
+    std::ptrdiff_t l1, l2, l3;
+    manage_caching_sizes(GetAction, &l1, &l2, &l3);
+    const Index kc = cols <= 4 ? numext::maxi<Index>(16, Index(l1) / (cols*Index(2*sizeof(Scalar)))) : 32;
+
+    for(Index k2 = 0; k2 < depth; k2 += kc)
+    {
+      const Index actual_kc = (numext::mini)(k2+kc,depth)-k2;
+      const RhsMapper rhs_k2 = rhs.getSubMapper(k2, 0);
+      const Scalar* lhs_k2 = lhs + k2*lhsStride;
+      Index i = r0;
+      for(; i+2*PacketSize <= r1; i += 2*PacketSize)
+        axpy_panel<Packet,2>(cols, lhs_k2+i, lhsStride, rhs_k2, actual_kc, res.getSubMapper(i,0), alpha);
+      if(PacketSize>1 && i+PacketSize <= r1)
+      {
+        axpy_panel<Packet,1>(cols, lhs_k2+i, lhsStride, rhs_k2, actual_kc, res.getSubMapper(i,0), alpha);
+        i += PacketSize;
+      }
+      for(; i < r1; ++i)
+        axpy_panel<Scalar,1>(cols, lhs_k2+i, lhsStride, rhs_k2, actual_kc, res.getSubMapper(i,0), alpha);
+    }
+  }
+
+  // res(i:i+Rows, j:j+Cols) += alpha * lhs(i:i+Rows, 0:depth) * rhs(0:depth, j:j+Cols)
+  template<int Rows, int Cols>
+  static EIGEN_STRONG_INLINE void dot_block(Index i, Index j, Index depth, const Scalar* lhs, Index lhsStride,
+                                            const Scalar* rhs, Index rhsStride, const ResMapper& res,
+                                            const Scalar& alpha)
+  {
+    conj_helper<Packet,Packet,ConjugateLhs,ConjugateRhs> pcj;
+    conj_helper<Scalar,Scalar,ConjugateLhs,ConjugateRhs> cj;
+    const Scalar* a = lhs + i*lhsStride;
+    const Scalar* b = rhs + j*rhsStride;
+    Packet acc[Rows][Cols];
+    for(int c = 0; c < Cols; ++c)
+      for(int r = 0; r < Rows; ++r)
+        acc[r][c] = pset1<Packet>(Scalar(0));
+    const Index peeled = (depth/PacketSize)*PacketSize;
+    for(Index k = 0; k < peeled; k += PacketSize)
+    {
+      Packet pa[Rows];
+      for(int r = 0; r < Rows; ++r)
+        pa[r] = ploadu<Packet>(a + r*lhsStride + k);
+      for(int c = 0; c < Cols; ++c)
+      {
+        const Packet pb = ploadu<Packet>(b + c*rhsStride + k);
+        for(int r = 0; r < Rows; ++r)
+          acc[r][c] = pcj.pmadd(pa[r], pb, acc[r][c]);
+      }
+    }
+    for(int c = 0; c < Cols; ++c)
+      for(int r = 0; r < Rows; ++r)
+      {
+        Scalar s = predux(acc[r][c]);
+        for(Index k = peeled; k < depth; ++k)
+          s = cj.pmadd(a[r*lhsStride+k], b[c*rhsStride+k], s);
+        res(i+r, j+c) += alpha * s;
+      }
+  }
+
+  template<int Rows>
+  static EIGEN_STRONG_INLINE void dot_rows(Index i, Index cols, Index depth, const Scalar* lhs, Index lhsStride,
+                                           const Scalar* rhs, Index rhsStride, const ResMapper& res,
+                                           const Scalar& alpha)
+  {
+    Index j = 0;
+    for(; j+4 <= cols; j += 4)
+      dot_block<Rows,4>(i, j, depth, lhs, lhsStride, rhs, rhsStride, res, alpha);
+    if(j+2 <= cols)
+    {
+      dot_block<Rows,2>(i, j, depth, lhs, lhsStride, rhs, rhsStride, res, alpha);
+      j += 2;
+    }
+    if(j < cols)
+      dot_block<Rows,1>(i, j, depth, lhs, lhsStride, rhs, rhsStride, res, alpha);
+  }
+
+  // rows [r0,r1) of res += alpha * lhs * rhs, for a row-major lhs and a col-major rhs
+  static void run_dot(Index r0, Index r1, Index cols, Index depth,
+                      const Scalar* lhs, Index lhsStride, const Scalar* rhs, Index rhsStride,
+                      const ResMapper& res, const Scalar& alpha)
+  {
+    Index i = r0;
+    for(; i+2 <= r1; i += 2)
+      dot_rows<2>(i, cols, depth, lhs, lhsStride, rhs, rhsStride, res, alpha);
+    if(i < r1)
+      dot_rows<1>(i, cols, depth, lhs, lhsStride, rhs, rhsStride, res, alpha);
+  }
+
+  static void run(Index rows, Index cols, Index depth,
+                  const Scalar* _lhs, Index lhsStride, const Scalar* _rhs, Index rhsStride,
+                  Scalar* _res, Index resStride, const Scalar& alpha)
+  {
+    // the dot kernel reads the columns of rhs, which is the small operand, in place
+    typedef Matrix<Scalar,Dynamic,Dynamic,ColMajor> ColMajorRhs;
+    ColMajorRhs rhsCopy;
+    if(LhsStorageOrder==RowMajor && RhsStorageOrder==RowMajor)
+    {
+      rhsCopy = Map<const Matrix<Scalar,Dynamic,Dynamic,RowMajor>, 0, OuterStride<> >(_rhs, depth, cols, OuterStride<>(rhsStride));
+      _rhs = rhsCopy.data();
+      rhsStride = depth;
+    }
+    RhsMapper rhs(_rhs, rhsStride);
+    ResMapper res(_res, resStride);
+
+    Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+    // same heuristic as parallelize_gemm, the threads sharing the rows of the result
+    threads = (std::min)(rows/(4*PacketSize), Index(double(rows) * double(cols) * double(depth) / 50000));
+    threads = (std::min)(Index(nbThreads()), threads);
+    if(omp_get_num_threads()>1)
+      threads = 1;
+    if(threads>1)
+    {
+      #pragma omp parallel num_threads(threads)
+      {
+        const Index tid = omp_get_thread_num();
+        const Index actual_threads = omp_get_num_threads();
+        const Index blockRows = ((rows/actual_threads)/(2*PacketSize))*(2*PacketSize);
+        const Index r0 = tid*blockRows;
+        const Index r1 = tid+1==actual_threads ? rows : r0+blockRows;
+        if(LhsStorageOrder==ColMajor)
+          run_axpy(r0, r1, cols, depth, _lhs, lhsStride, rhs, res, alpha);
+        else
+          run_dot(r0, r1, cols, depth, _lhs, lhsStride, _rhs, rhsStride, res, alpha);
+      }
+    }
+#endif
+    if(threads<=1)
+    {
+      if(LhsStorageOrder==ColMajor)
+        run_axpy(0, rows, cols, depth, _lhs, lhsStride, rhs, res, alpha);
+      else
+        run_dot(0, rows, cols, depth, _lhs, lhsStride, _rhs, rhsStride, res, alpha);
+    }
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_GENERAL_MATRIX_MATRIX_SKINNY_H
@@ -62,6 +62,55 @@ struct general_matrix_matrix_triangular_product<Index,LhsScalar,LhsStorageOrder,
                                       const RhsScalar* _rhs, Index rhsStride, ResScalar* _res, Index resStride,
                                       const ResScalar& alpha, level3_blocking<LhsScalar,RhsScalar>& blocking)
   {
+#ifdef EIGEN_HAS_OPENMP
+    typedef gebp_traits<LhsScalar,RhsScalar> Traits;
+    // The rows of the result are split across the threads into blocks having the same number of coefficients in the
+    // triangular part. Each block is the sum of a rectangular block, computed by the gemm kernel, and of a triangular
+    // block on the diagonal, computed by the sequential kernel run_sequential().
+    // The thresholds are the ones of parallelize_gemm, applied to the actual amount of work.
+    Index threads = (std::min)(Index(nbThreads()), size/Index(Traits::nr));
+    threads = (std::min)(threads, Index(0.5 * double(size) * double(size) * double(depth) / 50000.));
+    if(threads>1 && omp_get_num_threads()==1)
+    {
+      typedef gemm_blocking_space<ColMajor,LhsScalar,RhsScalar,Dynamic,Dynamic,Dynamic> BlockingType;
+      typedef general_matrix_matrix_product<Index,LhsScalar,LhsStorageOrder,ConjugateLhs,
+                                            RhsScalar,RhsStorageOrder,ConjugateRhs,ColMajor> Gemm;
+      const_blas_data_mapper<LhsScalar, Index, LhsStorageOrder> lhs(_lhs,lhsStride);
+      const_blas_data_mapper<RhsScalar, Index, RhsStorageOrder> rhs(_rhs,rhsStride);
+      blas_data_mapper<ResScalar, Index, ColMajor> res(_res, resStride);
+      Eigen::initParallel();
+      #pragma omp parallel num_threads(threads)
+      {
+        const Index tid = omp_get_thread_num();
+        const Index actual_threads = omp_get_num_threads();
+        const Index r0 = triangular_block_start<Index>(size, 0, UpLo==Lower, tid, actual_threads, Traits::mr);
+        const Index r1 = triangular_block_start<Index>(size, 0, UpLo==Lower, tid+1, actual_threads, Traits::mr);
+        // the columns of the rectangular block
+        const Index c0 = UpLo==Lower ? 0  : r1;
+        const Index c1 = UpLo==Lower ? r0 : size;
+        if(r1>r0)
+        {
+          if(c1>c0)
+          {
+            BlockingType gemmBlocking(r1-r0, c1-c0, depth, 1, true);
+            Gemm::run(r1-r0, c1-c0, depth, &lhs(r0,0), lhsStride, &rhs(0,c0), rhsStride,
+                      &res(r0,c0), resStride, alpha, gemmBlocking);
+          }
+          BlockingType diagBlocking(r1-r0, r1-r0, depth, 1, false);
+          run_sequential(r1-r0, depth, &lhs(r0,0), lhsStride, &rhs(0,r0), rhsStride, &res(r0,r0), resStride,
+                         alpha, diagBlocking);
+        }
+      }
+      return;
+    }
+#endif
+    run_sequential(size, depth, _lhs, lhsStride, _rhs, rhsStride, _res, resStride, alpha, blocking);
+  }
+
+  static void run_sequential(Index size, Index depth,const LhsScalar* _lhs, Index lhsStride,
+                             const RhsScalar* _rhs, Index rhsStride, ResScalar* _res, Index resStride,
+                             const ResScalar& alpha, level3_blocking<LhsScalar,RhsScalar>& blocking)
+  {
     typedef gebp_traits<LhsScalar,RhsScalar> Traits;
 
     typedef const_blas_data_mapper<LhsScalar, Index, LhsStorageOrder> LhsMapper;
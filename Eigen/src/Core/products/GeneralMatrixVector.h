@@ -14,6 +14,84 @@ namespace Eigen {
 
 namespace internal {
 
+/* Multi-threaded matrix * vector product:
+ * The product is bandwidth bound, so that large products are worth splitting across the threads, whatever the
+ * number of flops. The rows of the result are split across the threads, unless there are too few of them, in which
+ * case the columns are split and the threads accumulate into private copies of the result which are then summed.
+ * Each thread calls the sequential kernel Kernel::run_sequential() on its part, such that the product is never split
+ * again, even when OpenMP grants a single thread to the parallel region.
+ * This is only implemented for the blas data mappers, \returns false when the product has not been computed.
+ */
+template<typename Kernel, typename Index, typename LhsMapper, typename RhsMapper, typename ResScalar, typename AlphaType>
+EIGEN_STRONG_INLINE bool parallelize_gemv(Index, Index, const LhsMapper&, const RhsMapper&, ResScalar*, Index, const AlphaType&)
+{
+  return false;
+}
+
+template<typename Kernel, typename Index, typename LhsScalar, int LhsStorageOrder, typename RhsScalar, int RhsStorageOrder,
+         typename ResScalar, typename AlphaType>
+bool parallelize_gemv(Index rows, Index cols,
+                      const const_blas_data_mapper<LhsScalar,Index,LhsStorageOrder>& lhs,
+                      const const_blas_data_mapper<RhsScalar,Index,RhsStorageOrder>& rhs,
+                      ResScalar* res, Index resIncr, const AlphaType& alpha)
+{
+#ifdef EIGEN_HAS_OPENMP
+  Index threads = (std::min)(Index(nbThreads()), Index(double(rows) * double(cols) / double(EIGEN_GEMV_PARALLEL_THRESHOLD)));
+  if(threads<=1 || omp_get_num_threads()>1)
+    return false;
+
+  // each thread works on at least a few cache lines of every column of a col-major lhs,
+  // and on a multiple of the number of rows processed at once by the kernels
+  const Index minBlockRows = LhsStorageOrder==ColMajor ? 256 : 4;
+  const Index rowGranularity = LhsStorageOrder==ColMajor ? 16 : 4;
+  if(rows >= threads*minBlockRows)
+  {
+    Eigen::initParallel();
+    #pragma omp parallel num_threads(threads)
+    {
+      const Index tid = omp_get_thread_num();
+      const Index actual_threads = omp_get_num_threads();
+      const Index blockRows = ((rows / actual_threads) / rowGranularity) * rowGranularity;
+      const Index r0 = tid*blockRows;
+      const Index r1 = tid+1==actual_threads ? rows : r0+blockRows;
+      Kernel::run_sequential(r1-r0, cols, lhs.getSubMapper(r0,0), rhs, res + r0*resIncr, resIncr, alpha);
+    }
+    return true;
+  }
+
+  Eigen::initParallel();
+  ei_declare_aligned_stack_constructed_variable(ResScalar,partial,(threads-1)*rows,0);
+  #pragma omp parallel num_threads(threads)
+  {
+    const Index tid = omp_get_thread_num();
+    const Index actual_threads = omp_get_num_threads();
+    const Index blockCols = ((cols / actual_threads) / 4) * 4;
+    const Index c0 = tid*blockCols;
+    const Index c1 = tid+1==actual_threads ? cols : c0+blockCols;
+    // the first thread accumulates into res, the other ones into their own copy
+    ResScalar* actual_res = tid==0 ? res : partial + (tid-1)*rows;
+    if(tid>0)
+      Map<Matrix<ResScalar,Dynamic,1> >(actual_res, rows).setZero();
+    Kernel::run_sequential(rows, c1-c0, lhs.getSubMapper(0,c0), rhs.getSubMapper(c0,0), actual_res, tid==0 ? resIncr : 1, alpha);
+    #pragma omp barrier
+    #pragma omp for schedule(static)
+    for(Index i = 0; i < rows; ++i)
+      for(Index t = 1; t < actual_threads; ++t)
+        res[i*resIncr] += partial[(t-1)*rows + i];
+  }
+  return true;
+#else
+  EIGEN_UNUSED_VARIABLE(rows);
+  EIGEN_UNUSED_VARIABLE(cols);
+  EIGEN_UNUSED_VARIABLE(lhs);
+  EIGEN_UNUSED_VARIABLE(rhs);
+  EIGEN_UNUSED_VARIABLE(res);
+  EIGEN_UNUSED_VARIABLE(resIncr);
+  EIGEN_UNUSED_VARIABLE(alpha);
+  return false;
+#endif
+}
+
 /* Optimized col-major matrix * vector product:
  * This algorithm processes 4 columns at onces that allows to both reduce
  * the number of load/stores of the result by a factor 4 and to reduce
@@ -76,7 +154,19 @@ typedef typename conditional<Vectorizable,_LhsPacket,LhsScalar>::type LhsPacket;
 typedef typename conditional<Vectorizable,_RhsPacket,RhsScalar>::type RhsPacket;
 typedef typename conditional<Vectorizable,_ResPacket,ResScalar>::type ResPacket;
 
-EIGEN_DONT_INLINE static void run(
+EIGEN_STRONG_INLINE static void run(
+  Index rows, Index cols,
+  const LhsMapper& lhs,
+  const RhsMapper& rhs,
+        ResScalar* res, Index resIncr,
+  RhsScalar alpha)
+{
+  if(!parallelize_gemv<general_matrix_vector_product>(rows, cols, lhs, rhs, res, resIncr, alpha))
+    run_sequential(rows, cols, lhs, rhs, res, resIncr, alpha);
+}
+
+// sequential kernel, also called by each thread of parallelize_gemv()
+EIGEN_DONT_INLINE static void run_sequential(
   Index rows, Index cols,
   const LhsMapper& lhs,
   const RhsMapper& rhs,
@@ -85,7 +175,7 @@ EIGEN_DONT_INLINE static void run(
 };
 
 template<typename Index, typename LhsScalar, typename LhsMapper, bool ConjugateLhs, typename RhsScalar, typename RhsMapper, bool ConjugateRhs, int Version>
-EIGEN_DONT_INLINE void general_matrix_vector_product<Index,LhsScalar,LhsMapper,ColMajor,ConjugateLhs,RhsScalar,RhsMapper,ConjugateRhs,Version>::run(
+EIGEN_DONT_INLINE void general_matrix_vector_product<Index,LhsScalar,LhsMapper,ColMajor,ConjugateLhs,RhsScalar,RhsMapper,ConjugateRhs,Version>::run_sequential(
   Index rows, Index cols,
   const LhsMapper& lhs,
   const RhsMapper& rhs,
@@ -352,7 +442,19 @@ typedef typename conditional<Vectorizable,_LhsPacket,LhsScalar>::type LhsPacket;
 typedef typename conditional<Vectorizable,_RhsPacket,RhsScalar>::type RhsPacket;
 typedef typename conditional<Vectorizable,_ResPacket,ResScalar>::type ResPacket;
 
-EIGEN_DONT_INLINE static void run(
+EIGEN_STRONG_INLINE static void run(
+  Index rows, Index cols,
+  const LhsMapper& lhs,
+  const RhsMapper& rhs,
+        ResScalar* res, Index resIncr,
+  ResScalar alpha)
+{
+  if(!parallelize_gemv<general_matrix_vector_product>(rows, cols, lhs, rhs, res, resIncr, alpha))
+    run_sequential(rows, cols, lhs, rhs, res, resIncr, alpha);
+}
+
+// sequential kernel, also called by each thread of parallelize_gemv()
+EIGEN_DONT_INLINE static void run_sequential(
   Index rows, Index cols,
   const LhsMapper& lhs,
   const RhsMapper& rhs,
@@ -361,7 +463,7 @@ EIGEN_DONT_INLINE static void run(
 };
 
 template<typename Index, typename LhsScalar, typename LhsMapper, bool ConjugateLhs, typename RhsScalar, typename RhsMapper, bool ConjugateRhs, int Version>
-EIGEN_DONT_INLINE void general_matrix_vector_product<Index,LhsScalar,LhsMapper,RowMajor,ConjugateLhs,RhsScalar,RhsMapper,ConjugateRhs,Version>::run(
+EIGEN_DONT_INLINE void general_matrix_vector_product<Index,LhsScalar,LhsMapper,RowMajor,ConjugateLhs,RhsScalar,RhsMapper,ConjugateRhs,Version>::run_sequential(
   Index rows, Index cols,
   const LhsMapper& lhs,
   const RhsMapper& rhs,
@@ -0,0 +1,284 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PACKED_MATRIX_H
+#define EIGEN_PACKED_MATRIX_H
+
+namespace Eigen {
+
+template<typename PackedMatrixType, typename Rhs> struct PackedMatrixProduct;
+
+namespace internal {
+
+template<typename PackedMatrixType, typename Rhs> struct traits<PackedMatrixProduct<PackedMatrixType, Rhs> >
+{
+  typedef Matrix<typename PackedMatrixType::Scalar, Dynamic, Rhs::ColsAtCompileTime,
+                 ColMajor, Dynamic, Rhs::MaxColsAtCompileTime> ReturnType;
+};
+
+} // end namespace internal
+
+/** \ingroup Core_Module
+  *
+  * \class PackedMatrix
+  *
+  * \brief A matrix stored in the packed format of the matrix product kernel, to be the left hand side of many products
+  *
+  * \tparam _MatrixType the type of the packed matrix
+  *
+  * Before computing a matrix product, Eigen copies the blocks of its operands into the layout expected by its
+  * product kernel. When the same left hand side takes part in many products, e.g. the weights \c W of \c W*x in
+  * an inference loop, this packing is repeated for nothing. A PackedMatrix performs it once: it stores the whole
+  * matrix as the sequence of packed blocks the product would create, such that its products only pack their
+  * right hand side.
+  * \code
+  * PackedMatrix<MatrixXf> Wp(W);
+  * for(...)
+  * {
+  *   y = Wp * x;                     // same as y = W * x
+  *   Wp.scaleAndAddTo(z, x, 2.f);    // same as z += 2.f * W * x
+  * }
+  * \endcode
+  *
+  * The blocking sizes are chosen by compute(), for products with about \a colsHint columns. The products are
+  * performed in parallel when OpenMP is enabled, each thread handling a range of rows of the result.
+  *
+  * As for other products, the result may be assigned to a matrix involved in the right hand side, e.g.
+  * \c x \c = \c Wp \c * \c x or \c x \c = \c Wp \c * \c (x+y): unless the right hand side is a plain matrix
+  * other than the destination, it is evaluated into a temporary before the destination is written. The packed
+  * matrix must then be square since \c x cannot be resized before it is read.
+  * scaleAndAddTo() assumes that \a dst and \a rhs do not alias.
+  *
+  * \sa setCpuCacheSizes()
+  */
+template<typename _MatrixType> class PackedMatrix
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef internal::gebp_traits<Scalar,Scalar> Traits;
+
+    /** Default constructor, compute() must be called before the matrix is used in a product. */
+    PackedMatrix() : m_rows(0), m_cols(0), m_mc(1), m_kc(1), m_isInitialized(false) {}
+
+    /** Packs \a matrix, see compute(). */
+    template<typename InputType>
+    explicit PackedMatrix(const EigenBase<InputType>& matrix, Index colsHint = 1)
+      : m_rows(0), m_cols(0), m_mc(1), m_kc(1), m_isInitialized(false)
+    {
+      compute(matrix.derived(), colsHint);
+    }
+
+    /** Packs \a matrix for products with right hand sides of about \a colsHint columns. */
+    template<typename InputType>
+    PackedMatrix& compute(const EigenBase<InputType>& matrix, Index colsHint = 1);
+
+    /** \returns the number of rows of the packed matrix */
+    inline Index rows() const { return m_rows; }
+    /** \returns the number of columns of the packed matrix */
+    inline Index cols() const { return m_cols; }
+
+    /** \returns an expression of the product of the packed matrix by \a rhs, to be assigned to a dense matrix */
+    template<typename Rhs>
+    PackedMatrixProduct<PackedMatrix, Rhs> operator*(const MatrixBase<Rhs>& rhs) const
+    {
+      eigen_assert(m_isInitialized && "PackedMatrix is not initialized.");
+      return PackedMatrixProduct<PackedMatrix, Rhs>(*this, rhs.derived());
+    }
+
+    /** Performs \a dst += \a alpha * \c M * \a rhs, \c M being the packed matrix */
+    template<typename Dest, typename Rhs>
+    void scaleAndAddTo(Dest& dst, const Rhs& rhs, const Scalar& alpha) const;
+
+  protected:
+    // the packed block of the rows [i2, i2+mc) and of the columns [k2, k2+kc)
+    const Scalar* block(Index i2, Index k2) const
+    { return m_blocks.data() + m_offsets.coeff((i2/m_mc) * numext::div_ceil(m_cols, m_kc) + k2/m_kc); }
+
+    template<int RhsStorageOrder, bool ConjugateRhs>
+    void run(Index r0, Index r1, Index cols, const Scalar* rhs, Index rhsStride,
+             Scalar* res, Index resStride, const Scalar& alpha) const;
+
+    Index m_rows, m_cols;
+    Index m_mc, m_kc;                  // blocking sizes along the rows and the columns
+    Matrix<Scalar,Dynamic,1> m_blocks; // the packed blocks, the blocks of a panel of rows being consecutive
+    Matrix<Index,Dynamic,1> m_offsets; // the position of each block in m_blocks
+    bool m_isInitialized;
+};
+
+template<typename MatrixType>
+template<typename InputType>
+PackedMatrix<MatrixType>& PackedMatrix<MatrixType>::compute(const EigenBase<InputType>& matrix, Index colsHint)
+{
+  typedef internal::const_blas_data_mapper<Scalar, Index, ColMajor> LhsMapper;
+  const Ref<const Matrix<Scalar,Dynamic,Dynamic,ColMajor>, 0, OuterStride<> > mat(matrix.derived());
+  m_rows = mat.rows();
+  m_cols = mat.cols();
+
+  Index kc = m_cols, mc = m_rows, nc = numext::maxi<Index>(colsHint, 1);
+  internal::computeProductBlockingSizes<Scalar,Scalar,1>(kc, mc, nc);
+  // the products split the panels of rows between threads along multiples of mr
+  if(mc<m_rows)
+    mc = numext::maxi<Index>(Traits::mr, mc - mc%Traits::mr);
+  m_mc = numext::maxi<Index>(mc, 1);
+  m_kc = numext::maxi<Index>(kc, 1);
+
+  // the kernel loads the packed blocks with aligned loads
+  const Index align = numext::maxi<Index>(1, EIGEN_MAX_ALIGN_BYTES/Index(sizeof(Scalar)));
+  const Index kBlocks = numext::div_ceil(m_cols, m_kc);
+  m_offsets.resize(numext::div_ceil(m_rows, m_mc) * kBlocks);
+  Index size = 0;
+  for(Index i2 = 0, b = 0; i2 < m_rows; i2 += m_mc)
+    for(Index k2 = 0; k2 < m_cols; k2 += m_kc, ++b)
+    {
+      m_offsets.coeffRef(b) = size;
+      size += numext::div_ceil(((numext::mini)(i2+m_mc,m_rows)-i2) * ((numext::mini)(k2+m_kc,m_cols)-k2), align) * align;
+    }
+  m_blocks.resize(size);
+
+  internal::gemm_pack_lhs<Scalar, Index, LhsMapper, Traits::mr, Traits::LhsProgress, ColMajor> pack_lhs;
+  LhsMapper lhs(mat.data(), mat.outerStride());
+  for(Index i2 = 0; i2 < m_rows; i2 += m_mc)
+    for(Index k2 = 0; k2 < m_cols; k2 += m_kc)
+      pack_lhs(const_cast<Scalar*>(block(i2, k2)), lhs.getSubMapper(i2, k2),
+               (numext::mini)(k2+m_kc,m_cols)-k2, (numext::mini)(i2+m_mc,m_rows)-i2);
+
+  m_isInitialized = true;
+  return *this;
+}
+
+template<typename MatrixType>
+template<typename Dest, typename Rhs>
+void PackedMatrix<MatrixType>::scaleAndAddTo(Dest& dst, const Rhs& rhs, const Scalar& alpha) const
+{
+  EIGEN_STATIC_ASSERT((internal::is_same<typename Rhs::Scalar, Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  eigen_assert(m_isInitialized && "PackedMatrix is not initialized.");
+  eigen_assert(rhs.rows()==m_cols && dst.rows()==m_rows && dst.cols()==rhs.cols() && "invalid matrix product");
+
+  if(m_rows==0 || rhs.cols()==0 || m_cols==0)
+    return;
+
+  // the kernel writes to a column-major destination
+  if(!(int(Dest::InnerStrideAtCompileTime)==1 && ((int(Dest::Flags)&RowMajorBit)==0 || int(Dest::ColsAtCompileTime)==1)))
+  {
+    typename internal::traits<PackedMatrixProduct<PackedMatrix, Rhs> >::ReturnType tmp(m_rows, rhs.cols());
+    tmp.setZero();
+    scaleAndAddTo(tmp, rhs, alpha);
+    dst += tmp;
+    return;
+  }
+
+  typedef internal::blas_traits<Rhs> RhsBlasTraits;
+  typedef typename RhsBlasTraits::DirectLinearAccessType ActualRhsType;
+  typedef typename internal::remove_all<ActualRhsType>::type ActualRhsTypeCleaned;
+  enum { RhsStorageOrder = (int(ActualRhsTypeCleaned::Flags)&RowMajorBit) ? RowMajor : ColMajor };
+  typename internal::add_const_on_value_type<ActualRhsType>::type actualRhs = RhsBlasTraits::extract(rhs);
+  const Scalar actualAlpha = alpha * RhsBlasTraits::extractScalarFactor(rhs);
+  const Index cols = rhs.cols();
+
+#ifdef EIGEN_HAS_OPENMP
+  // same heuristic as parallelize_gemm, the threads sharing the rows of the result
+  Index threads = (std::min)(m_rows/Traits::mr, Index(double(m_rows) * double(cols) * double(m_cols) / 50000));
+  threads = (std::min)(Index(nbThreads()), threads);
+  if(threads>1 && omp_get_num_threads()==1)
+  {
+    #pragma omp parallel num_threads(threads)
+    {
+      const Index tid = omp_get_thread_num();
+      const Index actual_threads = omp_get_num_threads();
+      const Index blockRows = ((m_rows/actual_threads)/Traits::mr)*Traits::mr;
+      const Index r0 = tid*blockRows;
+      const Index r1 = tid+1==actual_threads ? m_rows : r0+blockRows;
+      run<RhsStorageOrder, RhsBlasTraits::NeedToConjugate>(r0, r1, cols, &actualRhs.coeffRef(0,0), actualRhs.outerStride(),
+                                                          &dst.coeffRef(0,0), dst.outerStride(), actualAlpha);
+    }
+    return;
+  }
+#endif
+
+  run<RhsStorageOrder, RhsBlasTraits::NeedToConjugate>(0, m_rows, cols, &actualRhs.coeffRef(0,0), actualRhs.outerStride(),
+                                                      &dst.coeffRef(0,0), dst.outerStride(), actualAlpha);
+}
+
+// Computes the rows [r0, r1) of the product, r0 being a multiple of mr.
+template<typename MatrixType>
+template<int RhsStorageOrder, bool ConjugateRhs>
+void PackedMatrix<MatrixType>::run(Index r0, Index r1, Index cols, const Scalar* _rhs, Index rhsStride,
+                                   Scalar* _res, Index resStride, const Scalar& alpha) const
+{
+  typedef internal::const_blas_data_mapper<Scalar, Index, RhsStorageOrder> RhsMapper;
+  typedef internal::blas_data_mapper<Scalar, Index, ColMajor> ResMapper;
+  RhsMapper rhs(_rhs, rhsStride);
+  ResMapper res(_res, resStride);
+
+  internal::gemm_pack_rhs<Scalar, Index, RhsMapper, Traits::nr, RhsStorageOrder> pack_rhs;
+  internal::gebp_kernel<Scalar, Scalar, Index, ResMapper, Traits::mr, Traits::nr, false, ConjugateRhs> gebp;
+
+  Index kc = m_kc, mc = m_mc, nc = cols;
+  internal::computeProductBlockingSizes<Scalar,Scalar,1>(kc, mc, nc);
+  nc = (numext::mini)(nc, cols);
+  ei_declare_aligned_stack_constructed_variable(Scalar, blockB, m_kc*nc, 0);
+
+  // each packed block of the rhs is used by all the panels of rows
+  for(Index k2 = 0; k2 < m_cols; k2 += m_kc)
+  {
+    const Index actual_kc = (numext::mini)(k2+m_kc,m_cols)-k2;
+    for(Index j2 = 0; j2 < cols; j2 += nc)
+    {
+      const Index actual_nc = (numext::mini)(j2+nc,cols)-j2;
+      pack_rhs(blockB, rhs.getSubMapper(k2,j2), actual_kc, actual_nc);
+      for(Index i2 = (r0/m_mc)*m_mc; i2 < r1; i2 += m_mc)
+      {
+        // a range of rows of a packed block, starting at a multiple of mr, is packed as a block by itself
+        const Index start = (numext::maxi)(i2, r0);
+        const Index end = (numext::mini)((numext::mini)(i2+m_mc,m_rows), r1);
+        gebp(res.getSubMapper(start,j2), block(i2,k2) + (start-i2)*actual_kc, blockB,
+             end-start, actual_kc, actual_nc, alpha);
+      }
+    }
+  }
+}
+
+/** \internal Expression of the product of a PackedMatrix by a dense matrix */
+template<typename PackedMatrixType, typename Rhs>
+struct PackedMatrixProduct : ReturnByValue<PackedMatrixProduct<PackedMatrixType, Rhs> >
+{
+  PackedMatrixProduct(const PackedMatrixType& lhs, const Rhs& rhs) : m_lhs(lhs), m_rhs(rhs) {}
+
+  inline Index rows() const { return m_lhs.rows(); }
+  inline Index cols() const { return m_rhs.cols(); }
+
+  template<typename DesType>
+  void evalTo(DesType& res) const
+  {
+    typedef typename PackedMatrixType::Scalar Scalar;
+    typedef internal::blas_traits<Rhs> RhsBlasTraits;
+    typedef typename internal::remove_all<typename RhsBlasTraits::ExtractType>::type ActualRhsType;
+    if(internal::is_same<ActualRhsType, typename ActualRhsType::PlainObject>::value
+       && !internal::is_same_dense(res, RhsBlasTraits::extract(m_rhs)))
+    {
+      res.resize(rows(), cols());
+      res.setZero();
+      m_lhs.scaleAndAddTo(res, m_rhs, Scalar(1));
+      return;
+    }
+    // e.g., x = Wp * x or x = Wp * (x+y), the rhs must be entirely read before res is overwritten
+    eigen_assert(m_rhs.rows()==m_lhs.cols() && "the right hand side of a PackedMatrix product cannot be resized by its assignment");
+    typename Rhs::PlainObject rhs(m_rhs);
+    res.resize(rows(), cols());
+    res.setZero();
+    m_lhs.scaleAndAddTo(res, rhs, Scalar(1));
+  }
+
+  const PackedMatrixType& m_lhs;
+  const Rhs& m_rhs;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_PACKED_MATRIX_H
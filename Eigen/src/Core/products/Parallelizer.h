@@ -82,6 +82,24 @@ template<typename Index> struct GemmParallelInfo
   Index lhs_length;
 };
 
+/** \internal \returns the first row of the \a t -th of \a n blocks of rows of a triangular (or trapezoidal)
+  * matrix of \a size rows having the same number of coefficients, the i-th row having \a offset + i + 1
+  * coefficients if \a increasing is true, and \a offset + \a size - i otherwise.
+  * The result is rounded down to a multiple of \a granularity. */
+template<typename Index>
+Index triangular_block_start(Index size, Index offset, bool increasing, Index t, Index n, Index granularity = 1)
+{
+  if(t<=0) return 0;
+  if(t>=n) return size;
+  // solve offset*x + x^2/2 = area, where x is the number of rows before (or after) the block
+  const double total = double(size) * (double(offset) + 0.5*double(size));
+  const double area = total * double(increasing ? t : n-t) / double(n);
+  const double x = std::sqrt(double(offset)*double(offset) + 2.*area) - double(offset);
+  Index start = increasing ? Index(x) : size - Index(x);
+  start = (std::max)(Index(0),(std::min)(size,start));
+  return (start/granularity)*granularity;
+}
+
 template<bool Condition, typename Functor, typename Index>
 void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth, bool transpose)
 {
@@ -464,7 +464,48 @@ EIGEN_DONT_INLINE void product_selfadjoint_matrix<Scalar,Index,LhsStorageOrder,f
 ***************************************************************************/
 
 namespace internal {
-  
+
+// The columns of the result (or its rows, when the selfadjoint matrix is on the right) are independent:
+// parallelize_gemm splits them into panels which are computed by the threads, each one using its own blocking space.
+template<typename Scalar, typename Lhs, typename Rhs, typename Dest, typename Symm, typename BlockingType>
+struct symm_functor
+{
+  symm_functor(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Scalar& actualAlpha, BlockingType& blocking)
+    : m_lhs(lhs), m_rhs(rhs), m_dest(dest), m_actualAlpha(actualAlpha), m_blocking(blocking)
+  {}
+
+  void initParallelSession(Index) const {}
+
+  void operator() (Index row, Index rows, Index col, Index cols, GemmParallelInfo<Index>* info=0) const
+  {
+    if(info==0)
+      run(row, rows, col, cols, m_blocking);
+    else
+    {
+      BlockingType blocking(rows, cols, m_lhs.cols(), 1, false);
+      run(row, rows, col, cols, blocking);
+    }
+  }
+
+  typedef gebp_traits<Scalar,Scalar> Traits;
+
+  protected:
+    void run(Index row, Index rows, Index col, Index cols, BlockingType& blocking) const
+    {
+      Symm::run(rows, cols,
+                &m_lhs.coeffRef(row,0), m_lhs.outerStride(),
+                &m_rhs.coeffRef(0,col), m_rhs.outerStride(),
+                &m_dest.coeffRef(row,col), m_dest.outerStride(),
+                m_actualAlpha, blocking);
+    }
+
+    const Lhs& m_lhs;
+    const Rhs& m_rhs;
+    Dest& m_dest;
+    Scalar m_actualAlpha;
+    BlockingType& m_blocking;
+};
+
 template<typename Lhs, int LhsMode, typename Rhs, int RhsMode>
 struct selfadjoint_product_impl<Lhs,LhsMode,false,Rhs,RhsMode,false>
 {
@@ -498,19 +539,19 @@ struct selfadjoint_product_impl<Lhs,LhsMode,false,Rhs,RhsMode,false>
 
     BlockingType blocking(lhs.rows(), rhs.cols(), lhs.cols(), 1, false);
 
-    internal::product_selfadjoint_matrix<Scalar, Index,
+    typedef internal::product_selfadjoint_matrix<Scalar, Index,
       EIGEN_LOGICAL_XOR(LhsIsUpper,internal::traits<Lhs>::Flags &RowMajorBit) ? RowMajor : ColMajor, LhsIsSelfAdjoint,
       NumTraits<Scalar>::IsComplex && EIGEN_LOGICAL_XOR(LhsIsUpper,bool(LhsBlasTraits::NeedToConjugate)),
       EIGEN_LOGICAL_XOR(RhsIsUpper,internal::traits<Rhs>::Flags &RowMajorBit) ? RowMajor : ColMajor, RhsIsSelfAdjoint,
       NumTraits<Scalar>::IsComplex && EIGEN_LOGICAL_XOR(RhsIsUpper,bool(RhsBlasTraits::NeedToConjugate)),
-      internal::traits<Dest>::Flags&RowMajorBit  ? RowMajor : ColMajor>
-      ::run(
-        lhs.rows(), rhs.cols(),                 // sizes
-        &lhs.coeffRef(0,0), lhs.outerStride(),  // lhs info
-        &rhs.coeffRef(0,0), rhs.outerStride(),  // rhs info
-        &dst.coeffRef(0,0), dst.outerStride(),  // result info
-        actualAlpha, blocking                   // alpha
-      );
+      internal::traits<Dest>::Flags&RowMajorBit  ? RowMajor : ColMajor> Symm;
+    typedef symm_functor<Scalar, typename internal::remove_all<ActualLhsType>::type, typename internal::remove_all<ActualRhsType>::type,
+                         Dest, Symm, BlockingType> Functor;
+
+    // the panels are taken from the side of the non selfadjoint operand
+    enum { MaxOtherSize = LhsIsSelfAdjoint ? int(Rhs::MaxColsAtCompileTime) : int(Lhs::MaxRowsAtCompileTime) };
+    internal::parallelize_gemm<(MaxOtherSize>32 || MaxOtherSize==Dynamic)>
+        (Functor(lhs, rhs, dst, actualAlpha, blocking), lhs.rows(), rhs.cols(), lhs.cols(), !LhsIsSelfAdjoint);
   }
 };
 
@@ -18,6 +18,10 @@ namespace internal {
  * This algorithm processes 2 columns at onces that allows to both reduce
  * the number of load/stores of the result by a factor 2 and to reduce
  * the instruction dependency.
+ *
+ * When the matrix is large enough, the columns are split across the threads into blocks having the same number of
+ * coefficients. Since each column updates the whole lower (or upper) part of the result, the threads accumulate into
+ * private copies of the result which are then summed.
  */
 
 template<typename Scalar, typename Index, int StorageOrder, int UpLo, bool ConjugateLhs, bool ConjugateRhs, int Version=Specialized>
@@ -33,6 +37,15 @@ static EIGEN_DONT_INLINE void run(
   const Scalar*  rhs,
   Scalar* res,
   Scalar alpha);
+
+// processes the columns [j0,j1) of the stored triangular part only
+static EIGEN_DONT_INLINE void run(
+  Index size,
+  const Scalar*  lhs, Index lhsStride,
+  const Scalar*  rhs,
+  Scalar* res,
+  Scalar alpha,
+  Index j0, Index j1);
 };
 
 template<typename Scalar, typename Index, int StorageOrder, int UpLo, bool ConjugateLhs, bool ConjugateRhs, int Version>
@@ -42,6 +55,45 @@ EIGEN_DONT_INLINE void selfadjoint_matrix_vector_product<Scalar,Index,StorageOrd
   const Scalar*  rhs,
   Scalar* res,
   Scalar alpha)
+{
+#ifdef EIGEN_HAS_OPENMP
+  enum { FirstTriangular = (StorageOrder==RowMajor) == (UpLo==Lower) };
+  Index threads = (std::min)(Index(nbThreads()), Index(0.5 * double(size) * double(size) / double(EIGEN_GEMV_PARALLEL_THRESHOLD)));
+  if(threads>1 && omp_get_num_threads()==1)
+  {
+    Eigen::initParallel();
+    ei_declare_aligned_stack_constructed_variable(Scalar,partial,(threads-1)*size,0);
+    #pragma omp parallel num_threads(threads)
+    {
+      const Index tid = omp_get_thread_num();
+      const Index actual_threads = omp_get_num_threads();
+      const Index j0 = triangular_block_start<Index>(size, 0, FirstTriangular, tid, actual_threads, 2);
+      const Index j1 = triangular_block_start<Index>(size, 0, FirstTriangular, tid+1, actual_threads, 2);
+      // the first thread accumulates into res, the other ones into their own copy
+      Scalar* actual_res = tid==0 ? res : partial + (tid-1)*size;
+      if(tid>0)
+        Map<Matrix<Scalar,Dynamic,1> >(actual_res, size).setZero();
+      run(size, lhs, lhsStride, rhs, actual_res, alpha, j0, j1);
+      #pragma omp barrier
+      #pragma omp for schedule(static)
+      for(Index i = 0; i < size; ++i)
+        for(Index t = 1; t < actual_threads; ++t)
+          res[i] += partial[(t-1)*size + i];
+    }
+    return;
+  }
+#endif
+  run(size, lhs, lhsStride, rhs, res, alpha, 0, size);
+}
+
+template<typename Scalar, typename Index, int StorageOrder, int UpLo, bool ConjugateLhs, bool ConjugateRhs, int Version>
+EIGEN_DONT_INLINE void selfadjoint_matrix_vector_product<Scalar,Index,StorageOrder,UpLo,ConjugateLhs,ConjugateRhs,Version>::run(
+  Index size,
+  const Scalar*  lhs, Index lhsStride,
+  const Scalar*  rhs,
+  Scalar* res,
+  Scalar alpha,
+  Index j0, Index j1)
 {
   typedef typename packet_traits<Scalar>::type Packet;
   typedef typename NumTraits<Scalar>::Real RealScalar;
@@ -67,8 +119,16 @@ EIGEN_DONT_INLINE void selfadjoint_matrix_vector_product<Scalar,Index,StorageOrd
   if (FirstTriangular)
     bound = size - bound;
 
-  for (Index j=FirstTriangular ? bound : 0;
-       j<(FirstTriangular ? size : bound);j+=2)
+  // the columns [pairStart,pairEnd) are processed two at a time, the other ones of [j0,j1) one at a time
+  Index pairStart = (std::min)(j1, (std::max)(j0, FirstTriangular ? bound : Index(0)));
+  Index pairEnd   = (std::max)(pairStart, (std::min)(j1, FirstTriangular ? size : bound));
+  if ((pairEnd-pairStart)%2)
+  {
+    if (FirstTriangular) ++pairStart;
+    else                 --pairEnd;
+  }
+
+  for (Index j=pairStart; j<pairEnd; j+=2)
   {
     const Scalar* EIGEN_RESTRICT A0 = lhs + j*lhsStride;
     const Scalar* EIGEN_RESTRICT A1 = lhs + (j+1)*lhsStride;
@@ -135,7 +195,7 @@ EIGEN_DONT_INLINE void selfadjoint_matrix_vector_product<Scalar,Index,StorageOrd
     res[j]   += alpha * (t2 + predux(ptmp2));
     res[j+1] += alpha * (t3 + predux(ptmp3));
   }
-  for (Index j=FirstTriangular ? 0 : bound;j<(FirstTriangular ? bound : size);j++)
+  for (Index j=FirstTriangular ? j0 : pairEnd;j<(FirstTriangular ? pairStart : j1);j++)
   {
     const Scalar* EIGEN_RESTRICT A0 = lhs + j*lhsStride;
 
@@ -388,6 +388,49 @@ EIGEN_DONT_INLINE void product_triangular_matrix_matrix<Scalar,Index,Mode,false,
 } // end namespace internal
 
 namespace internal {
+
+// The columns of the result (or its rows, when the triangular matrix is on the right) are independent:
+// parallelize_gemm splits them into panels which are computed by the threads, each one using its own blocking space.
+template<typename Scalar, typename Lhs, typename Rhs, typename Dest, typename Trmm, typename BlockingType>
+struct trmm_functor
+{
+  trmm_functor(const Lhs& lhs, const Rhs& rhs, Dest& dest, Index depth, const Scalar& actualAlpha, BlockingType& blocking)
+    : m_lhs(lhs), m_rhs(rhs), m_dest(dest), m_depth(depth), m_actualAlpha(actualAlpha), m_blocking(blocking)
+  {}
+
+  void initParallelSession(Index) const {}
+
+  void operator() (Index row, Index rows, Index col, Index cols, GemmParallelInfo<Index>* info=0) const
+  {
+    if(info==0)
+      run(row, rows, col, cols, m_blocking);
+    else
+    {
+      BlockingType blocking(rows, cols, m_depth, 1, false);
+      run(row, rows, col, cols, blocking);
+    }
+  }
+
+  typedef gebp_traits<Scalar,Scalar> Traits;
+
+  protected:
+    void run(Index row, Index rows, Index col, Index cols, BlockingType& blocking) const
+    {
+      Trmm::run(rows, cols, m_depth,
+                &m_lhs.coeffRef(row,0), m_lhs.outerStride(),
+                &m_rhs.coeffRef(0,col), m_rhs.outerStride(),
+                &m_dest.coeffRef(row,col), m_dest.outerStride(),
+                m_actualAlpha, blocking);
+    }
+
+    const Lhs& m_lhs;
+    const Rhs& m_rhs;
+    Dest& m_dest;
+    Index m_depth;
+    Scalar m_actualAlpha;
+    BlockingType& m_blocking;
+};
+
 template<int Mode, bool LhsIsTriangular, typename Lhs, typename Rhs>
 struct triangular_product_impl<Mode,LhsIsTriangular,Lhs,false,Rhs,false>
 {
@@ -419,18 +462,17 @@ struct triangular_product_impl<Mode,LhsIsTriangular,Lhs,false,Rhs,false>
 
     BlockingType blocking(stripedRows, stripedCols, stripedDepth, 1, false);
 
-    internal::product_triangular_matrix_matrix<Scalar, Index,
+    typedef internal::product_triangular_matrix_matrix<Scalar, Index,
       Mode, LhsIsTriangular,
       (internal::traits<ActualLhsTypeCleaned>::Flags&RowMajorBit) ? RowMajor : ColMajor, LhsBlasTraits::NeedToConjugate,
       (internal::traits<ActualRhsTypeCleaned>::Flags&RowMajorBit) ? RowMajor : ColMajor, RhsBlasTraits::NeedToConjugate,
-      (internal::traits<Dest          >::Flags&RowMajorBit) ? RowMajor : ColMajor>
-      ::run(
-        stripedRows, stripedCols, stripedDepth,   // sizes
-        &lhs.coeffRef(0,0), lhs.outerStride(),    // lhs info
-        &rhs.coeffRef(0,0), rhs.outerStride(),    // rhs info
-        &dst.coeffRef(0,0), dst.outerStride(),    // result info
-        actualAlpha, blocking
-      );
+      (internal::traits<Dest          >::Flags&RowMajorBit) ? RowMajor : ColMajor> Trmm;
+    typedef trmm_functor<Scalar, ActualLhsTypeCleaned, ActualRhsTypeCleaned, Dest, Trmm, BlockingType> Functor;
+
+    // the panels are taken from the side of the non triangular operand
+    enum { MaxOtherSize = LhsIsTriangular ? int(Rhs::MaxColsAtCompileTime) : int(Lhs::MaxRowsAtCompileTime) };
+    internal::parallelize_gemm<(MaxOtherSize>32 || MaxOtherSize==Dynamic)>
+        (Functor(lhs, rhs, dst, stripedDepth, actualAlpha, blocking), stripedRows, stripedCols, stripedDepth, !LhsIsTriangular);
   }
 };
 
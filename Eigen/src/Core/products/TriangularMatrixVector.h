@@ -17,6 +17,66 @@ namespace internal {
 template<typename Index, int Mode, typename LhsScalar, bool ConjLhs, typename RhsScalar, bool ConjRhs, int StorageOrder, int Version=Specialized>
 struct triangular_matrix_vector_product;
 
+/* Multi-threaded triangular matrix * vector product:
+ * The rows of the result are split across the threads into blocks having the same number of coefficients.
+ * Each block is the sum of the product of a rectangular part of the matrix, by the general matrix * vector kernel,
+ * and of the product of a triangular block on the diagonal, both computed by the sequential kernels run_sequential().
+ * The rows below the diagonal of a lower trapezoidal matrix are left to the general matrix * vector kernel,
+ * which splits them itself. \returns false when the product has not been computed.
+ */
+template<typename Kernel, int Mode, int StorageOrder, typename Index, typename LhsScalar, bool ConjLhs,
+         typename RhsScalar, bool ConjRhs, typename ResScalar, typename AlphaType>
+bool parallelize_trmv(Index rows, Index cols, const LhsScalar* lhs, Index lhsStride,
+                      const RhsScalar* rhs, Index rhsIncr, ResScalar* res, Index resIncr, const AlphaType& alpha)
+{
+#ifdef EIGEN_HAS_OPENMP
+  enum { IsLower = ((Mode&Lower)==Lower) };
+  const Index diagSize = (std::min)(rows,cols);
+  // the i-th row of the upper triangular part has offset + diagSize - i coefficients
+  const Index offset = IsLower ? 0 : cols-diagSize;
+  const double area = double(diagSize) * (double(offset) + 0.5*double(diagSize));
+  Index threads = (std::min)(Index(nbThreads()), Index(area / double(EIGEN_GEMV_PARALLEL_THRESHOLD)));
+  if(threads<=1 || omp_get_num_threads()>1)
+    return false;
+
+  typedef const_blas_data_mapper<LhsScalar,Index,StorageOrder> LhsMapper;
+  typedef const_blas_data_mapper<RhsScalar,Index,RowMajor> RhsMapper;
+  typedef general_matrix_vector_product<Index,LhsScalar,LhsMapper,StorageOrder,ConjLhs,RhsScalar,RhsMapper,ConjRhs,BuiltIn> Gemv;
+  const LhsMapper lhsMapper(lhs, lhsStride);
+
+  Eigen::initParallel();
+  #pragma omp parallel num_threads(threads)
+  {
+    const Index tid = omp_get_thread_num();
+    const Index actual_threads = omp_get_num_threads();
+    const Index r0 = triangular_block_start<Index>(diagSize, offset, IsLower, tid, actual_threads, 4);
+    const Index r1 = triangular_block_start<Index>(diagSize, offset, IsLower, tid+1, actual_threads, 4);
+    if(r1>r0)
+    {
+      if(IsLower && r0>0)
+        Gemv::run_sequential(r1-r0, r0, lhsMapper.getSubMapper(r0,0), RhsMapper(rhs, rhsIncr), res + r0*resIncr, resIncr, alpha);
+      Kernel::run_sequential(r1-r0, IsLower ? r1-r0 : cols-r0, &lhsMapper(r0,r0), lhsStride,
+                             rhs + r0*rhsIncr, rhsIncr, res + r0*resIncr, resIncr, alpha);
+    }
+  }
+  if(IsLower && rows>diagSize)
+    Gemv::run(rows-diagSize, cols, lhsMapper.getSubMapper(diagSize,0), RhsMapper(rhs, rhsIncr),
+              res + diagSize*resIncr, resIncr, alpha);
+  return true;
+#else
+  EIGEN_UNUSED_VARIABLE(rows);
+  EIGEN_UNUSED_VARIABLE(cols);
+  EIGEN_UNUSED_VARIABLE(lhs);
+  EIGEN_UNUSED_VARIABLE(lhsStride);
+  EIGEN_UNUSED_VARIABLE(rhs);
+  EIGEN_UNUSED_VARIABLE(rhsIncr);
+  EIGEN_UNUSED_VARIABLE(res);
+  EIGEN_UNUSED_VARIABLE(resIncr);
+  EIGEN_UNUSED_VARIABLE(alpha);
+  return false;
+#endif
+}
+
 template<typename Index, int Mode, typename LhsScalar, bool ConjLhs, typename RhsScalar, bool ConjRhs, int Version>
 struct triangular_matrix_vector_product<Index,Mode,LhsScalar,ConjLhs,RhsScalar,ConjRhs,ColMajor,Version>
 {
@@ -26,13 +86,21 @@ struct triangular_matrix_vector_product<Index,Mode,LhsScalar,ConjLhs,RhsScalar,C
     HasUnitDiag = (Mode & UnitDiag)==UnitDiag,
     HasZeroDiag = (Mode & ZeroDiag)==ZeroDiag
   };
-  static EIGEN_DONT_INLINE  void run(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
-                                     const RhsScalar* _rhs, Index rhsIncr, ResScalar* _res, Index resIncr, const RhsScalar& alpha);
+  static EIGEN_STRONG_INLINE void run(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
+                                      const RhsScalar* _rhs, Index rhsIncr, ResScalar* _res, Index resIncr, const RhsScalar& alpha)
+  {
+    if(!parallelize_trmv<triangular_matrix_vector_product,Mode,ColMajor,Index,LhsScalar,ConjLhs,RhsScalar,ConjRhs>(
+         _rows, _cols, _lhs, lhsStride, _rhs, rhsIncr, _res, resIncr, alpha))
+      run_sequential(_rows, _cols, _lhs, lhsStride, _rhs, rhsIncr, _res, resIncr, alpha);
+  }
+  // sequential kernel, also called by each thread of parallelize_trmv()
+  static EIGEN_DONT_INLINE void run_sequential(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
+                                              const RhsScalar* _rhs, Index rhsIncr, ResScalar* _res, Index resIncr, const RhsScalar& alpha);
 };
 
 template<typename Index, int Mode, typename LhsScalar, bool ConjLhs, typename RhsScalar, bool ConjRhs, int Version>
 EIGEN_DONT_INLINE void triangular_matrix_vector_product<Index,Mode,LhsScalar,ConjLhs,RhsScalar,ConjRhs,ColMajor,Version>
-  ::run(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
+  ::run_sequential(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
         const RhsScalar* _rhs, Index rhsIncr, ResScalar* _res, Index resIncr, const RhsScalar& alpha)
   {
     static const Index PanelWidth = EIGEN_TUNE_TRIANGULAR_PANEL_WIDTH;
@@ -97,13 +165,21 @@ struct triangular_matrix_vector_product<Index,Mode,LhsScalar,ConjLhs,RhsScalar,C
     HasUnitDiag = (Mode & UnitDiag)==UnitDiag,
     HasZeroDiag = (Mode & ZeroDiag)==ZeroDiag
   };
-  static EIGEN_DONT_INLINE void run(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
-                                    const RhsScalar* _rhs, Index rhsIncr, ResScalar* _res, Index resIncr, const ResScalar& alpha);
+  static EIGEN_STRONG_INLINE void run(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
+                                      const RhsScalar* _rhs, Index rhsIncr, ResScalar* _res, Index resIncr, const ResScalar& alpha)
+  {
+    if(!parallelize_trmv<triangular_matrix_vector_product,Mode,RowMajor,Index,LhsScalar,ConjLhs,RhsScalar,ConjRhs>(
+         _rows, _cols, _lhs, lhsStride, _rhs, rhsIncr, _res, resIncr, alpha))
+      run_sequential(_rows, _cols, _lhs, lhsStride, _rhs, rhsIncr, _res, resIncr, alpha);
+  }
+  // sequential kernel, also called by each thread of parallelize_trmv()
+  static EIGEN_DONT_INLINE void run_sequential(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
+                                              const RhsScalar* _rhs, Index rhsIncr, ResScalar* _res, Index resIncr, const ResScalar& alpha);
 };
 
 template<typename Index, int Mode, typename LhsScalar, bool ConjLhs, typename RhsScalar, bool ConjRhs,int Version>
 EIGEN_DONT_INLINE void triangular_matrix_vector_product<Index,Mode,LhsScalar,ConjLhs,RhsScalar,ConjRhs,RowMajor,Version>
-  ::run(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
+  ::run_sequential(Index _rows, Index _cols, const LhsScalar* _lhs, Index lhsStride,
         const RhsScalar* _rhs, Index rhsIncr, ResScalar* _res, Index resIncr, const ResScalar& alpha)
   {
     static const Index PanelWidth = EIGEN_TUNE_TRIANGULAR_PANEL_WIDTH;
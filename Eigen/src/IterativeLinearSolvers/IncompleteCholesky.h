@@ -158,8 +158,15 @@ class IncompleteCholesky : public SparseSolverBase<IncompleteCholesky<Scalar,_Up
       if (m_perm.rows() == b.rows())  x = m_perm * b;
       else                            x = b;
       x = m_scale.asDiagonal() * x;
-      x = m_L.template triangularView<Lower>().solve(x);
-      x = m_L.adjoint().template triangularView<Upper>().solve(x);
+#ifdef EIGEN_HAS_OPENMP
+      // level scheduled substitutions, when they are worth it
+      if(m_solvePlan.rows()!=m_L.rows() || !m_solvePlan.solveInPlace(m_L, x))
+#endif
+        x = m_L.template triangularView<Lower>().solve(x);
+#ifdef EIGEN_HAS_OPENMP
+      if(m_solvePlan.rows()!=m_L.rows() || !m_solvePlan.adjointSolveInPlace(m_L, x))
+#endif
+        x = m_L.adjoint().template triangularView<Upper>().solve(x);
       x = m_scale.asDiagonal() * x;
       if (m_perm.rows() == b.rows())
         x = m_perm.inverse() * x;
@@ -182,6 +189,7 @@ class IncompleteCholesky : public SparseSolverBase<IncompleteCholesky<Scalar,_Up
     bool m_factorizationIsOk; 
     ComputationInfo m_info;
     PermutationType m_perm; 
+    TriangularSolvePlan<FactorType> m_solvePlan; // The level schedule of L
 
   private:
     inline void updateList(Ref<const VectorIx> colPtr, Ref<VectorIx> rowIdx, Ref<VectorSx> vals, const Index& col, const Index& jk, VectorIx& firstElt, VectorList& listCol); 
@@ -371,6 +379,12 @@ void IncompleteCholesky<Scalar,_UpLo, OrderingType>::factorize(const _MatrixType
     {
       m_factorizationIsOk = true;
       m_info = Success;
+#ifdef EIGEN_HAS_OPENMP
+      if(TriangularSolvePlan<FactorType>::worthAnalyzing(m_L))
+        m_solvePlan.analyzePattern(m_L, Lower);
+      else
+        m_solvePlan = TriangularSolvePlan<FactorType>();
+#endif
     }
   } while(m_info!=Success);
 }
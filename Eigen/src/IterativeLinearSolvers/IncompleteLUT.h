@@ -171,8 +171,15 @@ class IncompleteLUT : public SparseSolverBase<IncompleteLUT<_Scalar, _StorageInd
     void _solve_impl(const Rhs& b, Dest& x) const
     {
       x = m_Pinv * b;
-      x = m_lu.template triangularView<UnitLower>().solve(x);
-      x = m_lu.template triangularView<Upper>().solve(x);
+#ifdef EIGEN_HAS_OPENMP
+      // level scheduled substitutions, when they are worth it
+      if(m_lowerPlan.rows()!=m_lu.rows() || !m_lowerPlan.solveInPlace(m_lu, x))
+#endif
+        x = m_lu.template triangularView<UnitLower>().solve(x);
+#ifdef EIGEN_HAS_OPENMP
+      if(m_upperPlan.rows()!=m_lu.rows() || !m_upperPlan.solveInPlace(m_lu, x))
+#endif
+        x = m_lu.template triangularView<Upper>().solve(x);
       x = m_P * x; 
     }
 
@@ -196,6 +203,8 @@ protected:
     ComputationInfo m_info;
     PermutationMatrix<Dynamic,Dynamic,StorageIndex> m_P;     // Fill-reducing permutation
     PermutationMatrix<Dynamic,Dynamic,StorageIndex> m_Pinv;  // Inverse permutation
+    TriangularSolvePlan<FactorType> m_lowerPlan;             // Level schedules of the L and U factors
+    TriangularSolvePlan<FactorType> m_upperPlan;
 };
 
 /**
@@ -452,6 +461,18 @@ void IncompleteLUT<Scalar,StorageIndex>::factorize(const _MatrixType& amat)
   }
   m_lu.finalize();
   m_lu.makeCompressed();
+#ifdef EIGEN_HAS_OPENMP
+  if(TriangularSolvePlan<FactorType>::worthAnalyzing(m_lu))
+  {
+    m_lowerPlan.analyzePattern(m_lu, UnitLower);
+    m_upperPlan.analyzePattern(m_lu, Upper);
+  }
+  else
+  {
+    m_lowerPlan = TriangularSolvePlan<FactorType>();
+    m_upperPlan = TriangularSolvePlan<FactorType>();
+  }
+#endif
 
   m_factorizationIsOk = true;
   m_info = Success;
@@ -0,0 +1,450 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SMOOTHED_AGGREGATION_PRECONDITIONER_H
+#define EIGEN_SMOOTHED_AGGREGATION_PRECONDITIONER_H
+
+#include <vector>
+
+namespace Eigen {
+
+/** \ingroup IterativeLinearSolvers_Module
+  * \brief Smoothed aggregation algebraic multigrid preconditioner
+  *
+  * References : P. Vaněk, J. Mandel and M. Brezina, Algebraic Multigrid by Smoothed Aggregation for Second and
+  *              Fourth Order Elliptic Problems, Computing 56(3), pp. 179-196, 1996
+  *
+  * \tparam _Scalar the scalar type of the input matrices
+  * \tparam _UpLo the triangular part of the input matrices which is referenced: Lower, Upper, or Lower|Upper
+  *               when the full matrix is stored. Default is Lower, as for ConjugateGradient.
+  * \tparam _StorageIndex the type of the indices of the operators of the hierarchy. Default is int.
+  *
+  * \implsparsesolverconcept
+  *
+  * This preconditioner is meant for selfadjoint positive definite matrices arising from elliptic problems, such as
+  * the discretizations of the Poisson equation, for which the number of iterations of ConjugateGradient then barely
+  * grows with the size of the mesh. It applies one V-cycle on the hierarchy of operators \f$ A_{l+1} = P_l^* A_l P_l \f$
+  * built by factorize():
+  *  - the unknowns of \f$ A_l \f$ are grouped into aggregates of strongly connected unknowns, the unknowns \a i and
+  *    \a j being strongly connected when \f$ |a_{ij}| \geq \theta \sqrt{|a_{ii} a_{jj}|} \f$ (see setStrengthThreshold()),
+  *  - the tentative prolongator interpolates the constant vector on each aggregate,
+  *  - the prolongator \f$ P_l \f$ is the tentative prolongator smoothed by one step of damped Jacobi.
+  *
+  * The coarsening stops when the size of the operator is at most setCoarseSize() or when setMaxLevels() levels are
+  * built. The coarsest operator is then solved by a dense LDLT factorization if it is small enough, and smoothed
+  * otherwise. The smoother is either a damped Jacobi iteration, which runs in parallel when OpenMP is enabled, or a
+  * Gauss-Seidel iteration, the default, which is sequential. In both cases the V-cycle is symmetric, such that the
+  * preconditioner can be used with ConjugateGradient:
+  * \code
+  * ConjugateGradient<SparseMatrix<double>, Lower|Upper, SmoothedAggregationPreconditioner<double,Lower|Upper> > cg;
+  * cg.compute(A);
+  * x = cg.solve(b);
+  * \endcode
+  *
+  * Since the aggregates depend on the values of the matrix, analyzePattern() does nothing and the whole hierarchy is
+  * built by factorize().
+  *
+  * \sa class ConjugateGradient, class IncompleteCholesky
+  */
+template <typename _Scalar, int _UpLo = Lower, typename _StorageIndex = int>
+class SmoothedAggregationPreconditioner
+  : public SparseSolverBase<SmoothedAggregationPreconditioner<_Scalar,_UpLo,_StorageIndex> >
+{
+  protected:
+    typedef SparseSolverBase<SmoothedAggregationPreconditioner> Base;
+    using Base::m_isInitialized;
+  public:
+    typedef _Scalar Scalar;
+    typedef _StorageIndex StorageIndex;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef Matrix<Scalar,Dynamic,1> Vector;
+    typedef Matrix<StorageIndex,Dynamic,1> VectorI;
+    typedef SparseMatrix<Scalar,RowMajor,StorageIndex> OperatorType;
+    enum { UpLo = _UpLo };
+    enum {
+      ColsAtCompileTime = Dynamic,
+      MaxColsAtCompileTime = Dynamic
+    };
+
+    /** The smoothers applied on each level of the V-cycle */
+    enum SmootherType {
+      JacobiSmoother,      /**< damped Jacobi, with the weight \f$ 4/(3\rho(D^{-1}A)) \f$ */
+      GaussSeidelSmoother  /**< forward Gauss-Seidel before the coarse correction, backward after */
+    };
+
+    SmoothedAggregationPreconditioner()
+      : m_size(0), m_threshold(0.08), m_coarseSize(300), m_maxLevels(10), m_sweeps(1), m_smoother(GaussSeidelSmoother),
+        m_directCoarseSolve(false), m_info(Success)
+    {}
+
+    template<typename MatrixType>
+    explicit SmoothedAggregationPreconditioner(const MatrixType& mat)
+      : m_size(0), m_threshold(0.08), m_coarseSize(300), m_maxLevels(10), m_sweeps(1), m_smoother(GaussSeidelSmoother),
+        m_directCoarseSolve(false), m_info(Success)
+    {
+      compute(mat);
+    }
+
+    Index rows() const { return m_size; }
+
+    Index cols() const { return rows(); }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was successful,
+      *          \c NumericalIssue if a diagonal coefficient of an operator of the hierarchy is zero,
+      *          or if the coarsest operator cannot be factorized.
+      *
+      * In the former case, the hierarchy stops at the last operator with a nonzero diagonal, and the
+      * preconditioner is the identity if this is the input matrix.
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "SmoothedAggregationPreconditioner is not initialized.");
+      return m_info;
+    }
+
+    /** Does nothing: the hierarchy depends on the values of the matrix and is built by factorize() */
+    template<typename MatrixType>
+    SmoothedAggregationPreconditioner& analyzePattern(const MatrixType&)
+    {
+      m_isInitialized = true;
+      m_info = Success;
+      return *this;
+    }
+
+    /** Builds the hierarchy of coarse operators of \a mat */
+    template<typename MatrixType>
+    SmoothedAggregationPreconditioner& factorize(const MatrixType& mat);
+
+    template<typename MatrixType>
+    SmoothedAggregationPreconditioner& compute(const MatrixType& mat)
+    {
+      analyzePattern(mat);
+      return factorize(mat);
+    }
+
+    /** Sets the threshold \f$ \theta \f$ of the strong connections. Default is 0.08. */
+    void setStrengthThreshold(const RealScalar& threshold) { m_threshold = threshold; }
+
+    /** Sets the size below which the operators are no longer coarsened, and factorized by a dense LDLT.
+      * Default is 300. */
+    void setCoarseSize(Index size) { m_coarseSize = size; }
+
+    /** Sets the maximal number of levels of the hierarchy, including the finest one. Default is 10. */
+    void setMaxLevels(Index levels) { eigen_assert(levels>0); m_maxLevels = levels; }
+
+    /** Sets the smoother. Default is GaussSeidelSmoother. */
+    void setSmoother(SmootherType smoother) { m_smoother = smoother; }
+
+    /** Sets the number of smoothing sweeps before and after the coarse correction. Default is 1. */
+    void setSmootherSweeps(Index sweeps) { m_sweeps = sweeps; }
+
+    /** \returns the number of levels of the hierarchy, including the finest one */
+    Index levels() const { return Index(m_A.size()); }
+
+    /** \returns the operator of the \a level -th level of the hierarchy, level 0 being the input matrix */
+    const OperatorType& levelMatrix(Index level) const { return m_A[level]; }
+
+    /** \returns the number of nonzeros of all the operators of the hierarchy, relative to the one of the input matrix */
+    RealScalar operatorComplexity() const
+    {
+      Index nnz = 0;
+      for(std::size_t l = 0; l < m_A.size(); ++l)
+        nnz += m_A[l].nonZeros();
+      return m_A.empty() ? RealScalar(0) : RealScalar(nnz) / RealScalar((std::max)(m_A.front().nonZeros(), Index(1)));
+    }
+
+    template<typename Rhs, typename Dest>
+    void _solve_impl(const Rhs& b, Dest& x) const
+    {
+      if(m_A.empty())
+      {
+        x = b;
+        return;
+      }
+      Vector rhs, sol;
+      for(Index j = 0; j < b.cols(); ++j)
+      {
+        rhs = b.col(j);
+        cycle(0, rhs, sol);
+        x.col(j) = sol;
+      }
+    }
+
+  protected:
+    Index aggregate(const OperatorType& A, VectorI& agg) const;
+    RealScalar spectralRadius(const OperatorType& A, const Vector& invDiag) const;
+    void smooth(Index level, const Vector& b, Vector& x, bool forward) const;
+    void cycle(Index level, const Vector& b, Vector& x) const;
+
+    std::vector<OperatorType> m_A;           // The operators of the hierarchy, the finest first
+    std::vector<OperatorType> m_P, m_R;      // The prolongators, and the restrictions P^*
+    std::vector<Vector> m_invDiag;           // The inverse of the diagonal of each operator
+    std::vector<RealScalar> m_jacobiWeight;  // The damping of the Jacobi iterations on each level
+    LDLT<Matrix<Scalar,Dynamic,Dynamic> > m_coarseSolver;
+    Index m_size;
+    RealScalar m_threshold;
+    Index m_coarseSize;
+    Index m_maxLevels;
+    Index m_sweeps;
+    SmootherType m_smoother;
+    bool m_directCoarseSolve;
+    ComputationInfo m_info;
+};
+
+template<typename Scalar, int _UpLo, typename StorageIndex>
+template<typename MatrixType>
+SmoothedAggregationPreconditioner<Scalar,_UpLo,StorageIndex>&
+SmoothedAggregationPreconditioner<Scalar,_UpLo,StorageIndex>::factorize(const MatrixType& mat)
+{
+  eigen_assert(mat.rows()==mat.cols() && "SmoothedAggregationPreconditioner requires a square matrix");
+  m_A.clear(); m_P.clear(); m_R.clear(); m_invDiag.clear(); m_jacobiWeight.clear();
+  m_directCoarseSolve = false;
+  m_size = mat.rows();
+  m_isInitialized = true;
+  m_info = Success;
+
+  m_A.resize(1);
+  if(UpLo==(Lower|Upper))
+    m_A[0] = mat;
+  else
+    m_A[0] = mat.template selfadjointView<UpLo>();
+  m_A[0].makeCompressed();
+
+  for(Index l = 0; ; ++l)
+  {
+    const Index n = m_A[l].rows();
+    Vector diag = m_A[l].diagonal();
+    if((diag.array()==Scalar(0)).any())
+    {
+      // keep the levels built so far, the preconditioner being the identity if there is none
+      m_info = NumericalIssue;
+      m_A.resize(l);
+      m_P.resize(l>0 ? l-1 : 0);
+      m_R.resize(l>0 ? l-1 : 0);
+      return *this;
+    }
+    m_invDiag.push_back(diag.cwiseInverse());
+    m_jacobiWeight.push_back(RealScalar(4) / (RealScalar(3) * spectralRadius(m_A[l], m_invDiag[l])));
+    if(n<=m_coarseSize || l+1>=m_maxLevels)
+      break;
+
+    VectorI agg;
+    const Index nc = aggregate(m_A[l], agg);
+    if(nc==0)
+      break;
+
+    // tentative prolongator, with orthonormal columns
+    VectorI aggSize = VectorI::Zero(nc);
+    for(Index i = 0; i < n; ++i)
+      if(agg(i)>=0)
+        ++aggSize(agg(i));
+    OperatorType T(n, nc);
+    T.reserve(VectorI::Ones(n));
+    for(Index i = 0; i < n; ++i)
+      if(agg(i)>=0)
+        T.insert(i, agg(i)) = Scalar(RealScalar(1) / numext::sqrt(RealScalar(aggSize(agg(i)))));
+    T.makeCompressed();
+
+    // P = (I - w D^-1 A) T
+    Vector weights = m_jacobiWeight[l] * m_invDiag[l];
+    OperatorType AT = m_A[l] * T;
+    OperatorType P = T - weights.asDiagonal() * AT;
+    m_R.push_back(P.adjoint());
+    m_P.push_back(P);
+
+    // Galerkin coarse operator
+    OperatorType AP = m_A[l] * m_P[l];
+    OperatorType Ac = m_R[l] * AP;
+    Ac.makeCompressed();
+    m_A.push_back(Ac);
+  }
+
+  m_directCoarseSolve = m_A.back().rows()<=m_coarseSize;
+  if(m_directCoarseSolve)
+  {
+    m_coarseSolver.compute(Matrix<Scalar,Dynamic,Dynamic>(m_A.back()));
+    if(m_coarseSolver.info()!=Success)
+      m_info = NumericalIssue;
+  }
+  return *this;
+}
+
+/** \internal Groups the unknowns of \a A into aggregates of strongly connected unknowns, the unknowns without strong
+  * connections being left out with agg(i) == -1. \returns the number of aggregates. */
+template<typename Scalar, int _UpLo, typename StorageIndex>
+Index SmoothedAggregationPreconditioner<Scalar,_UpLo,StorageIndex>::aggregate(const OperatorType& A, VectorI& agg) const
+{
+  using std::sqrt;
+  const Index n = A.rows();
+  const StorageIndex* outerIndex = A.outerIndexPtr();
+  const StorageIndex* innerIndex = A.innerIndexPtr();
+  const Scalar* values = A.valuePtr();
+  Matrix<RealScalar,Dynamic,1> absDiag = A.diagonal().cwiseAbs();
+
+  // the strong connections, as positions in the arrays of A
+  VectorI strongStart(n+1);
+  std::vector<StorageIndex> strong;
+  strong.reserve(A.nonZeros());
+  strongStart(0) = 0;
+  for(Index i = 0; i < n; ++i)
+  {
+    for(StorageIndex p = outerIndex[i]; p < outerIndex[i+1]; ++p)
+    {
+      const Index j = innerIndex[p];
+      if(j!=i && numext::abs(values[p]) >= m_threshold * sqrt(absDiag(i) * absDiag(j)))
+        strong.push_back(p);
+    }
+    strongStart(i+1) = StorageIndex(strong.size());
+  }
+
+  // the unknowns without strong connections are not aggregated: the smoother takes care of them
+  const StorageIndex Free = -1, Isolated = -2;
+  agg.setConstant(n, Free);
+  for(Index i = 0; i < n; ++i)
+    if(strongStart(i)==strongStart(i+1))
+      agg(i) = Isolated;
+
+  // 1. the unknowns whose neighborhood is free form an aggregate with it
+  StorageIndex nc = 0;
+  for(Index i = 0; i < n; ++i)
+  {
+    if(agg(i)!=Free)
+      continue;
+    bool freeNeighborhood = true;
+    for(StorageIndex k = strongStart(i); k < strongStart(i+1) && freeNeighborhood; ++k)
+      freeNeighborhood = agg(innerIndex[strong[k]])==Free;
+    if(!freeNeighborhood)
+      continue;
+    agg(i) = nc;
+    for(StorageIndex k = strongStart(i); k < strongStart(i+1); ++k)
+      agg(innerIndex[strong[k]]) = nc;
+    ++nc;
+  }
+
+  // 2. the remaining unknowns join the aggregate of their strongest aggregated neighbor
+  VectorI agg1 = agg;
+  for(Index i = 0; i < n; ++i)
+  {
+    if(agg(i)!=Free)
+      continue;
+    RealScalar best(-1);
+    for(StorageIndex k = strongStart(i); k < strongStart(i+1); ++k)
+    {
+      const StorageIndex p = strong[k];
+      if(agg1(innerIndex[p])>=0 && numext::abs(values[p])>best)
+      {
+        best = numext::abs(values[p]);
+        agg(i) = agg1(innerIndex[p]);
+      }
+    }
+  }
+
+  // 3. the unknowns left, if any, form new aggregates with their free neighbors
+  for(Index i = 0; i < n; ++i)
+  {
+    if(agg(i)!=Free)
+      continue;
+    agg(i) = nc;
+    for(StorageIndex k = strongStart(i); k < strongStart(i+1); ++k)
+      if(agg(innerIndex[strong[k]])==Free)
+        agg(innerIndex[strong[k]]) = nc;
+    ++nc;
+  }
+
+  for(Index i = 0; i < n; ++i)
+    if(agg(i)==Isolated)
+      agg(i) = Free;
+  return nc;
+}
+
+/** \internal \returns an estimate of the spectral radius of \f$ D^{-1} A \f$, D being the diagonal of \a A,
+  * computed by a few power iterations and bounded by the Gershgorin circles. */
+template<typename Scalar, int _UpLo, typename StorageIndex>
+typename SmoothedAggregationPreconditioner<Scalar,_UpLo,StorageIndex>::RealScalar
+SmoothedAggregationPreconditioner<Scalar,_UpLo,StorageIndex>::spectralRadius(const OperatorType& A, const Vector& invDiag) const
+{
+  const Index n = A.rows();
+  RealScalar gershgorin(0);
+  for(Index i = 0; i < n; ++i)
+  {
+    RealScalar sum(0);
+    for(typename OperatorType::InnerIterator it(A,i); it; ++it)
+      sum += numext::abs(it.value());
+    gershgorin = (std::max)(gershgorin, sum * numext::abs(invDiag(i)));
+  }
+
+  // the Rayleigh quotients of D^-1/2 A D^-1/2 are lower bounds of the spectral radius
+  Vector x(n), Ax;
+  for(Index i = 0; i < n; ++i)
+    x(i) = Scalar(RealScalar((i * 7919) % 1009) / RealScalar(1009) - RealScalar(0.5));
+  RealScalar rho(0);
+  for(int k = 0; k < 15; ++k)
+  {
+    Ax = A * x;
+    const RealScalar xDx = numext::real(x.dot(x.cwiseQuotient(invDiag)));
+    if(!(xDx>RealScalar(0)))
+      break;
+    rho = (std::max)(rho, numext::real(x.dot(Ax)) / xDx);
+    x = invDiag.cwiseProduct(Ax);
+    x /= x.norm();
+  }
+  return rho>RealScalar(0) ? (std::min)(rho, gershgorin) : gershgorin;
+}
+
+template<typename Scalar, int _UpLo, typename StorageIndex>
+void SmoothedAggregationPreconditioner<Scalar,_UpLo,StorageIndex>::smooth(Index level, const Vector& b, Vector& x, bool forward) const
+{
+  const OperatorType& A = m_A[level];
+  const Vector& invDiag = m_invDiag[level];
+  const Index n = A.rows();
+  for(Index s = 0; s < m_sweeps; ++s)
+  {
+    if(m_smoother==JacobiSmoother)
+    {
+      x += m_jacobiWeight[level] * invDiag.cwiseProduct(b - A * x);
+    }
+    else
+    {
+      for(Index k = 0; k < n; ++k)
+      {
+        const Index i = forward ? k : n-1-k;
+        Scalar tmp = b(i);
+        for(typename OperatorType::InnerIterator it(A,i); it; ++it)
+          if(it.index()!=i)
+            tmp -= it.value() * x(it.index());
+        x(i) = tmp * invDiag(i);
+      }
+    }
+  }
+}
+
+template<typename Scalar, int _UpLo, typename StorageIndex>
+void SmoothedAggregationPreconditioner<Scalar,_UpLo,StorageIndex>::cycle(Index level, const Vector& b, Vector& x) const
+{
+  const bool coarsest = level+1==levels();
+  if(coarsest && m_directCoarseSolve)
+  {
+    x = m_coarseSolver.solve(b);
+    return;
+  }
+  x.setZero(b.size());
+  smooth(level, b, x, true);
+  if(!coarsest)
+  {
+    Vector bc = m_R[level] * (b - m_A[level] * x);
+    Vector xc;
+    cycle(level+1, bc, xc);
+    x += m_P[level] * xc;
+  }
+  smooth(level, b, x, false);
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_SMOOTHED_AGGREGATION_PRECONDITIONER_H
@@ -445,6 +445,13 @@ struct partial_lu_impl
       blockSize = (std::min)((std::max)(blockSize,Index(8)), maxBlockSize);
     }
 
+#ifdef EIGEN_HAS_OPENMP
+    // large top-level factorizations are shared among the OpenMP threads,
+    // unless we already are in a parallel session
+    if(maxBlockSize>16 && size>=512 && nbThreads()>1 && omp_get_num_threads()==1)
+      return parallel_blocked_lu(lu, luStride, row_transpositions, nb_transpositions, blockSize);
+#endif
+
     nb_transpositions = 0;
     Index first_zero_pivot = -1;
     for(Index k = 0; k < size; k+=blockSize)
@@ -494,6 +501,112 @@ struct partial_lu_impl
     }
     return first_zero_pivot;
   }
+
+#ifdef EIGEN_HAS_OPENMP
+  /** \internal factorizes in-place the panel made of the columns [k,k+bs) of \a lu below the row k,
+    * and offsets the resulting transpositions by k.
+    *
+    * \returns The index of the first pivot of the panel which is exactly zero if any, or a negative number otherwise.
+    */
+  static Index factor_panel(MatrixType& lu, Index luStride, Index k, Index bs, PivIndex* row_transpositions, PivIndex& nb_transpositions)
+  {
+    PivIndex nb_transpositions_in_panel;
+    Index ret = blocked_lu(lu.rows()-k, bs, &lu.coeffRef(k,k), luStride,
+                           row_transpositions+k, nb_transpositions_in_panel, 16);
+    nb_transpositions += nb_transpositions_in_panel;
+    for(Index i=k; i<k+bs; ++i)
+      row_transpositions[i] += internal::convert_index<PivIndex>(k);
+    return ret>=0 ? k+ret : -1;
+  }
+
+  /** \internal applies the row transpositions of the panel [k,k+bs) to the columns [c0,c0+n) of \a lu.
+    * If these columns are on the right of the panel, they are also updated by the panel:
+    * A12 = A11^-1 A12 and A22 -= A21 * A12.
+    */
+  static void update_columns(MatrixType& lu, Index k, Index bs, Index c0, Index n, const PivIndex* row_transpositions)
+  {
+    if(n<=0)
+      return;
+    BlockType A(lu,0,c0,lu.rows(),n);
+    for(Index i=k; i<k+bs; ++i)
+      A.row(i).swap(A.row(row_transpositions[i]));
+
+    Index trows = lu.rows() - k - bs;
+    if(c0>k && trows)
+    {
+      BlockType A11(lu,k,k,bs,bs);
+      BlockType A12(lu,k,c0,bs,n);
+      BlockType A21(lu,k+bs,k,trows,bs);
+      BlockType A22(lu,k+bs,c0,trows,n);
+      A11.template triangularView<UnitLower>().solveInPlace(A12);
+      A22.noalias() -= A21 * A12;
+    }
+  }
+
+  /** \internal multi-threaded version of blocked_lu with a lookahead of one panel.
+    *
+    * At each step, the first thread updates the columns of the next panel and factorizes it,
+    * while the other threads apply the row transpositions and the trailing update of the current panel
+    * to their own slices of the remaining columns. The factorization of the panels, which is
+    * sequential and memory bound, is thus overlapped with the trailing updates. The computed
+    * pivots are the same as those of blocked_lu.
+    */
+  static Index parallel_blocked_lu(MatrixType& lu, Index luStride, PivIndex* row_transpositions, PivIndex& nb_transpositions, Index blockSize)
+  {
+    const Index rows = lu.rows();
+    const Index cols = lu.cols();
+    const Index size = (std::min)(rows,cols);
+    const Index threads = nbThreads();
+
+    Eigen::initParallel();
+
+    nb_transpositions = 0;
+    Index first_zero_pivot = factor_panel(lu, luStride, 0, (std::min)(size,blockSize), row_transpositions, nb_transpositions);
+    for(Index k = 0; k < size; k+=blockSize)
+    {
+      Index bs = (std::min)(size-k,blockSize);          // actual size of the current panel
+      Index next = k + bs;
+      Index nbs = (std::min)(size-next,blockSize);      // actual size of the next panel, if any
+      Index rest = next + nbs;
+      Index next_zero_pivot = -1;
+      PivIndex nb_transpositions_in_next = 0;
+
+      #pragma omp parallel num_threads(threads)
+      {
+        // Note that the actual number of threads might be lower than the number of request ones.
+        Index actual_threads = omp_get_num_threads();
+        Index i = omp_get_thread_num();
+
+        if(nbs>0 && i==0)
+        {
+          update_columns(lu, k, bs, next, nbs, row_transpositions);
+          next_zero_pivot = factor_panel(lu, luStride, next, nbs, row_transpositions, nb_transpositions_in_next);
+        }
+
+        bool lookahead = nbs>0 && actual_threads>1;
+        Index workers = lookahead ? actual_threads-1 : actual_threads;
+        Index w = lookahead ? i-1 : i;
+        if(w>=0)
+        {
+          // trailing columns on the right of the next panel
+          Index c0 = rest + ((cols-rest)*w)/workers;
+          Index c1 = rest + ((cols-rest)*(w+1))/workers;
+          update_columns(lu, k, bs, c0, c1-c0, row_transpositions);
+
+          // row interchanges in the columns on the left of the current panel
+          Index l0 = (k*w)/workers;
+          Index l1 = (k*(w+1))/workers;
+          update_columns(lu, k, bs, l0, l1-l0, row_transpositions);
+        }
+      }
+
+      nb_transpositions += nb_transpositions_in_next;
+      if(first_zero_pivot==-1)
+        first_zero_pivot = next_zero_pivot;
+    }
+    return first_zero_pivot;
+  }
+#endif
 };
 
 /** \internal performs the LU decomposition with partial pivoting in-place.
@@ -0,0 +1,772 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GRAPH_ORDERING_H
+#define EIGEN_GRAPH_ORDERING_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * \ingroup OrderingMethods_Module
+  * Undirected graph stored as compressed adjacency lists without self loops: the neighbors of the vertex v
+  * are adj[xadj[v]] ... adj[xadj[v+1]-1]. The vertex and edge weights are only used by the multilevel partitioner.
+  */
+template<typename StorageIndex>
+struct ordering_graph
+{
+  typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+
+  IndexVector xadj, adj, vwgt, ewgt;
+
+  Index size() const { return xadj.size()-1; }
+  Index degree(Index v) const { return xadj.coeff(v+1) - xadj.coeff(v); }
+};
+
+/** \internal Builds the graph of the symmetric pattern \f$ A + A^T \f$ of the square column-major matrix \a mat */
+template<typename MatrixType, typename StorageIndex>
+void ordering_graph_from_pattern(const MatrixType& mat, ordering_graph<StorageIndex>& g)
+{
+  typedef typename ordering_graph<StorageIndex>::IndexVector IndexVector;
+  eigen_assert(mat.rows()==mat.cols() && "graph orderings require a square matrix");
+  const Index n = mat.cols();
+  IndexVector count = IndexVector::Zero(n+1);
+  for(Index j = 0; j < n; ++j)
+    for(typename MatrixType::InnerIterator it(mat, j); it; ++it)
+      if(it.index()!=j)
+      {
+        ++count.coeffRef(it.index());
+        ++count.coeffRef(j);
+      }
+
+  // every edge is stored twice at this stage, duplicates are removed below
+  IndexVector start(n+1);
+  start.coeffRef(0) = 0;
+  for(Index v = 0; v < n; ++v)
+    start.coeffRef(v+1) = start.coeff(v) + count.coeff(v);
+  IndexVector adj(start.coeff(n));
+  IndexVector pos = start.head(n);
+  for(Index j = 0; j < n; ++j)
+    for(typename MatrixType::InnerIterator it(mat, j); it; ++it)
+      if(it.index()!=j)
+      {
+        adj.coeffRef(pos.coeffRef(it.index())++) = StorageIndex(j);
+        adj.coeffRef(pos.coeffRef(j)++) = StorageIndex(it.index());
+      }
+
+  g.xadj.resize(n+1);
+  g.xadj.coeffRef(0) = 0;
+  StorageIndex nnz = 0;
+  for(Index v = 0; v < n; ++v)
+  {
+    StorageIndex* first = adj.data() + start.coeff(v);
+    StorageIndex* last = adj.data() + start.coeff(v+1);
+    std::sort(first, last);
+    last = std::unique(first, last);
+    for(StorageIndex* p = first; p != last; ++p)
+      adj.coeffRef(nnz++) = *p;
+    g.xadj.coeffRef(v+1) = nnz;
+  }
+  g.adj = adj.head(nnz);
+  g.vwgt.setOnes(n);
+  g.ewgt.setOnes(nnz);
+}
+
+/** \internal Builds the subgraph of \a g induced by the vertices \a vertices[0] ... \a vertices[n-1].
+  * \a local is a workspace of size g.size() filled with -1, which is restored on exit. */
+template<typename StorageIndex>
+void ordering_subgraph(const ordering_graph<StorageIndex>& g, const StorageIndex* vertices, Index n,
+                       Matrix<StorageIndex,Dynamic,1>& local, ordering_graph<StorageIndex>& sub)
+{
+  for(Index k = 0; k < n; ++k)
+    local.coeffRef(vertices[k]) = StorageIndex(k);
+  Index nnz = 0;
+  for(Index k = 0; k < n; ++k)
+    for(StorageIndex p = g.xadj.coeff(vertices[k]); p < g.xadj.coeff(vertices[k]+1); ++p)
+      if(local.coeff(g.adj.coeff(p))>=0)
+        ++nnz;
+  sub.xadj.resize(n+1);
+  sub.adj.resize(nnz);
+  sub.xadj.coeffRef(0) = 0;
+  nnz = 0;
+  for(Index k = 0; k < n; ++k)
+  {
+    for(StorageIndex p = g.xadj.coeff(vertices[k]); p < g.xadj.coeff(vertices[k]+1); ++p)
+      if(local.coeff(g.adj.coeff(p))>=0)
+        sub.adj.coeffRef(nnz++) = local.coeff(g.adj.coeff(p));
+    sub.xadj.coeffRef(k+1) = StorageIndex(nnz);
+  }
+  sub.vwgt.setOnes(n);
+  sub.ewgt.setOnes(nnz);
+  for(Index k = 0; k < n; ++k)
+    local.coeffRef(vertices[k]) = -1;
+}
+
+/** \internal Breadth first search from \a root over the vertices with a negative \a level.
+  * The visited vertices are appended to \a queue and their level is set.
+  * \returns the eccentricity of \a root, i.e., the level of the last visited vertex */
+template<typename StorageIndex>
+Index ordering_bfs(const ordering_graph<StorageIndex>& g, StorageIndex root,
+                   Matrix<StorageIndex,Dynamic,1>& level, std::vector<StorageIndex>& queue)
+{
+  std::size_t head = queue.size();
+  queue.push_back(root);
+  level.coeffRef(root) = 0;
+  Index ecc = 0;
+  for(; head < queue.size(); ++head)
+  {
+    StorageIndex v = queue[head];
+    ecc = level.coeff(v);
+    for(StorageIndex p = g.xadj.coeff(v); p < g.xadj.coeff(v+1); ++p)
+    {
+      StorageIndex u = g.adj.coeff(p);
+      if(level.coeff(u)<0)
+      {
+        level.coeffRef(u) = StorageIndex(ecc+1);
+        queue.push_back(u);
+      }
+    }
+  }
+  return ecc;
+}
+
+/** \internal \returns a pseudo-peripheral vertex of the connected component of \a start, following George and Liu.
+  * \a level is a workspace filled with -1, which is restored on exit. */
+template<typename StorageIndex>
+StorageIndex ordering_pseudo_peripheral_vertex(const ordering_graph<StorageIndex>& g, StorageIndex start,
+                                               Matrix<StorageIndex,Dynamic,1>& level, std::vector<StorageIndex>& queue)
+{
+  StorageIndex root = start;
+  queue.clear();
+  Index ecc = ordering_bfs(g, root, level, queue);
+  for(;;)
+  {
+    // the candidate is a vertex of minimal degree in the last level
+    StorageIndex candidate = root;
+    for(std::size_t k = 0; k < queue.size(); ++k)
+      if(level.coeff(queue[k])==ecc && (candidate==root || g.degree(queue[k]) < g.degree(candidate)))
+        candidate = queue[k];
+    for(std::size_t k = 0; k < queue.size(); ++k)
+      level.coeffRef(queue[k]) = -1;
+    if(candidate==root)
+      return root;
+    queue.clear();
+    Index candidateEcc = ordering_bfs(g, candidate, level, queue);
+    if(candidateEcc <= ecc)
+    {
+      for(std::size_t k = 0; k < queue.size(); ++k)
+        level.coeffRef(queue[k]) = -1;
+      return root;
+    }
+    root = candidate;
+    ecc = candidateEcc;
+  }
+}
+
+/** \internal Computes the reverse Cuthill-McKee ordering of \a g: \a order[k] is the vertex placed at position k */
+template<typename StorageIndex>
+void ordering_rcm(const ordering_graph<StorageIndex>& g, StorageIndex* order)
+{
+  typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+  const Index n = g.size();
+  IndexVector level = IndexVector::Constant(n, -1);
+  Matrix<bool,Dynamic,1> visited = Matrix<bool,Dynamic,1>::Constant(n, false);
+  std::vector<StorageIndex> queue;
+  std::vector<std::pair<StorageIndex,StorageIndex> > neighbors;
+  Index count = 0;
+  for(Index v = 0; v < n; ++v)
+  {
+    if(visited.coeff(v))
+      continue;
+    // Cuthill-McKee ordering of the connected component of v, visiting the neighbors by increasing degree
+    StorageIndex root = ordering_pseudo_peripheral_vertex(g, StorageIndex(v), level, queue);
+    Index head = count;
+    order[count++] = root;
+    visited.coeffRef(root) = true;
+    for(; head < count; ++head)
+    {
+      StorageIndex u = order[head];
+      neighbors.clear();
+      for(StorageIndex p = g.xadj.coeff(u); p < g.xadj.coeff(u+1); ++p)
+      {
+        StorageIndex w = g.adj.coeff(p);
+        if(!visited.coeff(w))
+        {
+          visited.coeffRef(w) = true;
+          neighbors.push_back(std::make_pair(StorageIndex(g.degree(w)), w));
+        }
+      }
+      std::sort(neighbors.begin(), neighbors.end());
+      for(std::size_t k = 0; k < neighbors.size(); ++k)
+        order[count++] = neighbors[k].second;
+    }
+  }
+  std::reverse(order, order+n);
+}
+
+/** \internal Heavy edge matching of \a g: builds the coarse graph \a coarse, \a cmap mapping the vertices of \a g
+  * to the ones of \a coarse. */
+template<typename StorageIndex>
+void ordering_coarsen(const ordering_graph<StorageIndex>& g, ordering_graph<StorageIndex>& coarse,
+                      Matrix<StorageIndex,Dynamic,1>& cmap)
+{
+  typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+  const Index n = g.size();
+
+  // visit the vertices by increasing degree, such that the vertices of low degree get matched first
+  std::vector<std::pair<StorageIndex,StorageIndex> > visit(n);
+  for(Index v = 0; v < n; ++v)
+    visit[v] = std::make_pair(StorageIndex(g.degree(v)), StorageIndex(v));
+  std::sort(visit.begin(), visit.end());
+
+  IndexVector match = IndexVector::Constant(n, -1);
+  for(Index k = 0; k < n; ++k)
+  {
+    StorageIndex v = visit[k].second;
+    if(match.coeff(v)>=0)
+      continue;
+    StorageIndex best = v, bestWeight = -1;
+    for(StorageIndex p = g.xadj.coeff(v); p < g.xadj.coeff(v+1); ++p)
+    {
+      StorageIndex u = g.adj.coeff(p);
+      if(match.coeff(u)<0 && g.ewgt.coeff(p) > bestWeight)
+      {
+        best = u;
+        bestWeight = g.ewgt.coeff(p);
+      }
+    }
+    match.coeffRef(v) = best;
+    match.coeffRef(best) = v;
+  }
+
+  cmap.setConstant(n, -1);
+  IndexVector rep(n);
+  Index nc = 0;
+  for(Index v = 0; v < n; ++v)
+    if(cmap.coeff(v)<0)
+    {
+      cmap.coeffRef(v) = cmap.coeffRef(match.coeff(v)) = StorageIndex(nc);
+      rep.coeffRef(nc++) = StorageIndex(v);
+    }
+
+  // merge the adjacency lists of the matched vertices, accumulating the weights of the parallel edges
+  IndexVector where = IndexVector::Constant(nc, -1);
+  std::vector<StorageIndex> adj, ewgt;
+  adj.reserve(g.adj.size());
+  ewgt.reserve(g.adj.size());
+  coarse.xadj.resize(nc+1);
+  coarse.vwgt.resize(nc);
+  coarse.xadj.coeffRef(0) = 0;
+  for(Index c = 0; c < nc; ++c)
+  {
+    StorageIndex v = rep.coeff(c), w = match.coeff(v);
+    coarse.vwgt.coeffRef(c) = g.vwgt.coeff(v) + (w!=v ? g.vwgt.coeff(w) : 0);
+    std::size_t first = adj.size();
+    for(int k = 0; k < (w!=v ? 2 : 1); ++k)
+    {
+      StorageIndex f = k==0 ? v : w;
+      for(StorageIndex p = g.xadj.coeff(f); p < g.xadj.coeff(f+1); ++p)
+      {
+        StorageIndex cu = cmap.coeff(g.adj.coeff(p));
+        if(cu==c)
+          continue;
+        if(where.coeff(cu)<0)
+        {
+          where.coeffRef(cu) = StorageIndex(adj.size());
+          adj.push_back(cu);
+          ewgt.push_back(g.ewgt.coeff(p));
+        }
+        else
+          ewgt[where.coeff(cu)] += g.ewgt.coeff(p);
+      }
+    }
+    for(std::size_t p = first; p < adj.size(); ++p)
+      where.coeffRef(adj[p]) = -1;
+    coarse.xadj.coeffRef(c+1) = StorageIndex(adj.size());
+  }
+  coarse.adj = Map<IndexVector>(adj.data(), adj.size());
+  coarse.ewgt = Map<IndexVector>(ewgt.data(), ewgt.size());
+}
+
+/** \internal Moves the vertex \a v of \a g to the other side of the bisection \a part, updating the internal and
+  * external degrees of its neighbors, and the weights of the parts */
+template<typename StorageIndex>
+void ordering_move_vertex(const ordering_graph<StorageIndex>& g, StorageIndex v, Matrix<StorageIndex,Dynamic,1>& part,
+                          Matrix<StorageIndex,Dynamic,1>& internalWeight, Matrix<StorageIndex,Dynamic,1>& externalWeight,
+                          Index* partWeight)
+{
+  const StorageIndex from = part.coeff(v), to = 1-from;
+  part.coeffRef(v) = to;
+  partWeight[from] -= g.vwgt.coeff(v);
+  partWeight[to] += g.vwgt.coeff(v);
+  std::swap(internalWeight.coeffRef(v), externalWeight.coeffRef(v));
+  for(StorageIndex p = g.xadj.coeff(v); p < g.xadj.coeff(v+1); ++p)
+  {
+    StorageIndex u = g.adj.coeff(p);
+    if(part.coeff(u)==from)
+    {
+      internalWeight.coeffRef(u) -= g.ewgt.coeff(p);
+      externalWeight.coeffRef(u) += g.ewgt.coeff(p);
+    }
+    else
+    {
+      internalWeight.coeffRef(u) += g.ewgt.coeff(p);
+      externalWeight.coeffRef(u) -= g.ewgt.coeff(p);
+    }
+  }
+}
+
+/** \internal Fiduccia-Mattheyses refinement of the bisection \a part of \a g: in each pass, the boundary vertices of
+  * largest gain are moved once to the other side, provided the parts weigh at most \a maxWeight, and the moves
+  * following the best intermediate bisection are undone.
+  * \returns the edge cut */
+template<typename StorageIndex>
+Index ordering_refine_bisection(const ordering_graph<StorageIndex>& g, Matrix<StorageIndex,Dynamic,1>& part, Index maxWeight)
+{
+  typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+  typedef std::pair<Index,StorageIndex> GainEntry;
+  const Index n = g.size();
+  // number of consecutive moves without improvement after which a pass is stopped
+  const Index maxUselessMoves = 64;
+  IndexVector internalWeight = IndexVector::Zero(n), externalWeight = IndexVector::Zero(n);
+  Index partWeight[2] = { 0, 0 };
+  Index cut = 0;
+  for(Index v = 0; v < n; ++v)
+  {
+    partWeight[part.coeff(v)] += g.vwgt.coeff(v);
+    for(StorageIndex p = g.xadj.coeff(v); p < g.xadj.coeff(v+1); ++p)
+    {
+      if(part.coeff(g.adj.coeff(p))==part.coeff(v))
+        internalWeight.coeffRef(v) += g.ewgt.coeff(p);
+      else
+        externalWeight.coeffRef(v) += g.ewgt.coeff(p);
+    }
+    cut += externalWeight.coeff(v);
+  }
+  cut /= 2;
+
+  Matrix<bool,Dynamic,1> locked(n);
+  std::vector<StorageIndex> moves;
+  for(int pass = 0; pass < 8; ++pass)
+  {
+    // the gains are updated lazily: the outdated entries of the queue are skipped
+    std::priority_queue<GainEntry> queue;
+    for(Index v = 0; v < n; ++v)
+      if(externalWeight.coeff(v)>0)
+        queue.push(GainEntry(externalWeight.coeff(v) - internalWeight.coeff(v), StorageIndex(v)));
+    locked.setConstant(false);
+    moves.clear();
+    Index bestCut = cut, bestImbalance = numext::abs(partWeight[0]-partWeight[1]);
+    std::size_t bestMoves = 0;
+    while(!queue.empty() && moves.size() < bestMoves + maxUselessMoves)
+    {
+      const GainEntry top = queue.top();
+      queue.pop();
+      const StorageIndex v = top.second;
+      if(locked.coeff(v) || top.first != externalWeight.coeff(v) - internalWeight.coeff(v))
+        continue;
+      if(partWeight[1-part.coeff(v)] + g.vwgt.coeff(v) > maxWeight)
+        continue;
+      ordering_move_vertex(g, v, part, internalWeight, externalWeight, partWeight);
+      locked.coeffRef(v) = true;
+      moves.push_back(v);
+      cut -= top.first;
+      for(StorageIndex p = g.xadj.coeff(v); p < g.xadj.coeff(v+1); ++p)
+      {
+        StorageIndex u = g.adj.coeff(p);
+        if(!locked.coeff(u))
+          queue.push(GainEntry(externalWeight.coeff(u) - internalWeight.coeff(u), u));
+      }
+      const Index imbalance = numext::abs(partWeight[0]-partWeight[1]);
+      if(cut < bestCut || (cut==bestCut && imbalance < bestImbalance))
+      {
+        bestCut = cut;
+        bestImbalance = imbalance;
+        bestMoves = moves.size();
+      }
+    }
+    // roll back to the best bisection
+    while(moves.size() > bestMoves)
+    {
+      ordering_move_vertex(g, moves.back(), part, internalWeight, externalWeight, partWeight);
+      moves.pop_back();
+    }
+    cut = bestCut;
+    if(bestMoves==0)
+      break;
+  }
+  return cut;
+}
+
+/** \internal Initial bisection of \a g by growing a region from a few seeds in breadth first order, until it holds
+  * half of the total weight. \returns the edge cut of the best bisection, stored in \a part */
+template<typename StorageIndex>
+Index ordering_grow_bisection(const ordering_graph<StorageIndex>& g, Matrix<StorageIndex,Dynamic,1>& part, Index maxWeight)
+{
+  typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+  const Index n = g.size();
+  const Index halfWeight = g.vwgt.sum() / 2;
+  IndexVector level = IndexVector::Constant(n, -1), trial(n);
+  std::vector<StorageIndex> queue;
+  Index bestCut = -1;
+  const int seeds = 4;
+  StorageIndex seed = ordering_pseudo_peripheral_vertex(g, StorageIndex(0), level, queue);
+  for(int s = 0; s < seeds; ++s)
+  {
+    trial.setOnes();
+    Index weight = 0;
+    queue.clear();
+    for(Index v = seed; weight < halfWeight; v = (v+1)%n)
+    {
+      // restart from an unvisited vertex when the component of the seed is exhausted
+      if(level.coeff(v)>=0)
+        continue;
+      std::size_t head = queue.size();
+      queue.push_back(StorageIndex(v));
+      level.coeffRef(v) = 0;
+      for(; head < queue.size() && weight < halfWeight; ++head)
+      {
+        StorageIndex u = queue[head];
+        trial.coeffRef(u) = 0;
+        weight += g.vwgt.coeff(u);
+        for(StorageIndex p = g.xadj.coeff(u); p < g.xadj.coeff(u+1); ++p)
+          if(level.coeff(g.adj.coeff(p))<0)
+          {
+            level.coeffRef(g.adj.coeff(p)) = 0;
+            queue.push_back(g.adj.coeff(p));
+          }
+      }
+    }
+    for(std::size_t k = 0; k < queue.size(); ++k)
+      level.coeffRef(queue[k]) = -1;
+
+    Index cut = ordering_refine_bisection(g, trial, maxWeight);
+    if(bestCut<0 || cut < bestCut)
+    {
+      bestCut = cut;
+      part = trial;
+    }
+    seed = StorageIndex((seed + (s+1)*n/seeds + 1) % n);
+  }
+  return bestCut;
+}
+
+/** \internal Multilevel bisection of \a g: \a part[v] is set to 0 or 1 */
+template<typename StorageIndex>
+void ordering_bisect(const ordering_graph<StorageIndex>& g, Matrix<StorageIndex,Dynamic,1>& part)
+{
+  typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+  const Index coarsestSize = 64;
+  const Index totalWeight = g.vwgt.sum();
+
+  // coarsen until the graph is small enough, or the matching stalls
+  std::vector<ordering_graph<StorageIndex> > graphs(1);
+  std::vector<IndexVector> cmaps;
+  const ordering_graph<StorageIndex>* current = &g;
+  while(current->size() > coarsestSize)
+  {
+    ordering_graph<StorageIndex> coarse;
+    IndexVector cmap;
+    ordering_coarsen(*current, coarse, cmap);
+    if(coarse.size() > (current->size()*9)/10)
+      break;
+    graphs.push_back(coarse);
+    cmaps.push_back(cmap);
+    current = &graphs.back();
+  }
+
+  // a part may exceed half of the weight by a few percents, or by the heaviest vertex
+  Index maxWeight = (std::max)(totalWeight/2 + totalWeight/32, totalWeight/2 + Index(current->vwgt.maxCoeff()));
+  ordering_grow_bisection(*current, part, maxWeight);
+
+  // project the bisection back to the finer graphs, and refine it
+  for(Index l = Index(cmaps.size())-1; l >= 0; --l)
+  {
+    const ordering_graph<StorageIndex>& fine = l==0 ? g : graphs[l];
+    IndexVector finePart(fine.size());
+    for(Index v = 0; v < fine.size(); ++v)
+      finePart.coeffRef(v) = part.coeff(cmaps[l].coeff(v));
+    part.swap(finePart);
+    maxWeight = (std::max)(totalWeight/2 + totalWeight/32, totalWeight/2 + Index(fine.vwgt.maxCoeff()));
+    ordering_refine_bisection(fine, part, maxWeight);
+  }
+}
+
+/** \internal Turns the bisection \a part of \a g into a vertex separator, by setting \a part[v] to 2 for the vertices
+  * of a minimum vertex cover of the cut edges. The cover is obtained from a maximum matching of the bipartite graph
+  * of the cut edges, following Koenig's theorem. */
+template<typename StorageIndex>
+void ordering_vertex_separator(const ordering_graph<StorageIndex>& g, Matrix<StorageIndex,Dynamic,1>& part)
+{
+  typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+  const Index n = g.size();
+  IndexVector mate = IndexVector::Constant(n, -1), visited = IndexVector::Constant(n, -1);
+  std::vector<StorageIndex> boundary;
+  for(Index v = 0; v < n; ++v)
+    if(part.coeff(v)==0)
+      for(StorageIndex p = g.xadj.coeff(v); p < g.xadj.coeff(v+1); ++p)
+        if(part.coeff(g.adj.coeff(p))==1)
+        {
+          boundary.push_back(StorageIndex(v));
+          break;
+        }
+
+  // maximum matching by depth first searches of augmenting paths, the stack holding the vertices of the first side
+  // and the position of their next edge to explore
+  std::vector<std::pair<StorageIndex,StorageIndex> > stack;
+  for(std::size_t k = 0; k < boundary.size(); ++k)
+  {
+    stack.clear();
+    stack.push_back(std::make_pair(boundary[k], g.xadj.coeff(boundary[k])));
+    while(!stack.empty())
+    {
+      std::pair<StorageIndex,StorageIndex>& top = stack.back();
+      if(top.second==g.xadj.coeff(top.first+1))
+      {
+        stack.pop_back();
+        continue;
+      }
+      StorageIndex u = g.adj.coeff(top.second++);
+      if(part.coeff(u)!=1 || visited.coeff(u)==StorageIndex(k))
+        continue;
+      visited.coeffRef(u) = StorageIndex(k);
+      if(mate.coeff(u)<0)
+      {
+        // augment the matching along the path
+        for(std::size_t i = 0; i < stack.size(); ++i)
+        {
+          StorageIndex x = stack[i].first, y = g.adj.coeff(stack[i].second-1);
+          mate.coeffRef(x) = y;
+          mate.coeffRef(y) = x;
+        }
+        break;
+      }
+      stack.push_back(std::make_pair(mate.coeff(u), g.xadj.coeff(mate.coeff(u))));
+    }
+  }
+
+  // the cover is made of the vertices of the first side not reachable by alternating paths from the unmatched
+  // vertices of the first side, and of the reachable vertices of the second side
+  Matrix<bool,Dynamic,1> reached = Matrix<bool,Dynamic,1>::Constant(n, false);
+  std::vector<StorageIndex> queue;
+  for(std::size_t k = 0; k < boundary.size(); ++k)
+    if(mate.coeff(boundary[k])<0)
+    {
+      reached.coeffRef(boundary[k]) = true;
+      queue.push_back(boundary[k]);
+    }
+  for(std::size_t head = 0; head < queue.size(); ++head)
+  {
+    StorageIndex v = queue[head];
+    for(StorageIndex p = g.xadj.coeff(v); p < g.xadj.coeff(v+1); ++p)
+    {
+      StorageIndex u = g.adj.coeff(p);
+      if(part.coeff(u)!=1 || reached.coeff(u))
+        continue;
+      reached.coeffRef(u) = true;
+      if(mate.coeff(u)>=0 && !reached.coeff(mate.coeff(u)))
+      {
+        reached.coeffRef(mate.coeff(u)) = true;
+        queue.push_back(mate.coeff(u));
+      }
+    }
+  }
+  for(std::size_t k = 0; k < boundary.size(); ++k)
+  {
+    StorageIndex v = boundary[k];
+    if(!reached.coeff(v))
+      part.coeffRef(v) = 2;
+    for(StorageIndex p = g.xadj.coeff(v); p < g.xadj.coeff(v+1); ++p)
+      if(reached.coeff(g.adj.coeff(p)) && part.coeff(g.adj.coeff(p))==1)
+        part.coeffRef(g.adj.coeff(p)) = 2;
+  }
+}
+
+/** \internal Writes into \a order[0] ... \a order[n-1] the nested dissection ordering of the subgraph \a g,
+  * \a ids mapping its vertices to the original ones. The vertices of the separator are ordered last. */
+template<typename StorageIndex>
+void ordering_nested_dissection(const ordering_graph<StorageIndex>& g, const StorageIndex* ids, StorageIndex* order,
+                                Index leafSize, Matrix<StorageIndex,Dynamic,1>& local)
+{
+  typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+  const Index n = g.size();
+  if(n <= leafSize)
+  {
+#ifndef EIGEN_MPL2_ONLY
+    // the small subgraphs are ordered by minimum degree, which requires the diagonal entries
+    SparseMatrix<double,ColMajor,StorageIndex> C(n, n);
+    C.resizeNonZeros(g.adj.size() + n);
+    C.outerIndexPtr()[0] = 0;
+    for(Index v = 0; v < n; ++v)
+    {
+      StorageIndex* inner = C.innerIndexPtr() + C.outerIndexPtr()[v];
+      *inner++ = StorageIndex(v);
+      for(StorageIndex p = g.xadj.coeff(v); p < g.xadj.coeff(v+1); ++p)
+        *inner++ = g.adj.coeff(p);
+      C.outerIndexPtr()[v+1] = C.outerIndexPtr()[v] + StorageIndex(g.degree(v)) + 1;
+    }
+    PermutationMatrix<Dynamic,Dynamic,StorageIndex> perm;
+    minimum_degree_ordering(C, perm);
+    for(Index k = 0; k < n; ++k)
+      order[k] = ids[perm.indices().coeff(k)];
+#else
+    ordering_rcm(g, order);
+    for(Index k = 0; k < n; ++k)
+      order[k] = ids[order[k]];
+#endif
+    return;
+  }
+
+  IndexVector part;
+  ordering_bisect(g, part);
+  ordering_vertex_separator(g, part);
+  std::vector<StorageIndex> parts[3];
+  for(Index v = 0; v < n; ++v)
+    parts[part.coeff(v)].push_back(StorageIndex(v));
+  if(Index(parts[0].size())==n || Index(parts[1].size())==n)
+  {
+    // the graph cannot be split
+    ordering_nested_dissection(g, ids, order, n, local);
+    return;
+  }
+
+  Index offset = 0;
+  for(int s = 0; s < 2; ++s)
+  {
+    const Index size = Index(parts[s].size());
+    if(size==0)
+      continue;
+    ordering_graph<StorageIndex> sub;
+    ordering_subgraph(g, parts[s].data(), size, local, sub);
+    for(Index k = 0; k < size; ++k)
+      parts[s][k] = ids[parts[s][k]];
+    ordering_nested_dissection(sub, parts[s].data(), order + offset, leafSize, local);
+    offset += size;
+  }
+  for(std::size_t k = 0; k < parts[2].size(); ++k)
+    order[offset++] = ids[parts[2][k]];
+}
+
+} // end namespace internal
+
+/** \ingroup OrderingMethods_Module
+  * \class RCMOrdering
+  *
+  * Functor computing the \em reverse \em Cuthill-McKee ordering, which reduces the bandwidth and the profile of the
+  * matrix. Such an ordering improves the locality of the accesses to the right hand side of sparse matrix-vector
+  * products, and is well suited to banded or skyline factorizations.
+  *
+  * If the matrix is not structurally symmetric, an ordering of A^T+A is computed.
+  * As for AMDOrdering, \c perm.indices()(i) is the index of the row and column of the input matrix placed at position i.
+  * \tparam  StorageIndex The type of indices of the matrix
+  * \sa AMDOrdering, NestedDissectionOrdering
+  */
+template <typename StorageIndex>
+class RCMOrdering
+{
+  public:
+    typedef PermutationMatrix<Dynamic, Dynamic, StorageIndex> PermutationType;
+
+    /** Compute the permutation vector from a sparse matrix */
+    template <typename MatrixType>
+    void operator()(const MatrixType& mat, PermutationType& perm)
+    {
+      SparseMatrix<typename MatrixType::Scalar, ColMajor, StorageIndex> C(mat);
+      compute(C, perm);
+    }
+
+    /** Compute the permutation with a selfadjoint matrix */
+    template <typename SrcType, unsigned int SrcUpLo>
+    void operator()(const SparseSelfAdjointView<SrcType, SrcUpLo>& mat, PermutationType& perm)
+    {
+      SparseMatrix<typename SrcType::Scalar, ColMajor, StorageIndex> C; C = mat;
+      compute(C, perm);
+    }
+
+  protected:
+    template <typename MatrixType>
+    void compute(const MatrixType& C, PermutationType& perm)
+    {
+      internal::ordering_graph<StorageIndex> g;
+      internal::ordering_graph_from_pattern(C, g);
+      perm.resize(g.size());
+      internal::ordering_rcm(g, perm.indices().data());
+    }
+};
+
+/** \ingroup OrderingMethods_Module
+  * \class NestedDissectionOrdering
+  *
+  * Functor computing a \em nested \em dissection ordering.
+  *
+  * The graph of the matrix is recursively split by small vertex separators, which are ordered after the two
+  * parts they separate, until the parts have less than leafSize() vertices; the remaining parts are ordered by
+  * minimum degree (by reverse Cuthill-McKee if EIGEN_MPL2_ONLY is defined). The separators are computed by a simple
+  * multilevel bisection: the graph is coarsened by heavy edge matching, the coarsest graph is split by growing a
+  * region from a peripheral vertex, and the bisection is refined by Fiduccia-Mattheyses passes while being projected
+  * back to the finer graphs. The separator is finally a minimum vertex cover of the cut edges.
+  *
+  * On the matrices arising from large 3D meshes, this ordering usually produces less fill-in than the minimum
+  * degree orderings, and its elimination tree is well balanced: the factorizations of the two parts of each
+  * separator are independent. It does not depend on METIS, see MetisOrdering for the external alternative.
+  *
+  * If the matrix is not structurally symmetric, an ordering of A^T+A is computed.
+  * As for AMDOrdering, \c perm.indices()(i) is the index of the row and column of the input matrix placed at position i.
+  * \tparam  StorageIndex The type of indices of the matrix
+  * \sa AMDOrdering, RCMOrdering
+  */
+template <typename StorageIndex>
+class NestedDissectionOrdering
+{
+  public:
+    typedef PermutationMatrix<Dynamic, Dynamic, StorageIndex> PermutationType;
+
+    NestedDissectionOrdering() : m_leafSize(128) {}
+
+    /** Sets the number of vertices under which the subgraphs are not dissected anymore (default is 128) */
+    void setLeafSize(Index leafSize) { eigen_assert(leafSize>0); m_leafSize = leafSize; }
+
+    /** \returns the number of vertices under which the subgraphs are not dissected anymore */
+    Index leafSize() const { return m_leafSize; }
+
+    /** Compute the permutation vector from a sparse matrix */
+    template <typename MatrixType>
+    void operator()(const MatrixType& mat, PermutationType& perm)
+    {
+      SparseMatrix<typename MatrixType::Scalar, ColMajor, StorageIndex> C(mat);
+      compute(C, perm);
+    }
+
+    /** Compute the permutation with a selfadjoint matrix */
+    template <typename SrcType, unsigned int SrcUpLo>
+    void operator()(const SparseSelfAdjointView<SrcType, SrcUpLo>& mat, PermutationType& perm)
+    {
+      SparseMatrix<typename SrcType::Scalar, ColMajor, StorageIndex> C; C = mat;
+      compute(C, perm);
+    }
+
+  protected:
+    template <typename MatrixType>
+    void compute(const MatrixType& C, PermutationType& perm)
+    {
+      typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+      internal::ordering_graph<StorageIndex> g;
+      internal::ordering_graph_from_pattern(C, g);
+      const Index n = g.size();
+      IndexVector ids = IndexVector::LinSpaced(n, 0, StorageIndex(n-1));
+      IndexVector local = IndexVector::Constant(n, -1);
+      perm.resize(n);
+      internal::ordering_nested_dissection(g, ids.data(), perm.indices().data(), m_leafSize, local);
+    }
+
+    Index m_leafSize;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_GRAPH_ORDERING_H
@@ -431,6 +431,12 @@ template<typename _MatrixType> class ColPivHouseholderQR
 
     void computeInPlace();
 
+    void selectPivot(Index k, RealScalar threshold_helper);
+
+    template<typename FactorType>
+    Index computeBlockedPanel(Index offset, Index blockSize, FactorType& F,
+                              RealScalar threshold_helper, RealScalar norm_downdate_threshold);
+
     MatrixType m_qr;
     HCoeffsType m_hCoeffs;
     PermutationType m_colsPermutation;
@@ -495,7 +501,6 @@ void ColPivHouseholderQR<MatrixType>::computeInPlace()
   m_temp.resize(cols);
 
   m_colsTranspositions.resize(m_qr.cols());
-  Index number_of_transpositions = 0;
 
   m_colNormsUpdated.resize(cols);
   m_colNormsDirect.resize(cols);
@@ -512,26 +517,24 @@ void ColPivHouseholderQR<MatrixType>::computeInPlace()
   m_nonzero_pivots = size; // the generic case is that in which all pivots are nonzero (invertible case)
   m_maxpivot = RealScalar(0);
 
-  for(Index k = 0; k < size; ++k)
+  Index k = 0;
+
+  // For large dynamic-size matrices, the leading columns are processed by panels
+  // of blockSize columns following LAPACK's xGEQP3: the reflectors of a panel are
+  // accumulated and the trailing matrix is updated with a single matrix-matrix product.
+  // The last panels are too small to benefit from blocking and are handled
+  // by the unblocked loop below.
+  const Index blockSize = 32;
+  if(MatrixType::MaxColsAtCompileTime==Dynamic && size > 2*blockSize)
   {
-    // first, we look up in our table m_colNormsUpdated which column has the biggest norm
-    Index biggest_col_index;
-    RealScalar biggest_col_sq_norm = numext::abs2(m_colNormsUpdated.tail(cols-k).maxCoeff(&biggest_col_index));
-    biggest_col_index += k;
-
-    // Track the number of meaningful pivots but do not stop the decomposition to make
-    // sure that the initial matrix is properly reproduced. See bug 941.
-    if(m_nonzero_pivots==size && biggest_col_sq_norm < threshold_helper * RealScalar(rows-k))
-      m_nonzero_pivots = k;
-
-    // apply the transposition to the columns
-    m_colsTranspositions.coeffRef(k) = biggest_col_index;
-    if(k != biggest_col_index) {
-      m_qr.col(k).swap(m_qr.col(biggest_col_index));
-      std::swap(m_colNormsUpdated.coeffRef(k), m_colNormsUpdated.coeffRef(biggest_col_index));
-      std::swap(m_colNormsDirect.coeffRef(k), m_colNormsDirect.coeffRef(biggest_col_index));
-      ++number_of_transpositions;
-    }
+    Matrix<Scalar,Dynamic,Dynamic> F(cols, blockSize);
+    while(k < size-blockSize)
+      k += computeBlockedPanel(k, blockSize, F, threshold_helper, norm_downdate_threshold);
+  }
+
+  for(; k < size; ++k)
+  {
+    selectPivot(k, threshold_helper);
 
     // generate the householder vector, store it below the diagonal
     RealScalar beta;
@@ -571,14 +574,157 @@ void ColPivHouseholderQR<MatrixType>::computeInPlace()
     }
   }
 
+  Index number_of_transpositions = 0;
   m_colsPermutation.setIdentity(PermIndexType(cols));
   for(PermIndexType k = 0; k < size/*m_nonzero_pivots*/; ++k)
+  {
     m_colsPermutation.applyTranspositionOnTheRight(k, PermIndexType(m_colsTranspositions.coeff(k)));
+    if(m_colsTranspositions.coeff(k) != k) ++number_of_transpositions;
+  }
 
   m_det_pq = (number_of_transpositions%2) ? -1 : 1;
   m_isInitialized = true;
 }
 
+/** \internal
+  * Moves the column of largest updated norm among the columns \a k, ..., cols()-1 to position \a k,
+  * and records the transposition.
+  */
+template<typename MatrixType>
+void ColPivHouseholderQR<MatrixType>::selectPivot(Index k, RealScalar threshold_helper)
+{
+  Index rows = m_qr.rows();
+  Index cols = m_qr.cols();
+  Index size = m_qr.diagonalSize();
+
+  // first, we look up in our table m_colNormsUpdated which column has the biggest norm
+  Index biggest_col_index;
+  RealScalar biggest_col_sq_norm = numext::abs2(m_colNormsUpdated.tail(cols-k).maxCoeff(&biggest_col_index));
+  biggest_col_index += k;
+
+  // Track the number of meaningful pivots but do not stop the decomposition to make
+  // sure that the initial matrix is properly reproduced. See bug 941.
+  if(m_nonzero_pivots==size && biggest_col_sq_norm < threshold_helper * RealScalar(rows-k))
+    m_nonzero_pivots = k;
+
+  // apply the transposition to the columns
+  m_colsTranspositions.coeffRef(k) = biggest_col_index;
+  if(k != biggest_col_index) {
+    m_qr.col(k).swap(m_qr.col(biggest_col_index));
+    std::swap(m_colNormsUpdated.coeffRef(k), m_colNormsUpdated.coeffRef(biggest_col_index));
+    std::swap(m_colNormsDirect.coeffRef(k), m_colNormsDirect.coeffRef(biggest_col_index));
+  }
+}
+
+/** \internal
+  * Factorizes at most \a blockSize columns starting at column \a offset. This is a port of LAPACK's xLAQPS:
+  * the updates of the trailing columns are accumulated as \f$ A \leftarrow A - V F^* \f$ where \b V holds
+  * the Householder vectors of the panel. Only the current row of the trailing matrix is updated at each step,
+  * as required by the norm downdating. The panel is closed early when a downdated norm becomes inaccurate,
+  * in which case it is recomputed once the trailing matrix has been updated.
+  *
+  * \returns the number of factorized columns
+  */
+template<typename MatrixType>
+template<typename FactorType>
+Index ColPivHouseholderQR<MatrixType>::computeBlockedPanel(Index offset, Index blockSize, FactorType& F,
+                                                           RealScalar threshold_helper, RealScalar norm_downdate_threshold)
+{
+  using std::abs;
+
+  Index rows = m_qr.rows();
+  Index cols = m_qr.cols();
+  Index size = m_qr.diagonalSize();
+  Index nb = (std::min)(blockSize, size-offset);
+
+  Matrix<Scalar,Dynamic,1> aux(nb);
+  bool needsNormRecomputation = false;
+  Index i = 0;
+  while(i < nb && !needsNormRecomputation)
+  {
+    Index k = offset + i;
+    Index remainingRows = rows - k;
+    Index remainingCols = cols - k - 1;
+
+    selectPivot(k, threshold_helper);
+    Index p = m_colsTranspositions.coeff(k);
+    if(p != k)
+      F.row(k-offset).swap(F.row(p-offset));
+
+    // apply the previous reflectors of the panel to the pivot column
+    if(i > 0)
+      m_qr.col(k).tail(remainingRows).noalias() -= m_qr.block(k, offset, remainingRows, i) * F.row(k-offset).head(i).adjoint();
+
+    // generate the householder vector, store it below the diagonal
+    RealScalar beta;
+    m_qr.col(k).tail(remainingRows).makeHouseholderInPlace(m_hCoeffs.coeffRef(k), beta);
+    m_qr.coeffRef(k,k) = Scalar(1);
+
+    // remember the maximum absolute value of diagonal coefficients
+    if(abs(beta) > m_maxpivot) m_maxpivot = abs(beta);
+
+    // compute the i-th column of F:
+    //   F(:,i) = conj(h) * (A^* v - F V^* v)
+    Scalar h = numext::conj(m_hCoeffs.coeff(k));
+    F.col(i).head(k+1-offset).setZero();
+    if(remainingCols > 0)
+      F.col(i).segment(k+1-offset, remainingCols).noalias() = h * (m_qr.block(k, k+1, remainingRows, remainingCols).adjoint() * m_qr.col(k).tail(remainingRows));
+    if(i > 0)
+    {
+      aux.head(i).noalias() = -h * (m_qr.block(k, offset, remainingRows, i).adjoint() * m_qr.col(k).tail(remainingRows));
+      F.col(i).head(cols-offset).noalias() += F.topLeftCorner(cols-offset, i) * aux.head(i);
+    }
+
+    // update the current row of the trailing matrix
+    if(remainingCols > 0)
+      m_qr.row(k).tail(remainingCols).noalias() -= m_qr.row(k).segment(offset, i+1) * F.block(k+1-offset, 0, remainingCols, i+1).adjoint();
+
+    // update our table of norms of the columns, see the unblocked variant for the details
+    if(remainingRows > 1)
+    {
+      for (Index j = k + 1; j < cols; ++j) {
+        if (m_colNormsUpdated.coeffRef(j) != 0) {
+          RealScalar temp = abs(m_qr.coeffRef(k, j)) / m_colNormsUpdated.coeffRef(j);
+          temp = (RealScalar(1) + temp) * (RealScalar(1) - temp);
+          temp = temp < 0 ? 0 : temp;
+          RealScalar temp2 = temp * numext::abs2<Scalar>(m_colNormsUpdated.coeffRef(j) /
+                                                         m_colNormsDirect.coeffRef(j));
+          if (temp2 <= norm_downdate_threshold) {
+            // The trailing column is not up to date yet: flag it and stop the panel here.
+            m_colNormsDirect.coeffRef(j) = RealScalar(-1);
+            needsNormRecomputation = true;
+          } else {
+            m_colNormsUpdated.coeffRef(j) *= numext::sqrt(temp);
+          }
+        }
+      }
+    }
+
+    // apply the householder transformation to the diagonal coefficient
+    m_qr.coeffRef(k,k) = beta;
+    ++i;
+  }
+
+  // apply the accumulated block reflector to the remaining rows of the trailing matrix
+  Index end = offset + i;
+  if(end < rows && end < cols)
+    m_qr.bottomRightCorner(rows-end, cols-end).noalias() -= m_qr.block(end, offset, rows-end, i) * F.block(end-offset, 0, cols-end, i).adjoint();
+
+  if(needsNormRecomputation)
+  {
+    for(Index j = end; j < cols; ++j)
+    {
+      if(m_colNormsDirect.coeff(j) < RealScalar(0))
+      {
+        m_colNormsDirect.coeffRef(j) = m_qr.col(j).tail(rows - end).norm();
+        m_colNormsUpdated.coeffRef(j) = m_colNormsDirect.coeffRef(j);
+      }
+    }
+  }
+
+  return i;
+}
+
 #ifndef EIGEN_PARSED_BY_DOXYGEN
 template<typename _MatrixType>
 template<typename RhsType, typename DstType>
@@ -0,0 +1,512 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TALL_SKINNY_QR_H
+#define EIGEN_TALL_SKINNY_QR_H
+
+namespace Eigen {
+
+template<typename TallSkinnyQRType> struct TallSkinnyQRMatrixQReturnType;
+template<typename TallSkinnyQRType> struct TallSkinnyQRMatrixQAdjointReturnType;
+template<typename TallSkinnyQRType, typename Derived> struct TallSkinnyQR_QProduct;
+
+namespace internal {
+
+template<typename TallSkinnyQRType> struct traits<TallSkinnyQRMatrixQReturnType<TallSkinnyQRType> >
+{
+  typedef Matrix<typename TallSkinnyQRType::Scalar,Dynamic,Dynamic> ReturnType;
+};
+
+template<typename TallSkinnyQRType, typename Derived> struct traits<TallSkinnyQR_QProduct<TallSkinnyQRType, Derived> >
+{
+  typedef typename Derived::PlainObject ReturnType;
+};
+
+/** \internal
+  * Computes in place the QR decomposition of the stacked upper triangular factors \a top and \a bottom.
+  * The k-th Householder reflector only involves the k-th row of \a top and the first k+1 rows of \a bottom, the
+  * lower triangular parts being zero. Its vector is thus the unit vector e_k on \a top, and its essential part
+  * is stored in the k-th column of the upper triangular part of \a bottom. The factor R overwrites the upper
+  * triangular part of \a top, the strictly lower triangular parts of \a top and \a bottom are not referenced.
+  */
+template<typename TopType, typename BottomType, typename HCoeffs, typename RowVectorType>
+void tsqr_triangular_pair_qr(TopType& top, BottomType& bottom, HCoeffs& hCoeffs, RowVectorType& workspace)
+{
+  typedef typename TopType::Scalar Scalar;
+  typedef typename TopType::RealScalar RealScalar;
+  const Index n = top.cols();
+  const RealScalar tol = (std::numeric_limits<RealScalar>::min)();
+  for(Index k = 0; k < n; ++k)
+  {
+    // same reflector as MatrixBase::makeHouseholder() on [top(k,k); bottom(0:k,k)]
+    typename BottomType::ColXpr::SegmentReturnType essential = bottom.col(k).head(k+1);
+    const Scalar c0 = top.coeff(k,k);
+    const RealScalar tailSqNorm = essential.squaredNorm();
+    RealScalar beta;
+    Scalar tau;
+    if(tailSqNorm <= tol && numext::abs2(numext::imag(c0)) <= tol)
+    {
+      tau = Scalar(0);
+      beta = numext::real(c0);
+      essential.setZero();
+    }
+    else
+    {
+      beta = numext::sqrt(numext::abs2(c0) + tailSqNorm);
+      if(numext::real(c0) >= RealScalar(0))
+        beta = -beta;
+      essential /= (c0 - beta);
+      tau = numext::conj((beta - c0) / beta);
+    }
+    top.coeffRef(k,k) = beta;
+    hCoeffs.coeffRef(k) = tau;
+
+    // apply it to the remaining columns, as MatrixBase::applyHouseholderOnTheLeft() does
+    const Index r = n-k-1;
+    if(r > 0)
+    {
+      typename RowVectorType::SegmentReturnType w = workspace.head(r);
+      w.noalias() = essential.adjoint() * bottom.block(0, k+1, k+1, r);
+      w += top.row(k).tail(r);
+      top.row(k).tail(r) -= tau * w;
+      bottom.block(0, k+1, k+1, r).noalias() -= tau * essential * w;
+    }
+  }
+}
+
+} // end namespace internal
+
+/** \ingroup QR_Module
+  *
+  *
+  * \class TallSkinnyQR
+  *
+  * \brief Householder QR decomposition of a tall and skinny matrix by a reduction tree (TSQR)
+  *
+  * \tparam _MatrixType the type of the matrix of which we are computing the QR decomposition
+  *
+  * This class performs a QR decomposition of a matrix \b A into matrices \b Q and \b R
+  * such that
+  * \f[
+  *  \mathbf{A} = \mathbf{Q} \, \mathbf{R}
+  * \f]
+  * as HouseholderQR does, but the rows of \b A are first split into blocks which are factorized
+  * independently. The triangular factors of the blocks are then combined pairwise along a binary tree
+  * until a single one, \b R, remains. When OpenMP is enabled, the blocks and the nodes of each level of the
+  * tree are processed in parallel, which makes this decomposition well suited to least-squares problems
+  * with many more rows than columns.
+  *
+  * A node of the tree factorizes the two stacked n x n triangular factors with a QR decomposition exploiting
+  * their structure, which costs about \f$ 2n^3/3 \f$ flops instead of the \f$ 10n^3/3 \f$ flops of a dense
+  * QR decomposition of the 2n x n stacked matrix.
+  *
+  * The factor \b Q is never formed: it is stored as the set of Householder sequences of the blocks and of
+  * the tree nodes, see householderQ(). Likewise, solve() only applies \b Q<sup>*</sup> to the right hand side.
+  *
+  * Note that no pivoting is performed. This is \b not a rank-revealing decomposition.
+  *
+  * \sa class HouseholderQR
+  */
+template<typename _MatrixType> class TallSkinnyQR
+{
+  public:
+
+    typedef _MatrixType MatrixType;
+    enum {
+      RowsAtCompileTime = MatrixType::RowsAtCompileTime,
+      ColsAtCompileTime = MatrixType::ColsAtCompileTime,
+      MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime,
+      MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime
+    };
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::StorageIndex StorageIndex;
+    typedef Matrix<Scalar,Dynamic,Dynamic> BlockHCoeffsType;
+    typedef TallSkinnyQRMatrixQReturnType<TallSkinnyQR> MatrixQReturnType;
+
+  protected:
+
+    // a node of the reduction tree: the QR decomposition of the two stacked triangular factors
+    // currently held by the rows starting at top and at bottom. The factor R overwrites the one of
+    // the top rows, and the Householder vectors the one of the bottom rows, see tsqr_triangular_pair_qr().
+    struct Node
+    {
+      Index top, bottom;
+      Matrix<Scalar,Dynamic,1> hCoeffs;
+    };
+
+  public:
+
+    /**
+      * \brief Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via TallSkinnyQR::compute(const MatrixType&).
+      */
+    TallSkinnyQR() : m_qr(), m_blockRows(0), m_isInitialized(false) {}
+
+    /** \brief Constructs a QR factorization from a given matrix
+      *
+      * This constructor computes the QR factorization of the matrix \a matrix by calling
+      * the method compute().
+      *
+      * \sa compute()
+      */
+    template<typename InputType>
+    explicit TallSkinnyQR(const EigenBase<InputType>& matrix)
+      : m_qr(matrix.rows(), matrix.cols()),
+        m_blockRows(0),
+        m_isInitialized(false)
+    {
+      compute(matrix.derived());
+    }
+
+    /** This method finds a solution x to the equation Ax=b, where A is the matrix of which
+      * *this is the QR decomposition. If A has more rows than columns, this is the least-squares solution.
+      *
+      * \param b the right-hand-side of the equation to solve.
+      *
+      * \returns a solution.
+      *
+      * The factor \b Q is not formed, only its adjoint is applied to \a b.
+      */
+    template<typename Rhs>
+    inline const Solve<TallSkinnyQR, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return Solve<TallSkinnyQR, Rhs>(*this, b.derived());
+    }
+
+    /** \returns an expression of the factor \b Q.
+      *
+      * It can be converted to a dense matrix, or multiplied by a dense matrix. For instance the thin
+      * factor is obtained by:
+      * \code
+      * MatrixXd thinQ = qr.householderQ() * MatrixXd::Identity(qr.rows(), qr.cols());
+      * \endcode
+      * The product by the adjoint is also available through householderQ().adjoint().
+      */
+    MatrixQReturnType householderQ() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return MatrixQReturnType(*this);
+    }
+    MatrixQReturnType matrixQ() const
+    {
+      return householderQ();
+    }
+
+    /** \returns a reference to the matrix where the decomposition is stored.
+      *
+      * The factor \b R is stored in the upper triangular part of the first cols() rows.
+      * The remaining coefficients hold internal values. To get \b R, use
+      * \code matrixQR().topRows(qr.cols()).template triangularView<Upper>() \endcode
+      */
+    const MatrixType& matrixQR() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_qr;
+    }
+
+    template<typename InputType>
+    TallSkinnyQR& compute(const EigenBase<InputType>& matrix)
+    {
+      m_qr = matrix.derived();
+      computeInPlace();
+      return *this;
+    }
+
+    /** Sets the number of rows of the blocks factorized independently.
+      *
+      * By default, or if \a blockRows is 0, the rows are split evenly into Eigen::nbThreads() blocks.
+      * The actual number of rows of a block is never smaller than the number of columns.
+      * This must be called before compute() to take effect.
+      */
+    TallSkinnyQR& setBlockRows(Index blockRows)
+    {
+      m_blockRows = blockRows;
+      return *this;
+    }
+
+    /** \returns the number of blocks the rows have been split into */
+    inline Index blocks() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return Index(m_blockStarts.size())-1;
+    }
+
+    inline Index rows() const { return m_qr.rows(); }
+    inline Index cols() const { return m_qr.cols(); }
+
+    #ifndef EIGEN_PARSED_BY_DOXYGEN
+    template<typename RhsType, typename DstType>
+    EIGEN_DEVICE_FUNC
+    void _solve_impl(const RhsType &rhs, DstType &dst) const;
+
+    template<typename Dest>
+    void _apply_q_in_place(Dest& dst, bool adjoint) const;
+    #endif
+
+  protected:
+
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar);
+    }
+
+    void computeInPlace();
+
+    MatrixType m_qr;
+    BlockHCoeffsType m_blockHCoeffs;
+    std::vector<Index> m_blockStarts;
+    std::vector<Node> m_nodes;
+    std::vector<Index> m_levelStarts;
+    Index m_blockRows;
+    bool m_isInitialized;
+};
+
+template<typename MatrixType>
+void TallSkinnyQR<MatrixType>::computeInPlace()
+{
+  check_template_parameters();
+
+  Index rows = m_qr.rows();
+  Index cols = m_qr.cols();
+  Index size = (std::min)(rows,cols);
+
+  // split the rows into blocks having at least cols rows, the last one gets the remaining rows
+  Index blockRows = m_blockRows>0 ? m_blockRows : (rows+Eigen::nbThreads()-1)/Eigen::nbThreads();
+  blockRows = numext::maxi<Index>(blockRows, cols);
+  Index nbBlocks = rows<2*cols ? 1 : numext::maxi<Index>(1, rows/blockRows);
+
+  m_blockStarts.resize(nbBlocks+1);
+  for(Index i = 0; i < nbBlocks; ++i)
+    m_blockStarts[i] = i*blockRows;
+  m_blockStarts[nbBlocks] = rows;
+
+  m_blockHCoeffs.resize(size, nbBlocks);
+
+  // factorize each block independently
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(dynamic,1) num_threads(numext::mini<Index>(nbBlocks,Eigen::nbThreads()))
+#endif
+  for(Index i = 0; i < nbBlocks; ++i)
+  {
+    typedef typename MatrixType::RowsBlockXpr BlockQRType;
+    typedef typename BlockHCoeffsType::ColXpr BlockHCoeffsColType;
+    BlockQRType blockQR = m_qr.middleRows(m_blockStarts[i], m_blockStarts[i+1]-m_blockStarts[i]);
+    BlockHCoeffsColType blockHCoeffs = m_blockHCoeffs.col(i);
+    internal::householder_qr_inplace_blocked<BlockQRType, BlockHCoeffsColType>::run(blockQR, blockHCoeffs, 48);
+  }
+
+  // build the reduction tree: at each level, the triangular factors held by the first rows of
+  // the active blocks are combined pairwise, an odd block being carried over to the next level.
+  m_nodes.clear();
+  m_levelStarts.clear();
+  std::vector<Index> active(m_blockStarts.begin(), m_blockStarts.end()-1);
+  while(active.size() > 1)
+  {
+    Index levelStart = Index(m_nodes.size());
+    Index levelSize = Index(active.size())/2;
+    m_levelStarts.push_back(levelStart);
+    m_nodes.resize(levelStart+levelSize);
+    for(Index j = 0; j < levelSize; ++j)
+    {
+      m_nodes[levelStart+j].top = active[2*j];
+      m_nodes[levelStart+j].bottom = active[2*j+1];
+    }
+
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic,1) num_threads(numext::mini<Index>(levelSize,Eigen::nbThreads()))
+#endif
+    for(Index j = 0; j < levelSize; ++j)
+    {
+      typedef typename MatrixType::RowsBlockXpr FactorType;
+      Node& node = m_nodes[levelStart+j];
+      FactorType top = m_qr.middleRows(node.top, cols);
+      FactorType bottom = m_qr.middleRows(node.bottom, cols);
+      Matrix<Scalar,1,Dynamic> workspace(cols);
+      node.hCoeffs.resize(cols);
+      internal::tsqr_triangular_pair_qr(top, bottom, node.hCoeffs, workspace);
+    }
+
+    std::vector<Index> next;
+    for(Index j = 0; j < levelSize; ++j)
+      next.push_back(active[2*j]);
+    if(active.size()%2)
+      next.push_back(active.back());
+    active.swap(next);
+  }
+  m_levelStarts.push_back(Index(m_nodes.size()));
+
+  m_isInitialized = true;
+}
+
+/** \internal
+  * Performs dst = Q * dst, or dst = Q^* * dst if \a adjoint is true, by traversing the tree.
+  */
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+template<typename MatrixType>
+template<typename Dest>
+void TallSkinnyQR<MatrixType>::_apply_q_in_place(Dest& dst, bool adjoint) const
+{
+  eigen_assert(dst.rows() == rows());
+  const Index cols = this->cols();
+  const Index nbBlocks = blocks();
+  const Index nbLevels = Index(m_levelStarts.size())-1;
+  const Index size = (std::min)(rows(), cols);
+
+  // Note that the Q factor of a block is H_0^* H_1^*... so its adjoint is (H_0 H_1 ...)^T
+  if(adjoint)
+  {
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic,1) num_threads(numext::mini<Index>(nbBlocks,Eigen::nbThreads()))
+#endif
+    for(Index i = 0; i < nbBlocks; ++i)
+    {
+      Index start = m_blockStarts[i], len = m_blockStarts[i+1]-start;
+      typename Dest::RowsBlockXpr dstBlock = dst.middleRows(start, len);
+      dstBlock.applyOnTheLeft(householderSequence(m_qr.middleRows(start, len).leftCols(size), m_blockHCoeffs.col(i)).transpose());
+    }
+  }
+
+  for(Index l = 0; l < nbLevels; ++l)
+  {
+    Index level = adjoint ? l : nbLevels-1-l;
+    Index levelStart = m_levelStarts[level], levelEnd = m_levelStarts[level+1];
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic,1) num_threads(numext::mini<Index>(levelEnd-levelStart,Eigen::nbThreads()))
+#endif
+    for(Index j = levelStart; j < levelEnd; ++j)
+    {
+      // the k-th reflector only involves the k-th row of the top rows and the first k+1 bottom rows
+      const Node& node = m_nodes[j];
+      typename Dest::RowsBlockXpr top = dst.middleRows(node.top, cols);
+      typename Dest::RowsBlockXpr bottom = dst.middleRows(node.bottom, cols);
+      Matrix<Scalar,1,Dynamic> w(dst.cols());
+      for(Index i = 0; i < cols; ++i)
+      {
+        const Index k = adjoint ? i : cols-1-i;
+        const Scalar tau = adjoint ? node.hCoeffs.coeff(k) : numext::conj(node.hCoeffs.coeff(k));
+        typename MatrixType::ConstColXpr::ConstSegmentReturnType essential = m_qr.col(k).segment(node.bottom, k+1);
+        w.noalias() = essential.adjoint() * bottom.topRows(k+1);
+        w += top.row(k);
+        top.row(k) -= tau * w;
+        bottom.topRows(k+1).noalias() -= tau * essential * w;
+      }
+    }
+  }
+
+  if(!adjoint)
+  {
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic,1) num_threads(numext::mini<Index>(nbBlocks,Eigen::nbThreads()))
+#endif
+    for(Index i = 0; i < nbBlocks; ++i)
+    {
+      Index start = m_blockStarts[i], len = m_blockStarts[i+1]-start;
+      typename Dest::RowsBlockXpr dstBlock = dst.middleRows(start, len);
+      dstBlock.applyOnTheLeft(householderSequence(m_qr.middleRows(start, len).leftCols(size), m_blockHCoeffs.col(i).conjugate()));
+    }
+  }
+}
+
+template<typename _MatrixType>
+template<typename RhsType, typename DstType>
+void TallSkinnyQR<_MatrixType>::_solve_impl(const RhsType &rhs, DstType &dst) const
+{
+  const Index rank = (std::min)(rows(), cols());
+  eigen_assert(rhs.rows() == rows());
+
+  typename RhsType::PlainObject c(rhs);
+
+  _apply_q_in_place(c, true);
+
+  m_qr.topLeftCorner(rank, rank)
+      .template triangularView<Upper>()
+      .solveInPlace(c.topRows(rank));
+
+  dst.topRows(rank) = c.topRows(rank);
+  dst.bottomRows(cols()-rank).setZero();
+}
+#endif
+
+/** \internal Expression of the product of the factor Q of a TallSkinnyQR, or of its adjoint, by a dense matrix */
+template<typename TallSkinnyQRType, typename Derived>
+struct TallSkinnyQR_QProduct : ReturnByValue<TallSkinnyQR_QProduct<TallSkinnyQRType, Derived> >
+{
+  TallSkinnyQR_QProduct(const TallSkinnyQRType& qr, const Derived& other, bool adjoint)
+    : m_qr(qr), m_other(other), m_adjoint(adjoint) {}
+
+  inline Index rows() const { return m_qr.rows(); }
+  inline Index cols() const { return m_other.cols(); }
+
+  template<typename DesType>
+  void evalTo(DesType& res) const
+  {
+    eigen_assert(m_qr.rows() == m_other.rows() && "Non conforming object sizes");
+    typename Derived::PlainObject tmp(m_other);
+    m_qr._apply_q_in_place(tmp, m_adjoint);
+    res = tmp;
+  }
+
+  const TallSkinnyQRType& m_qr;
+  const Derived& m_other;
+  bool m_adjoint;
+};
+
+/** \internal Implicit representation of the factor Q of a TallSkinnyQR.
+  * It can be assigned to a dense matrix, or multiplied by a dense matrix. */
+template<typename TallSkinnyQRType>
+struct TallSkinnyQRMatrixQReturnType : public ReturnByValue<TallSkinnyQRMatrixQReturnType<TallSkinnyQRType> >
+{
+  typedef typename TallSkinnyQRType::Scalar Scalar;
+
+  explicit TallSkinnyQRMatrixQReturnType(const TallSkinnyQRType& qr) : m_qr(qr) {}
+
+  template<typename Derived>
+  TallSkinnyQR_QProduct<TallSkinnyQRType, Derived> operator*(const MatrixBase<Derived>& other) const
+  {
+    return TallSkinnyQR_QProduct<TallSkinnyQRType, Derived>(m_qr, other.derived(), false);
+  }
+
+  TallSkinnyQRMatrixQAdjointReturnType<TallSkinnyQRType> adjoint() const
+  {
+    return TallSkinnyQRMatrixQAdjointReturnType<TallSkinnyQRType>(m_qr);
+  }
+
+  inline Index rows() const { return m_qr.rows(); }
+  inline Index cols() const { return m_qr.rows(); }
+
+  template<typename DesType>
+  void evalTo(DesType& res) const
+  {
+    res.setIdentity(rows(), cols());
+    m_qr._apply_q_in_place(res, false);
+  }
+
+  const TallSkinnyQRType& m_qr;
+};
+
+template<typename TallSkinnyQRType>
+struct TallSkinnyQRMatrixQAdjointReturnType
+{
+  explicit TallSkinnyQRMatrixQAdjointReturnType(const TallSkinnyQRType& qr) : m_qr(qr) {}
+
+  template<typename Derived>
+  TallSkinnyQR_QProduct<TallSkinnyQRType, Derived> operator*(const MatrixBase<Derived>& other) const
+  {
+    return TallSkinnyQR_QProduct<TallSkinnyQRType, Derived>(m_qr, other.derived(), true);
+  }
+
+  const TallSkinnyQRType& m_qr;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_TALL_SKINNY_QR_H
@@ -167,13 +167,24 @@ class SimplicialCholeskyBase : public SparseSolverBase<Derived>
         dest = b;
 
       if(m_matrix.nonZeros()>0) // otherwise L==I
-        derived().matrixL().solveInPlace(dest);
+      {
+#ifdef EIGEN_HAS_OPENMP
+        // level scheduled substitution, when it is worth it
+        if(m_solvePlan.rows()!=m_matrix.rows() || !m_solvePlan.solveInPlace(m_matrix, dest))
+#endif
+          derived().matrixL().solveInPlace(dest);
+      }
 
       if(m_diag.size()>0)
         dest = m_diag.asDiagonal().inverse() * dest;
 
       if (m_matrix.nonZeros()>0) // otherwise U==I
-        derived().matrixU().solveInPlace(dest);
+      {
+#ifdef EIGEN_HAS_OPENMP
+        if(m_solvePlan.rows()!=m_matrix.rows() || !m_solvePlan.adjointSolveInPlace(m_matrix, dest))
+#endif
+          derived().matrixU().solveInPlace(dest);
+      }
 
       if(m_P.size()>0)
         dest = m_Pinv * dest;
@@ -258,6 +269,7 @@ class SimplicialCholeskyBase : public SparseSolverBase<Derived>
     VectorI m_nonZerosPerCol;
     PermutationMatrix<Dynamic,Dynamic,StorageIndex> m_P;     // the permutation
     PermutationMatrix<Dynamic,Dynamic,StorageIndex> m_Pinv;  // the inverse permutation
+    TriangularSolvePlan<CholMatrixType> m_solvePlan;          // the level schedule of L
 
     RealScalar m_shiftOffset;
     RealScalar m_shiftScale;
@@ -601,10 +613,16 @@ public:
 
       if(Base::m_matrix.nonZeros()>0) // otherwise L==I
       {
-        if(m_LDLT)
-          LDLTTraits::getL(Base::m_matrix).solveInPlace(dest);
-        else
-          LLTTraits::getL(Base::m_matrix).solveInPlace(dest);
+#ifdef EIGEN_HAS_OPENMP
+        // level scheduled substitution, when it is worth it
+        if(Base::m_solvePlan.rows()!=Base::m_matrix.rows() || !Base::m_solvePlan.solveInPlace(Base::m_matrix, dest))
+#endif
+        {
+          if(m_LDLT)
+            LDLTTraits::getL(Base::m_matrix).solveInPlace(dest);
+          else
+            LLTTraits::getL(Base::m_matrix).solveInPlace(dest);
+        }
       }
 
       if(Base::m_diag.size()>0)
@@ -612,10 +630,15 @@ public:
 
       if (Base::m_matrix.nonZeros()>0) // otherwise I==I
       {
-        if(m_LDLT)
-          LDLTTraits::getU(Base::m_matrix).solveInPlace(dest);
-        else
-          LLTTraits::getU(Base::m_matrix).solveInPlace(dest);
+#ifdef EIGEN_HAS_OPENMP
+        if(Base::m_solvePlan.rows()!=Base::m_matrix.rows() || !Base::m_solvePlan.adjointSolveInPlace(Base::m_matrix, dest))
+#endif
+        {
+          if(m_LDLT)
+            LDLTTraits::getU(Base::m_matrix).solveInPlace(dest);
+          else
+            LLTTraits::getU(Base::m_matrix).solveInPlace(dest);
+        }
       }
 
       if(Base::m_P.size()>0)
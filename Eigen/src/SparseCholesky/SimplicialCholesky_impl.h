@@ -192,6 +192,13 @@ void SimplicialCholeskyBase<Derived>::factorize_preordered(const CholMatrixType&
 
   m_info = ok ? Success : NumericalIssue;
   m_factorizationIsOk = true;
+
+#ifdef EIGEN_HAS_OPENMP
+  if(ok && TriangularSolvePlan<CholMatrixType>::worthAnalyzing(m_matrix))
+    m_solvePlan.analyzePattern(m_matrix, DoLDLT ? UnitLower : Lower);
+  else
+    m_solvePlan = TriangularSolvePlan<CholMatrixType>();
+#endif
 }
 
 } // end namespace Eigen
@@ -14,6 +14,199 @@ namespace Eigen {
 
 namespace internal {
 
+/** \internal \returns the number of threads to use for the product of \a lhs by \a rhs,
+  * that is 1 unless OpenMP is enabled and the product is large enough. */
+template<typename Lhs, typename Rhs>
+Index conservative_sparse_sparse_product_threads(const Lhs& lhs, const Rhs& rhs)
+{
+#ifdef EIGEN_HAS_OPENMP
+  Index threads = Eigen::nbThreads();
+  // As for sparse*dense products, this threshold represents the minimal amount of work to be done to be worth it.
+  if(threads>1 && rhs.outerSize()>1 && omp_get_num_threads()==1
+      && evaluator<Lhs>(lhs).nonZerosEstimate() + evaluator<Rhs>(rhs).nonZerosEstimate() > 20000)
+    return threads;
+#else
+  EIGEN_UNUSED_VARIABLE(lhs);
+  EIGEN_UNUSED_VARIABLE(rhs);
+#endif
+  return 1;
+}
+
+/** \internal \returns the number of non zeros of the column \a j of lhs*rhs.
+  * The entries of \a mask corresponding to these non zeros are set to \a j. */
+template<typename LhsEval, typename RhsEval>
+Index sparse_sparse_product_column_nnz(const LhsEval& lhsEval, const RhsEval& rhsEval, Index j, Index* mask)
+{
+  Index nnz = 0;
+  for (typename RhsEval::InnerIterator rhsIt(rhsEval, j); rhsIt; ++rhsIt)
+  {
+    for (typename LhsEval::InnerIterator lhsIt(lhsEval, rhsIt.index()); lhsIt; ++lhsIt)
+    {
+      Index i = lhsIt.index();
+      if(mask[i]!=j)
+      {
+        mask[i] = j;
+        ++nnz;
+      }
+    }
+  }
+  return nnz;
+}
+
+/** \internal Accumulates the column \a j of lhs*rhs in the dense vector \a values. The entries of \a mask
+  * corresponding to the non zeros are set to \a j, and, if \a indices is not null, their indices are
+  * stored in it in order of appearance. */
+template<typename LhsEval, typename RhsEval, typename Scalar, typename StorageIndex>
+void sparse_sparse_product_column(const LhsEval& lhsEval, const RhsEval& rhsEval, Index j, Index* mask, Scalar* values, StorageIndex* indices)
+{
+  Index nnz = 0;
+  for (typename RhsEval::InnerIterator rhsIt(rhsEval, j); rhsIt; ++rhsIt)
+  {
+    Scalar y = rhsIt.value();
+    for (typename LhsEval::InnerIterator lhsIt(lhsEval, rhsIt.index()); lhsIt; ++lhsIt)
+    {
+      Index i = lhsIt.index();
+      Scalar x = lhsIt.value();
+      if(mask[i]!=j)
+      {
+        mask[i] = j;
+        values[i] = x * y;
+        if(indices)
+          indices[nnz++] = StorageIndex(i);
+      }
+      else
+        values[i] += x * y;
+    }
+  }
+}
+
+/** \internal Multi-threaded version of conservative_sparse_sparse_product_impl for SparseMatrix results.
+  *
+  * The product is computed in two phases. The symbolic phase computes the exact number of non zeros
+  * of each column of the result, which is then allocated once. The numeric phase fills the columns
+  * in parallel, each thread having its own dense accumulator. The inner indices are always sorted.
+  *
+  * \returns false if the product is too small to be worth it, in which case \a res is left unchanged.
+  */
+template<typename Lhs, typename Rhs, typename ResultType>
+bool conservative_sparse_sparse_product_parallel(const Lhs&, const Rhs&, ResultType&)
+{
+  // only SparseMatrix results are supported
+  return false;
+}
+
+template<typename Lhs, typename Rhs, typename ResScalar, int ResOptions, typename ResStorageIndex>
+bool conservative_sparse_sparse_product_parallel(const Lhs& lhs, const Rhs& rhs, SparseMatrix<ResScalar,ResOptions,ResStorageIndex>& res)
+{
+  const Index threads = conservative_sparse_sparse_product_threads(lhs, rhs);
+  if(threads==1)
+    return false;
+
+#ifdef EIGEN_HAS_OPENMP
+  typedef typename remove_all<Lhs>::type::Scalar Scalar;
+  Index rows = lhs.innerSize();
+  Index cols = rhs.outerSize();
+  eigen_assert(lhs.outerSize() == rhs.innerSize());
+  eigen_assert(res.innerSize() == rows && res.outerSize() == cols);
+
+  evaluator<Lhs> lhsEval(lhs);
+  evaluator<Rhs> rhsEval(rhs);
+
+  Eigen::initParallel();
+  const Index chunk = (std::max)(Index(1), (cols+threads*4-1)/(threads*4));
+
+  // one dense accumulator per thread
+  Matrix<Index,Dynamic,Dynamic> masks(rows, threads);
+  Matrix<Scalar,Dynamic,Dynamic> values(rows, threads);
+  masks.setConstant(-1);
+
+  res.setZero();
+  res.makeCompressed();
+  ResStorageIndex* outer = res.outerIndexPtr();
+
+  // symbolic phase
+  #pragma omp parallel for schedule(dynamic,chunk) num_threads(threads)
+  for(Index j=0; j<cols; ++j)
+    outer[j+1] = convert_index<ResStorageIndex>(sparse_sparse_product_column_nnz(lhsEval, rhsEval, j, &masks.coeffRef(0,omp_get_thread_num())));
+
+  for(Index j=0; j<cols; ++j)
+    outer[j+1] += outer[j];
+  res.resizeNonZeros(outer[cols]);
+  masks.setConstant(-1);
+
+  // numeric phase
+  ResStorageIndex* inner = res.innerIndexPtr();
+  ResScalar* resValues = res.valuePtr();
+  #pragma omp parallel for schedule(dynamic,chunk) num_threads(threads)
+  for(Index j=0; j<cols; ++j)
+  {
+    Index t = omp_get_thread_num();
+    Scalar* acc = &values.coeffRef(0,t);
+    sparse_sparse_product_column(lhsEval, rhsEval, j, &masks.coeffRef(0,t), acc, inner+outer[j]);
+    std::sort(inner+outer[j], inner+outer[j+1]);
+    for(Index p=outer[j]; p<outer[j+1]; ++p)
+      resValues[p] = acc[inner[p]];
+  }
+  return true;
+#else
+  EIGEN_UNUSED_VARIABLE(res);
+  return false;
+#endif
+}
+
+/** \internal Recomputes the values of lhs*rhs into \a res, whose structure is kept.
+  *
+  * This is the numeric phase of the product only, which is useful when lhs and rhs keep the same sparsity pattern.
+  * \a res must be compressed, and its structure must contain the one of lhs*rhs, as computed by a previous
+  * product. Coefficients of the product which are not in the structure of \a res are ignored, and the
+  * entries of \a res which are not in the product are set to zero.
+  */
+template<typename Lhs, typename Rhs, typename ResultType>
+void conservative_sparse_sparse_product_numeric(const Lhs& lhs, const Rhs& rhs, ResultType& res)
+{
+  typedef typename remove_all<Lhs>::type::Scalar Scalar;
+  typedef typename ResultType::StorageIndex ResStorageIndex;
+
+  Index rows = lhs.innerSize();
+  Index cols = rhs.outerSize();
+  eigen_assert(lhs.outerSize() == rhs.innerSize());
+  eigen_assert(res.innerSize() == rows && res.outerSize() == cols && res.isCompressed());
+
+  evaluator<Lhs> lhsEval(lhs);
+  evaluator<Rhs> rhsEval(rhs);
+
+  const Index threads = conservative_sparse_sparse_product_threads(lhs, rhs);
+  Matrix<Index,Dynamic,Dynamic> masks(rows, threads);
+  Matrix<Scalar,Dynamic,Dynamic> values(rows, threads);
+  masks.setConstant(-1);
+
+  const ResStorageIndex* outer = res.outerIndexPtr();
+  const ResStorageIndex* inner = res.innerIndexPtr();
+  typename ResultType::Scalar* resValues = res.valuePtr();
+
+#ifdef EIGEN_HAS_OPENMP
+  Eigen::initParallel();
+  const Index chunk = (std::max)(Index(1), (cols+threads*4-1)/(threads*4));
+  #pragma omp parallel for schedule(dynamic,chunk) num_threads(threads) if(threads>1)
+#endif
+  for(Index j=0; j<cols; ++j)
+  {
+#ifdef EIGEN_HAS_OPENMP
+    Index t = omp_get_thread_num();
+#else
+    Index t = 0;
+#endif
+    Index* mask = &masks.coeffRef(0,t);
+    Scalar* acc = &values.coeffRef(0,t);
+    sparse_sparse_product_column(lhsEval, rhsEval, j, mask, acc, static_cast<ResStorageIndex*>(0));
+    for(Index p=outer[j]; p<outer[j+1]; ++p)
+    {
+      Index i = inner[p];
+      resValues[p] = mask[i]==j ? acc[i] : Scalar(0);
+    }
+  }
+}
+
 template<typename Lhs, typename Rhs, typename ResultType>
 static void conservative_sparse_sparse_product_impl(const Lhs& lhs, const Rhs& rhs, ResultType& res, bool sortedInsertion = false)
 {
@@ -23,7 +216,11 @@ static void conservative_sparse_sparse_product_impl(const Lhs& lhs, const Rhs& r
   Index rows = lhs.innerSize();
   Index cols = rhs.outerSize();
   eigen_assert(lhs.outerSize() == rhs.innerSize());
-  
+
+  // large products are computed in parallel, with sorted inner indices
+  if(conservative_sparse_sparse_product_parallel(lhs, rhs, res))
+    return;
+
   ei_declare_aligned_stack_constructed_variable(bool,   mask,     rows, 0);
   ei_declare_aligned_stack_constructed_variable(Scalar, values,   rows, 0);
   ei_declare_aligned_stack_constructed_variable(Index,  indices,  rows, 0);
@@ -140,10 +337,10 @@ struct conservative_sparse_sparse_product_selector<Lhs,Rhs,ResultType,ColMajor,C
     typedef SparseMatrix<typename ResultType::Scalar,ColMajor,typename ResultType::StorageIndex> ColMajorMatrixAux;
     typedef typename sparse_eval<ColMajorMatrixAux,ResultType::RowsAtCompileTime,ResultType::ColsAtCompileTime,ColMajorMatrixAux::Flags>::type ColMajorMatrix;
     
-    // If the result is tall and thin (in the extreme case a column vector)
-    // then it is faster to sort the coefficients inplace instead of transposing twice.
+    // If the result is tall and thin (in the extreme case a column vector), or if the product is
+    // multi-threaded, then it is faster to sort the coefficients inplace instead of transposing twice.
     // FIXME, the following heuristic is probably not very good.
-    if(lhs.rows()>rhs.cols())
+    if(lhs.rows()>rhs.cols() || conservative_sparse_sparse_product_threads(lhs, rhs)>1)
     {
       ColMajorMatrix resCol(lhs.rows(),rhs.cols());
       // perform sorted insertion
@@ -916,12 +916,182 @@ private:
 
 namespace internal {
 
+#ifdef EIGEN_HAS_OPENMP
+
+/** \internal Turns the per-chunk counts \a hist(k,t) of the buckets k into the positions of the first element of each
+  * (bucket, chunk) pair of a stable bucket sort, and stores the position of the first element of each bucket into \a bucketStart */
+template<typename IndexMatrix, typename IndexVector>
+void set_from_triplets_bucket_offsets(IndexMatrix& hist, IndexVector& bucketStart, Index threads)
+{
+  const Index buckets = hist.rows();
+  const Index chunks = hist.cols();
+  Matrix<Index,Dynamic,1> blockStart(threads+1);
+  blockStart(0) = 0;
+
+  // parallel prefix sum over contiguous blocks of buckets
+  #pragma omp parallel for schedule(static,1) num_threads(threads)
+  for(Index b=0; b<threads; ++b)
+  {
+    Index sum = 0;
+    for(Index k=b*buckets/threads; k<(b+1)*buckets/threads; ++k)
+      for(Index t=0; t<chunks; ++t)
+        sum += hist(k,t);
+    blockStart(b+1) = sum;
+  }
+  for(Index b=0; b<threads; ++b)
+    blockStart(b+1) += blockStart(b);
+
+  #pragma omp parallel for schedule(static,1) num_threads(threads)
+  for(Index b=0; b<threads; ++b)
+  {
+    Index pos = blockStart(b);
+    for(Index k=b*buckets/threads; k<(b+1)*buckets/threads; ++k)
+    {
+      bucketStart(k) = pos;
+      for(Index t=0; t<chunks; ++t)
+      {
+        Index count = hist(k,t);
+        hist(k,t) = pos;
+        pos += count;
+      }
+    }
+  }
+  bucketStart(buckets) = blockStart(threads);
+}
+
+template<typename InputIterator, typename SparseMatrixType, typename DupFunctor, typename IteratorCategory>
+bool set_from_triplets_parallel(const InputIterator&, const InputIterator&, SparseMatrixType&, DupFunctor, IteratorCategory)
+{
+  return false;
+}
+
+/** \internal Multi-threaded assembly of a sparse matrix from a random access range of triplets.
+  *
+  * The triplets are sorted by a two pass radix sort, first on their inner index then on their outer index.
+  * Each pass is a stable bucket sort made of a per-thread histogram of the buckets, a parallel prefix sum of the
+  * histograms, and a parallel scatter. The duplicates, which are then consecutive and in the order of the input,
+  * are combined with \a dup_func and the result is directly written in compressed form, without any transposition.
+  */
+template<typename InputIterator, typename SparseMatrixType, typename DupFunctor>
+bool set_from_triplets_parallel(const InputIterator& begin, const InputIterator& end, SparseMatrixType& mat, DupFunctor dup_func,
+                                std::random_access_iterator_tag)
+{
+  enum { IsRowMajor = SparseMatrixType::IsRowMajor };
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::StorageIndex StorageIndex;
+  typedef Matrix<StorageIndex,Dynamic,1> StorageIndexVector;
+  typedef Matrix<Index,Dynamic,1> IndexVector;
+  typedef Matrix<Index,Dynamic,Dynamic> IndexMatrix;
+
+  const Index n = end - begin;
+  Index threads = Eigen::nbThreads();
+  // this threshold represents the minimal amount of work to be done to be worth it
+  if(threads==1 || n<20000 || omp_get_num_threads()>1)
+    return false;
+  threads = (std::min)(threads, n/10000);
+  Eigen::initParallel();
+
+  const Index outerSize = mat.outerSize();
+  const Index innerSize = mat.innerSize();
+  StorageIndexVector sortedOuter(n), sortedInner(n), inner(n);
+  Matrix<Scalar,Dynamic,1> sortedValues(n), values(n);
+
+  // pass 1: stable bucket sort of the triplets on their inner index
+  IndexMatrix hist = IndexMatrix::Zero(innerSize, threads);
+  IndexVector bucketStart(innerSize+1);
+  #pragma omp parallel for schedule(static,1) num_threads(threads)
+  for(Index t=0; t<threads; ++t)
+  {
+    for(InputIterator it = begin + t*n/threads; it!=begin + (t+1)*n/threads; ++it)
+    {
+      eigen_assert(it->row()>=0 && it->row()<mat.rows() && it->col()>=0 && it->col()<mat.cols());
+      ++hist(IsRowMajor ? it->col() : it->row(), t);
+    }
+  }
+  set_from_triplets_bucket_offsets(hist, bucketStart, threads);
+  #pragma omp parallel for schedule(static,1) num_threads(threads)
+  for(Index t=0; t<threads; ++t)
+  {
+    for(InputIterator it = begin + t*n/threads; it!=begin + (t+1)*n/threads; ++it)
+    {
+      Index pos = hist(IsRowMajor ? it->col() : it->row(), t)++;
+      sortedOuter(pos) = convert_index<StorageIndex>(IsRowMajor ? it->row() : it->col());
+      sortedInner(pos) = convert_index<StorageIndex>(IsRowMajor ? it->col() : it->row());
+      sortedValues(pos) = it->value();
+    }
+  }
+
+  // pass 2: stable bucket sort on the outer index
+  hist.setZero(outerSize, threads);
+  bucketStart.resize(outerSize+1);
+  #pragma omp parallel for schedule(static,1) num_threads(threads)
+  for(Index t=0; t<threads; ++t)
+    for(Index k=t*n/threads; k<(t+1)*n/threads; ++k)
+      ++hist(sortedOuter(k), t);
+  set_from_triplets_bucket_offsets(hist, bucketStart, threads);
+  #pragma omp parallel for schedule(static,1) num_threads(threads)
+  for(Index t=0; t<threads; ++t)
+  {
+    for(Index k=t*n/threads; k<(t+1)*n/threads; ++k)
+    {
+      Index pos = hist(sortedOuter(k), t)++;
+      inner(pos) = sortedInner(k);
+      values(pos) = sortedValues(k);
+    }
+  }
+
+  // pass 3: combine the duplicates in place, they are now consecutive
+  IndexVector nonZeros(outerSize);
+  #pragma omp parallel for schedule(static) num_threads(threads)
+  for(Index j=0; j<outerSize; ++j)
+  {
+    Index start = bucketStart(j), count = start;
+    for(Index k=start; k<bucketStart(j+1); ++k)
+    {
+      if(count>start && inner(count-1)==inner(k))
+        values(count-1) = dup_func(values(count-1), values(k));
+      else
+      {
+        inner(count) = inner(k);
+        values(count) = values(k);
+        ++count;
+      }
+    }
+    nonZeros(j) = count-start;
+  }
+
+  // pass 4: copy to the compressed storage of mat
+  mat.setZero();
+  mat.makeCompressed();
+  StorageIndex* outerIndex = mat.outerIndexPtr();
+  for(Index j=0; j<outerSize; ++j)
+    outerIndex[j+1] = convert_index<StorageIndex>(outerIndex[j] + nonZeros(j));
+  mat.resizeNonZeros(outerIndex[outerSize]);
+  StorageIndex* innerIndex = mat.innerIndexPtr();
+  Scalar* valuePtr = mat.valuePtr();
+  #pragma omp parallel for schedule(static) num_threads(threads)
+  for(Index j=0; j<outerSize; ++j)
+  {
+    std::copy(inner.data()+bucketStart(j), inner.data()+bucketStart(j)+nonZeros(j), innerIndex+outerIndex[j]);
+    std::copy(values.data()+bucketStart(j), values.data()+bucketStart(j)+nonZeros(j), valuePtr+outerIndex[j]);
+  }
+  return true;
+}
+
+#endif // EIGEN_HAS_OPENMP
+
 template<typename InputIterator, typename SparseMatrixType, typename DupFunctor>
 void set_from_triplets(const InputIterator& begin, const InputIterator& end, SparseMatrixType& mat, DupFunctor dup_func)
 {
   enum { IsRowMajor = SparseMatrixType::IsRowMajor };
   typedef typename SparseMatrixType::Scalar Scalar;
   typedef typename SparseMatrixType::StorageIndex StorageIndex;
+
+#ifdef EIGEN_HAS_OPENMP
+  if(set_from_triplets_parallel(begin, end, mat, dup_func, typename std::iterator_traits<InputIterator>::iterator_category()))
+    return;
+#endif
+
   SparseMatrix<Scalar,IsRowMajor?ColMajor:RowMajor,StorageIndex> trMat(mat.rows(),mat.cols());
 
   if(begin!=end)
@@ -987,6 +1157,9 @@ void set_from_triplets(const InputIterator& begin, const InputIterator& end, Spa
   * \warning The list of triplets is read multiple times (at least twice). Therefore, it is not recommended to define
   * an abstract iterator over a complex data-structure that would be expensive to evaluate. The triplets should rather
   * be explicitely stored into a std::vector for instance.
+  *
+  * When OpenMP is enabled and the iterators are random access iterators, large lists of triplets are assembled
+  * in parallel, see Eigen::setNbThreads(). The result does not depend on the number of threads.
   */
 template<typename Scalar, int _Options, typename _StorageIndex>
 template<typename InputIterators>
@@ -0,0 +1,400 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_PATTERN_PLAN_H
+#define EIGEN_SPARSE_PATTERN_PLAN_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal \returns the number of threads to use for a loop of \a size simple iterations */
+inline Index sparse_pattern_plan_threads(Index size)
+{
+#ifdef EIGEN_HAS_OPENMP
+  // As for sparse*dense products, this threshold represents the minimal amount of work to be done to be worth it.
+  if(size > 20000 && omp_get_num_threads()==1)
+    return Eigen::nbThreads();
+#else
+  EIGEN_UNUSED_VARIABLE(size);
+#endif
+  return 1;
+}
+
+} // end namespace internal
+
+/** \ingroup SparseCore_Module
+  *
+  * \class TripletAssemblyPlan
+  *
+  * \brief Records how a list of triplets is assembled into a sparse matrix, to assemble new values quickly
+  *
+  * \tparam _SparseMatrixType the type of the assembled SparseMatrix
+  *
+  * When a sparse matrix is repeatedly assembled from triplets having the same row and column indices
+  * but different values, as the Jacobian matrices of Newton iterations, SparseMatrix::setFromTriplets()
+  * recomputes the same structure every time. This class computes it once, in analyzePattern(), and records
+  * for each non zero of the matrix the list of triplets summed into it. Afterwards, computeValues() only rewrites
+  * the values of the matrix, in a single parallel pass.
+  *
+  * \code
+  * std::vector<Triplet<double> > triplets = ...;
+  * SparseMatrix<double> A(rows,cols);
+  * TripletAssemblyPlan<SparseMatrix<double> > plan;
+  * plan.analyzePattern(triplets.begin(), triplets.end(), A);  // same as A.setFromTriplets(...)
+  * for(...)
+  * {
+  *   // update the values of the triplets, keeping their indices
+  *   plan.computeValues(triplets.begin(), triplets.end(), A);
+  * }
+  * \endcode
+  *
+  * \sa SparseMatrix::setFromTriplets(), class SparseProductPlan
+  */
+template<typename _SparseMatrixType>
+class TripletAssemblyPlan
+{
+  public:
+    typedef _SparseMatrixType SparseMatrixType;
+    typedef typename SparseMatrixType::Scalar Scalar;
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+
+    TripletAssemblyPlan() : m_isInitialized(false) {}
+
+    /** Assembles the triplets of the range \a begin - \a end into \a mat, as SparseMatrix::setFromTriplets() does,
+      * and records the structure of the assembly.
+      * \a mat must be properly resized beforehand. */
+    template<typename InputIterators>
+    void analyzePattern(const InputIterators& begin, const InputIterators& end, SparseMatrixType& mat);
+
+    /** Rewrites the values of \a mat with the values of the triplets of the range \a begin - \a end,
+      * the duplicates being summed up.
+      * The triplets must have the same indices, in the same order, as those passed to analyzePattern(),
+      * and the structure of \a mat must not have been modified since. */
+    template<typename InputIterators>
+    void computeValues(const InputIterators& begin, const InputIterators& end, SparseMatrixType& mat) const
+    {
+      computeValues(begin, end, mat, internal::scalar_sum_op<Scalar,Scalar>());
+    }
+
+    /** The same as computeValues(const InputIterators&, const InputIterators&, SparseMatrixType&) but when duplicates
+      * are met the functor \a dup_func is applied, as in SparseMatrix::setFromTriplets(). */
+    template<typename InputIterators, typename DupFunctor>
+    void computeValues(const InputIterators& begin, const InputIterators& end, SparseMatrixType& mat, DupFunctor dup_func) const
+    {
+      Matrix<Scalar,Dynamic,1> values(m_perm.size());
+      Index k = 0;
+      for(InputIterators it(begin); it!=end; ++it, ++k)
+      {
+        eigen_assert(k<m_perm.size() && "computeValues(): the number of triplets differs from analyzePattern()");
+        values.coeffRef(k) = it->value();
+      }
+      eigen_assert(k==m_perm.size() && "computeValues(): the number of triplets differs from analyzePattern()");
+      computeValues(values.data(), mat, dup_func);
+    }
+
+    /** Rewrites the values of \a mat given the array \a values of the values of the triplets, in the order
+      * of the triplets passed to analyzePattern(). Duplicates are combined with \a dup_func. */
+    template<typename DupFunctor>
+    void computeValues(const Scalar* values, SparseMatrixType& mat, DupFunctor dup_func) const;
+
+    /** \returns the number of triplets of the recorded assembly */
+    Index triplets() const { return m_perm.size(); }
+
+  protected:
+    IndexVector m_perm;       // the triplet ids sorted by outer then inner index, keeping the order of duplicates
+    IndexVector m_slotStart;  // the triplets of the k-th non zero are m_perm[m_slotStart[k] : m_slotStart[k+1]]
+    bool m_isInitialized;
+};
+
+template<typename SparseMatrixType>
+template<typename InputIterators>
+void TripletAssemblyPlan<SparseMatrixType>::analyzePattern(const InputIterators& begin, const InputIterators& end, SparseMatrixType& mat)
+{
+  enum { IsRowMajor = SparseMatrixType::IsRowMajor };
+  const Index outerSize = mat.outerSize();
+  const Index innerSize = mat.innerSize();
+
+  Index n = 0;
+  for(InputIterators it(begin); it!=end; ++it)
+    ++n;
+
+  // pass 1: record the indices of the triplets, and count them per inner and outer index
+  IndexVector outer(n), inner(n);
+  IndexVector innerStart = IndexVector::Zero(innerSize+1);
+  IndexVector outerStart = IndexVector::Zero(outerSize+1);
+  Matrix<Scalar,Dynamic,1> values(n);
+  Index k = 0;
+  for(InputIterators it(begin); it!=end; ++it, ++k)
+  {
+    eigen_assert(it->row()>=0 && it->row()<mat.rows() && it->col()>=0 && it->col()<mat.cols());
+    outer.coeffRef(k) = IsRowMajor ? it->row() : it->col();
+    inner.coeffRef(k) = IsRowMajor ? it->col() : it->row();
+    values.coeffRef(k) = it->value();
+    ++innerStart.coeffRef(inner.coeff(k)+1);
+    ++outerStart.coeffRef(outer.coeff(k)+1);
+  }
+  for(Index i=0; i<innerSize; ++i)
+    innerStart.coeffRef(i+1) += innerStart.coeff(i);
+  for(Index j=0; j<outerSize; ++j)
+    outerStart.coeffRef(j+1) += outerStart.coeff(j);
+
+  // pass 2: stable bucket sorts on the inner, then on the outer indices
+  IndexVector byInner(n);
+  for(k=0; k<n; ++k)
+    byInner.coeffRef(innerStart.coeffRef(inner.coeff(k))++) = k;
+  m_perm.resize(n);
+  for(Index q=0; q<n; ++q)
+  {
+    Index id = byInner.coeff(q);
+    m_perm.coeffRef(outerStart.coeffRef(outer.coeff(id))++) = id;
+  }
+
+  // pass 3: merge the duplicates into the non zeros of mat
+  Index nnz = 0;
+  for(Index q=0; q<n; ++q)
+    if(q==0 || outer.coeff(m_perm.coeff(q))!=outer.coeff(m_perm.coeff(q-1)) || inner.coeff(m_perm.coeff(q))!=inner.coeff(m_perm.coeff(q-1)))
+      ++nnz;
+  m_slotStart.resize(nnz+1);
+
+  mat.setZero();
+  mat.makeCompressed();
+  mat.resizeNonZeros(nnz);
+  StorageIndex* outerIndex = mat.outerIndexPtr();
+  StorageIndex* innerIndex = mat.innerIndexPtr();
+  Index s = -1;
+  for(Index q=0; q<n; ++q)
+  {
+    Index id = m_perm.coeff(q);
+    if(q==0 || outer.coeff(id)!=outer.coeff(m_perm.coeff(q-1)) || inner.coeff(id)!=inner.coeff(m_perm.coeff(q-1)))
+    {
+      ++s;
+      m_slotStart.coeffRef(s) = q;
+      innerIndex[s] = internal::convert_index<StorageIndex>(inner.coeff(id));
+      ++outerIndex[outer.coeff(id)+1];
+    }
+  }
+  m_slotStart.coeffRef(nnz) = n;
+  for(Index j=0; j<outerSize; ++j)
+    outerIndex[j+1] += outerIndex[j];
+
+  m_isInitialized = true;
+  computeValues(values.data(), mat, internal::scalar_sum_op<Scalar,Scalar>());
+}
+
+template<typename SparseMatrixType>
+template<typename DupFunctor>
+void TripletAssemblyPlan<SparseMatrixType>::computeValues(const Scalar* values, SparseMatrixType& mat, DupFunctor dup_func) const
+{
+  eigen_assert(m_isInitialized && "TripletAssemblyPlan is not initialized.");
+  const Index nnz = m_slotStart.size()-1;
+  eigen_assert(mat.isCompressed() && mat.nonZeros()==nnz && "computeValues(): the structure of the matrix has changed");
+
+  Scalar* dst = mat.valuePtr();
+  const Index* perm = m_perm.data();
+  const Index* slotStart = m_slotStart.data();
+#ifdef EIGEN_HAS_OPENMP
+  Index threads = internal::sparse_pattern_plan_threads(m_perm.size());
+  #pragma omp parallel for schedule(static) num_threads(threads) if(threads>1)
+#endif
+  for(Index s=0; s<nnz; ++s)
+  {
+    Index q = slotStart[s];
+    Scalar v = values[perm[q]];
+    for(++q; q<slotStart[s+1]; ++q)
+      v = dup_func(v, values[perm[q]]);
+    dst[s] = v;
+  }
+}
+
+/** \ingroup SparseCore_Module
+  *
+  * \class SparseProductPlan
+  *
+  * \brief Records the structure of a sparse matrix product, to recompute it quickly for new values
+  *
+  * \tparam _SparseMatrixType the type of the SparseMatrix receiving the product
+  *
+  * When products of sparse matrices having fixed sparsity patterns are evaluated repeatedly, the symbolic
+  * part of the product, that is the computation of the structure of the result, is the same every time.
+  * analyzePattern() computes the product once and records, for each pair of non zeros of the operands
+  * contributing to the result, the position of the target coefficient in the result. Afterwards,
+  * computeValues() recomputes the product by scattering the products of the pairs of coefficients,
+  * without any search nor any temporary, the columns of the result being computed in parallel.
+  *
+  * The operands must be sparse matrices with the same storage order as the result.
+  *
+  * \code
+  * SparseMatrix<double> A = ..., P = ..., AP;
+  * SparseProductPlan<SparseMatrix<double> > plan;
+  * plan.analyzePattern(A, P, AP);  // same as AP = A*P
+  * for(...)
+  * {
+  *   // update the values of A and P, keeping their structure
+  *   plan.computeValues(A, P, AP);
+  * }
+  * \endcode
+  *
+  * \warning The map of the contributions has one entry per multiplication performed by the product, which can
+  *          be much larger than the number of non zeros of the result.
+  *
+  * \sa class TripletAssemblyPlan
+  */
+template<typename _SparseMatrixType>
+class SparseProductPlan
+{
+  public:
+    typedef _SparseMatrixType SparseMatrixType;
+    typedef typename SparseMatrixType::Scalar Scalar;
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+    typedef Matrix<StorageIndex,Dynamic,1> StorageIndexVector;
+    enum { IsRowMajor = SparseMatrixType::IsRowMajor };
+
+    SparseProductPlan() : m_isInitialized(false) {}
+
+    /** Computes \a res = \a lhs * \a rhs and records the structure of the product */
+    template<typename Lhs, typename Rhs>
+    void analyzePattern(const SparseMatrixBase<Lhs>& lhs, const SparseMatrixBase<Rhs>& rhs, SparseMatrixType& res)
+    {
+      check_operands<Lhs,Rhs>();
+      eigen_assert(lhs.cols()==rhs.rows());
+      res.resize(lhs.rows(), rhs.cols());
+      // in the row-major case, the product is computed as res^T = rhs^T * lhs^T
+      if(IsRowMajor) analyze(rhs.derived(), lhs.derived(), res);
+      else           analyze(lhs.derived(), rhs.derived(), res);
+    }
+
+    /** Recomputes the values of \a res = \a lhs * \a rhs. The operands must have the same structure as those
+      * passed to analyzePattern(), and the structure of \a res must not have been modified since. */
+    template<typename Lhs, typename Rhs>
+    void computeValues(const SparseMatrixBase<Lhs>& lhs, const SparseMatrixBase<Rhs>& rhs, SparseMatrixType& res) const
+    {
+      check_operands<Lhs,Rhs>();
+      eigen_assert(m_isInitialized && "SparseProductPlan is not initialized.");
+      eigen_assert(res.isCompressed() && res.rows()==lhs.rows() && res.cols()==rhs.cols() && res.nonZeros()==m_nonZeros
+                   && "computeValues(): the structure of the result has changed");
+      if(IsRowMajor) compute(rhs.derived(), lhs.derived(), res);
+      else           compute(lhs.derived(), rhs.derived(), res);
+    }
+
+  protected:
+
+    template<typename Lhs, typename Rhs>
+    static void check_operands()
+    {
+      EIGEN_STATIC_ASSERT((int(Lhs::Flags&RowMajorBit)==int(SparseMatrixType::Flags&RowMajorBit)
+                           && int(Rhs::Flags&RowMajorBit)==int(SparseMatrixType::Flags&RowMajorBit)),
+                          THE_STORAGE_ORDER_OF_BOTH_SIDES_MUST_MATCH);
+    }
+
+    template<typename Lhs, typename Rhs>
+    void analyze(const Lhs& lhs, const Rhs& rhs, SparseMatrixType& res);
+
+    template<typename Lhs, typename Rhs>
+    void compute(const Lhs& lhs, const Rhs& rhs, SparseMatrixType& res) const;
+
+    IndexVector m_outerStart;        // the contributions to the j-th outer vector are m_scatter[m_outerStart[j] : m_outerStart[j+1]]
+    StorageIndexVector m_scatter;    // for each contribution, in order of evaluation, the position of its target in the result
+    Index m_nonZeros;
+    bool m_isInitialized;
+};
+
+template<typename SparseMatrixType>
+template<typename Lhs, typename Rhs>
+void SparseProductPlan<SparseMatrixType>::analyze(const Lhs& lhs, const Rhs& rhs, SparseMatrixType& res)
+{
+  typedef internal::evaluator<Lhs> LhsEval;
+  typedef internal::evaluator<Rhs> RhsEval;
+  const Index inner = lhs.innerSize();
+  const Index outer = rhs.outerSize();
+
+  // the structure of the result, with sorted inner indices
+  internal::conservative_sparse_sparse_product_impl(lhs, rhs, res, true);
+  m_nonZeros = res.nonZeros();
+
+  LhsEval lhsEval(lhs);
+  RhsEval rhsEval(rhs);
+
+  // count the contributions to each outer vector
+  m_outerStart.resize(outer+1);
+  m_outerStart.coeffRef(0) = 0;
+  for(Index j=0; j<outer; ++j)
+  {
+    Index count = 0;
+    for(typename RhsEval::InnerIterator rhsIt(rhsEval, j); rhsIt; ++rhsIt)
+      for(typename LhsEval::InnerIterator lhsIt(lhsEval, rhsIt.index()); lhsIt; ++lhsIt)
+        ++count;
+    m_outerStart.coeffRef(j+1) = m_outerStart.coeff(j) + count;
+  }
+  m_scatter.resize(m_outerStart.coeff(outer));
+
+  // record the targets of the contributions
+  const Index threads = internal::conservative_sparse_sparse_product_threads(lhs, rhs);
+  Matrix<Index,Dynamic,Dynamic> positions(inner, threads);
+  const StorageIndex* resOuter = res.outerIndexPtr();
+  const StorageIndex* resInner = res.innerIndexPtr();
+#ifdef EIGEN_HAS_OPENMP
+  const Index chunk = (std::max)(Index(1), (outer+threads*4-1)/(threads*4));
+  #pragma omp parallel for schedule(dynamic,chunk) num_threads(threads) if(threads>1)
+#endif
+  for(Index j=0; j<outer; ++j)
+  {
+#ifdef EIGEN_HAS_OPENMP
+    Index* pos = &positions.coeffRef(0,omp_get_thread_num());
+#else
+    Index* pos = &positions.coeffRef(0,0);
+#endif
+    for(Index p=resOuter[j]; p<resOuter[j+1]; ++p)
+      pos[resInner[p]] = p;
+    Index q = m_outerStart.coeff(j);
+    for(typename RhsEval::InnerIterator rhsIt(rhsEval, j); rhsIt; ++rhsIt)
+      for(typename LhsEval::InnerIterator lhsIt(lhsEval, rhsIt.index()); lhsIt; ++lhsIt)
+        m_scatter.coeffRef(q++) = internal::convert_index<StorageIndex>(pos[lhsIt.index()]);
+  }
+  m_isInitialized = true;
+}
+
+template<typename SparseMatrixType>
+template<typename Lhs, typename Rhs>
+void SparseProductPlan<SparseMatrixType>::compute(const Lhs& lhs, const Rhs& rhs, SparseMatrixType& res) const
+{
+  typedef internal::evaluator<Lhs> LhsEval;
+  typedef internal::evaluator<Rhs> RhsEval;
+  const Index outer = rhs.outerSize();
+  eigen_assert(outer+1==m_outerStart.size());
+
+  LhsEval lhsEval(lhs);
+  RhsEval rhsEval(rhs);
+  const StorageIndex* resOuter = res.outerIndexPtr();
+  const StorageIndex* scatter = m_scatter.data();
+  Scalar* values = res.valuePtr();
+
+#ifdef EIGEN_HAS_OPENMP
+  const Index threads = internal::conservative_sparse_sparse_product_threads(lhs, rhs);
+  const Index chunk = (std::max)(Index(1), (outer+threads*4-1)/(threads*4));
+  #pragma omp parallel for schedule(dynamic,chunk) num_threads(threads) if(threads>1)
+#endif
+  for(Index j=0; j<outer; ++j)
+  {
+    for(Index p=resOuter[j]; p<resOuter[j+1]; ++p)
+      values[p] = Scalar(0);
+    Index q = m_outerStart.coeff(j);
+    for(typename RhsEval::InnerIterator rhsIt(rhsEval, j); rhsIt; ++rhsIt)
+    {
+      Scalar y = rhsIt.value();
+      for(typename LhsEval::InnerIterator lhsIt(lhsEval, rhsIt.index()); lhsIt; ++lhsIt)
+        values[scatter[q++]] += lhsIt.value() * y;
+    }
+    eigen_assert(q==m_outerStart.coeff(j+1) && "computeValues(): the structure of the operands has changed");
+  }
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_PATTERN_PLAN_H
@@ -0,0 +1,253 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TRIANGULAR_SOLVE_PLAN_H
+#define EIGEN_TRIANGULAR_SOLVE_PLAN_H
+
+namespace Eigen {
+
+/** \ingroup SparseCore_Module
+  *
+  * \class TriangularSolvePlan
+  *
+  * \brief Level schedule of a sparse triangular matrix, to solve triangular systems in parallel
+  *
+  * \tparam _SparseMatrixType the type of the compressed SparseMatrix holding the triangular factor
+  *
+  * The substitutions performed by TriangularView::solveInPlace() are inherently sequential: each unknown depends
+  * on the previous ones. However, the unknowns which do not depend on each other can be computed simultaneously.
+  * analyzePattern() groups the unknowns into levels, the unknowns of a level depending only on the unknowns of the
+  * previous levels, and records the rows and the columns of the triangular part as lists of positions in the
+  * arrays of the matrix. The solving methods then process the levels one after the other, the unknowns of each
+  * level being computed in parallel when OpenMP is enabled.
+  *
+  * The synchronizations between the levels only pay off for large systems with wide enough levels. Otherwise, the
+  * solving methods return false without modifying the right hand side, such that the caller falls back to the
+  * sequential substitutions of TriangularView::solveInPlace(), which are faster in that case.
+  *
+  * The plan only depends on the pattern of the matrix: it remains valid as long as the structure of the matrix is not
+  * modified, whatever its values. The same plan serves for the triangular part of the matrix, and for its transpose
+  * and its adjoint, such that the solving phases of a Cholesky factorization only need one plan:
+  * \code
+  * SparseMatrix<double> L = ...;  // lower triangular and compressed
+  * TriangularSolvePlan<SparseMatrix<double> > plan;
+  * if(TriangularSolvePlan<SparseMatrix<double> >::worthAnalyzing(L))
+  *   plan.analyzePattern(L, Lower);
+  * // same as L.triangularView<Lower>().solveInPlace(x), in parallel when it is worth it
+  * if(plan.rows()!=L.rows() || !plan.solveInPlace(L, x))
+  *   L.triangularView<Lower>().solveInPlace(x);
+  * // same as L.adjoint().triangularView<Upper>().solveInPlace(x)
+  * if(plan.rows()!=L.rows() || !plan.adjointSolveInPlace(L, x))
+  *   L.adjoint().triangularView<Upper>().solveInPlace(x);
+  * \endcode
+  *
+  * Only the coefficients of the triangular part selected by the mode are used: the others are ignored, as are the
+  * diagonal coefficients when the mode includes \c UnitDiag.
+  *
+  * \sa TriangularView::solveInPlace()
+  */
+template<typename _SparseMatrixType>
+class TriangularSolvePlan
+{
+  public:
+    typedef _SparseMatrixType SparseMatrixType;
+    typedef typename SparseMatrixType::Scalar Scalar;
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+    typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+
+    TriangularSolvePlan() : m_mode(Lower) {}
+
+    /** Computes the level schedule of the triangular part of \a mat selected by \a mode,
+      * which is either \c Lower, \c Upper, \c UnitLower or \c UnitUpper.
+      * \a mat must be square and compressed. */
+    void analyzePattern(const SparseMatrixType& mat, int mode);
+
+    /** \returns whether the plan of \a mat could be solved in parallel with the current number of threads, i.e.,
+      * whether it is worth calling analyzePattern(). This is always false when OpenMP is disabled. */
+    static bool worthAnalyzing(const SparseMatrixType& mat)
+    {
+#ifdef EIGEN_HAS_OPENMP
+      // each level must be wide enough for the threads, see solve()
+      const Index threads = Eigen::nbThreads();
+      return threads>1 && mat.rows() >= 4*threads;
+#else
+      EIGEN_UNUSED_VARIABLE(mat);
+      return false;
+#endif
+    }
+
+    /** \returns the number of rows of the analyzed matrix */
+    Index rows() const { return m_diag.size(); }
+
+    /** \returns the number of levels of the schedule, i.e., the length of the longest chain of dependencies */
+    Index levels() const { return m_levelStart.size()>0 ? m_levelStart.size()-1 : 0; }
+
+    /** Solves in place \c mat.triangularView<Mode>() \a x = \a x, Mode being the mode passed to analyzePattern()
+      * \returns true if the system was solved in parallel, and false if this is not worth it, in which case \a x is
+      * left unchanged */
+    template<typename Dest>
+    bool solveInPlace(const SparseMatrixType& mat, MatrixBase<Dest>& x) const
+    { return solve<false,false>(mat, x.derived()); }
+
+    /** Solves in place \c mat.transpose().triangularView<Mode'>() \a x = \a x, Mode' being the transposed
+      * of the mode passed to analyzePattern()
+      * \returns true if the system was solved in parallel, and false if this is not worth it, in which case \a x is
+      * left unchanged */
+    template<typename Dest>
+    bool transposeSolveInPlace(const SparseMatrixType& mat, MatrixBase<Dest>& x) const
+    { return solve<true,false>(mat, x.derived()); }
+
+    /** Solves in place \c mat.adjoint().triangularView<Mode'>() \a x = \a x, Mode' being the transposed
+      * of the mode passed to analyzePattern()
+      * \returns true if the system was solved in parallel, and false if this is not worth it, in which case \a x is
+      * left unchanged */
+    template<typename Dest>
+    bool adjointSolveInPlace(const SparseMatrixType& mat, MatrixBase<Dest>& x) const
+    { return solve<true,NumTraits<Scalar>::IsComplex>(mat, x.derived()); }
+
+  protected:
+    template<bool Transposed, bool Conjugate, typename Dest>
+    bool solve(const SparseMatrixType& mat, Dest& x) const;
+
+    template<bool Conjugate, typename Dest>
+    void solveRow(Index i, const Scalar* values, const IndexVector& start, const IndexVector& index,
+                  const IndexVector& position, Dest& x) const
+    {
+      internal::conj_if<Conjugate> cj;
+      for(Index c = 0; c < x.cols(); ++c)
+      {
+        Scalar tmp = x.coeff(i,c);
+        for(StorageIndex p = start.coeff(i); p < start.coeff(i+1); ++p)
+          tmp -= cj(values[position.coeff(p)]) * x.coeff(index.coeff(p),c);
+        if(!(m_mode & UnitDiag))
+          tmp /= cj(values[m_diag.coeff(i)]);
+        x.coeffRef(i,c) = tmp;
+      }
+    }
+
+    int m_mode;
+    IndexVector m_rowStart, m_rowIndex, m_rowPosition;  // the off-diagonal entries of the triangular part, row by row
+    IndexVector m_colStart, m_colIndex, m_colPosition;  // the same entries, column by column
+    IndexVector m_diag;                                 // the positions of the diagonal entries, -1 if missing
+    IndexVector m_levelStart, m_levelRows;              // the unknowns of the l-th level, by increasing index
+};
+
+template<typename SparseMatrixType>
+void TriangularSolvePlan<SparseMatrixType>::analyzePattern(const SparseMatrixType& mat, int mode)
+{
+  eigen_assert(mat.rows()==mat.cols() && mat.isCompressed());
+  eigen_assert((mode & (Lower|Upper)) && (mode & (Lower|Upper))!=(Lower|Upper) && "the mode must be either Lower or Upper");
+  const bool lower = (mode & Lower)!=0;
+  const Index n = mat.rows();
+  const StorageIndex* outerIndex = mat.outerIndexPtr();
+  const StorageIndex* innerIndex = mat.innerIndexPtr();
+  m_mode = mode;
+
+  // count the entries of the strict triangular part, per row and per column
+  m_rowStart.setZero(n+1);
+  m_colStart.setZero(n+1);
+  m_diag.setConstant(n, -1);
+  for(Index j = 0; j < n; ++j)
+    for(StorageIndex p = outerIndex[j]; p < outerIndex[j+1]; ++p)
+    {
+      const Index row = SparseMatrixType::IsRowMajor ? j : innerIndex[p];
+      const Index col = SparseMatrixType::IsRowMajor ? innerIndex[p] : j;
+      if(row==col)
+        m_diag.coeffRef(row) = p;
+      else if((col<row)==lower)
+      {
+        ++m_rowStart.coeffRef(row+1);
+        ++m_colStart.coeffRef(col+1);
+      }
+    }
+  eigen_assert(((mode & UnitDiag) || (m_diag.array()>=0).all()) && "the diagonal coefficients must be stored");
+  for(Index i = 0; i < n; ++i)
+  {
+    m_rowStart.coeffRef(i+1) += m_rowStart.coeff(i);
+    m_colStart.coeffRef(i+1) += m_colStart.coeff(i);
+  }
+
+  m_rowIndex.resize(m_rowStart.coeff(n));
+  m_rowPosition.resize(m_rowStart.coeff(n));
+  m_colIndex.resize(m_colStart.coeff(n));
+  m_colPosition.resize(m_colStart.coeff(n));
+  IndexVector rowFill = m_rowStart.head(n), colFill = m_colStart.head(n);
+  for(Index j = 0; j < n; ++j)
+    for(StorageIndex p = outerIndex[j]; p < outerIndex[j+1]; ++p)
+    {
+      const Index row = SparseMatrixType::IsRowMajor ? j : innerIndex[p];
+      const Index col = SparseMatrixType::IsRowMajor ? innerIndex[p] : j;
+      if(row!=col && (col<row)==lower)
+      {
+        m_rowIndex.coeffRef(rowFill.coeff(row)) = StorageIndex(col);
+        m_rowPosition.coeffRef(rowFill.coeffRef(row)++) = p;
+        m_colIndex.coeffRef(colFill.coeff(col)) = StorageIndex(row);
+        m_colPosition.coeffRef(colFill.coeffRef(col)++) = p;
+      }
+    }
+
+  // the level of an unknown is one more than the largest level of the unknowns it depends on
+  IndexVector level(n);
+  Index levels = 0;
+  for(Index k = 0; k < n; ++k)
+  {
+    const Index i = lower ? k : n-1-k;
+    StorageIndex l = 0;
+    for(StorageIndex p = m_rowStart.coeff(i); p < m_rowStart.coeff(i+1); ++p)
+      l = (std::max)(l, StorageIndex(level.coeff(m_rowIndex.coeff(p))+1));
+    level.coeffRef(i) = l;
+    levels = (std::max)(levels, Index(l)+1);
+  }
+  m_levelStart.setZero(levels+1);
+  for(Index i = 0; i < n; ++i)
+    ++m_levelStart.coeffRef(level.coeff(i)+1);
+  for(Index l = 0; l < levels; ++l)
+    m_levelStart.coeffRef(l+1) += m_levelStart.coeff(l);
+  m_levelRows.resize(n);
+  IndexVector levelFill = m_levelStart.head(levels);
+  for(Index i = 0; i < n; ++i)
+    m_levelRows.coeffRef(levelFill.coeffRef(level.coeff(i))++) = StorageIndex(i);
+}
+
+template<typename SparseMatrixType>
+template<bool Transposed, bool Conjugate, typename Dest>
+bool TriangularSolvePlan<SparseMatrixType>::solve(const SparseMatrixType& mat, Dest& x) const
+{
+  eigen_assert(mat.rows()==rows() && x.rows()==rows() && "the plan does not match the matrix");
+#ifdef EIGEN_HAS_OPENMP
+  const Scalar* values = mat.valuePtr();
+  const IndexVector& start    = Transposed ? m_colStart : m_rowStart;
+  const IndexVector& index    = Transposed ? m_colIndex : m_rowIndex;
+  const IndexVector& position = Transposed ? m_colPosition : m_rowPosition;
+  const Index n = rows();
+
+  // the levels are separated by synchronizations, which are only worth it for wide enough levels
+  const Index threads = Eigen::nbThreads();
+  const Index levels = this->levels();
+  if(threads==1 || omp_get_num_threads()>1 || (start.coeff(n)+n)*x.cols() < 20000 || n < levels*4*threads)
+    return false;
+
+  // the unknowns of the transposed system depend on the ones of the next levels
+  #pragma omp parallel num_threads(threads)
+  for(Index k = 0; k < levels; ++k)
+  {
+    const Index l = Transposed ? levels-1-k : k;
+    #pragma omp for schedule(static)
+    for(Index r = m_levelStart.coeff(l); r < m_levelStart.coeff(l+1); ++r)
+      solveRow<Conjugate>(m_levelRows.coeff(r), values, start, index, position, x);
+  }
+  return true;
+#else
+  EIGEN_UNUSED_VARIABLE(mat);
+  EIGEN_UNUSED_VARIABLE(x);
+  return false;
+#endif
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_TRIANGULAR_SOLVE_PLAN_H
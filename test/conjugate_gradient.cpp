@@ -18,12 +18,60 @@ template<typename T, typename I> void test_conjugate_gradient_T()
   ConjugateGradient<SparseMatrixType, Lower|Upper> cg_colmajor_loup_diag;
   ConjugateGradient<SparseMatrixType, Lower, IdentityPreconditioner> cg_colmajor_lower_I;
   ConjugateGradient<SparseMatrixType, Upper, IdentityPreconditioner> cg_colmajor_upper_I;
+  ConjugateGradient<SparseMatrixType, Lower      > cg_colmajor_lower_pipelined;
+  ConjugateGradient<SparseMatrixType, Lower|Upper> cg_colmajor_loup_pipelined;
+  // the attainable accuracy of the pipelined variant is slightly lower
+  cg_colmajor_lower_pipelined.setPipelined(true).setTolerance(test_precision<T>()*1e-4);
+  cg_colmajor_loup_pipelined.setPipelined(true).setTolerance(test_precision<T>()*1e-4);
 
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_diag)  );
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_diag)  );
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_loup_diag)   );
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_I)     );
   CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_I)     );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_pipelined) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_loup_pipelined)  );
+}
+
+template<typename T> void test_pipelined_conjugate_gradient()
+{
+  // a problem large enough to be processed in many chunks
+  typedef SparseMatrix<T> SparseMatrixType;
+  typedef Matrix<T,Dynamic,1> VectorType;
+  const int n = internal::random<int>(150,250);
+  std::vector<Triplet<T> > triplets;
+  for(int j = 0; j < n; ++j)
+    for(int i = 0; i < n; ++i)
+    {
+      const int k = i + j*n;
+      triplets.push_back(Triplet<T>(k, k, T(4.5)));
+      if(i>0)   triplets.push_back(Triplet<T>(k, k-1, T(-1)));
+      if(i<n-1) triplets.push_back(Triplet<T>(k, k+1, T(-1)));
+      if(j>0)   triplets.push_back(Triplet<T>(k, k-n, T(-1)));
+      if(j<n-1) triplets.push_back(Triplet<T>(k, k+n, T(-1)));
+    }
+  SparseMatrixType A(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  VectorType b = VectorType::Random(n*n);
+
+  ConjugateGradient<SparseMatrixType, Lower|Upper> cg(A), pcg(A);
+  cg.setTolerance(1e-10);
+  pcg.setTolerance(1e-10);
+  pcg.setPipelined(true);
+  VERIFY(pcg.pipelined() && !cg.pipelined());
+  VectorType x = cg.solve(b);
+  VectorType y = pcg.solve(b);
+  VERIFY(cg.info() == Success);
+  VERIFY(pcg.info() == Success);
+  VERIFY((A*y-b).norm() <= 1e-10 * b.norm());
+  VERIFY_IS_APPROX(x, y);
+  // both variants perform the same iterations in exact arithmetic
+  VERIFY(numext::abs(pcg.iterations() - cg.iterations()) <= cg.iterations()/10 + 2);
+
+  // with an initial guess
+  y = pcg.solveWithGuess(b, x);
+  VERIFY(pcg.iterations() <= 1);
+  VERIFY_IS_APPROX(x, y);
 }
 
 void test_conjugate_gradient()
@@ -31,4 +79,6 @@ void test_conjugate_gradient()
   CALL_SUBTEST_1(( test_conjugate_gradient_T<double,int>() ));
   CALL_SUBTEST_2(( test_conjugate_gradient_T<std::complex<double>, int>() ));
   CALL_SUBTEST_3(( test_conjugate_gradient_T<double,long int>() ));
+  CALL_SUBTEST_4(( test_pipelined_conjugate_gradient<double>() ));
+  CALL_SUBTEST_4(( test_pipelined_conjugate_gradient<std::complex<double> >() ));
 }
@@ -217,6 +217,34 @@ template<typename MatrixType> void lu_partial_piv()
   VERIFY_IS_APPROX(m2, m1.adjoint()*m3);
 }
 
+template<typename MatrixType> void lu_partial_piv_large()
+{
+  // large enough to trigger the multi-threaded path of the blocked factorization when OpenMP is enabled
+  typedef typename MatrixType::Index Index;
+  Index size = internal::random<Index>(512,600);
+
+  MatrixType m1 = MatrixType::Random(size, size);
+  // make the matrix singular, the factorization must still satisfy P A = L U
+  m1.col(size/2).setZero();
+  PartialPivLU<MatrixType> plu(m1);
+  VERIFY_IS_APPROX(m1, plu.reconstructedMatrix());
+
+  m1 = MatrixType::Random(size, size);
+  plu.compute(m1);
+  VERIFY_IS_APPROX(m1, plu.reconstructedMatrix());
+
+  // the pivots do not depend on the number of threads
+  int nb_threads = Eigen::nbThreads();
+  Eigen::setNbThreads(1);
+  PartialPivLU<MatrixType> plu_seq(m1);
+  Eigen::setNbThreads(nb_threads);
+  VERIFY(plu.permutationP().indices() == plu_seq.permutationP().indices());
+  VERIFY_IS_APPROX(plu.matrixLU(), plu_seq.matrixLU());
+
+  MatrixType m2 = MatrixType::Random(size, 2);
+  VERIFY_IS_APPROX(m1*plu.solve(m2), m2);
+}
+
 template<typename MatrixType> void lu_verify_assert()
 {
   MatrixType tmp;
@@ -278,4 +306,7 @@ void test_lu()
     CALL_SUBTEST_9( PartialPivLU<MatrixXf>(10) );
     CALL_SUBTEST_9( FullPivLU<MatrixXf>(10, 20); );
   }
+
+  CALL_SUBTEST_4( lu_partial_piv_large<MatrixXd>() );
+  CALL_SUBTEST_6( lu_partial_piv_large<MatrixXcd>() );
 }
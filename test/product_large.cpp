@@ -30,6 +30,101 @@ void test_aliasing()
   x = z;
 }
 
+template<typename T, int LhsOrder, int RhsOrder, int ResOrder>
+void test_skinny_product()
+{
+  // products whose result has at most EIGEN_SKINNY_PRODUCT_MAX_SIZE columns, or rows, read their large operand in place
+  typedef Matrix<T,Dynamic,Dynamic,LhsOrder> LhsType;
+  typedef Matrix<T,Dynamic,Dynamic,RhsOrder> RhsType;
+  typedef Matrix<T,Dynamic,Dynamic,ResOrder> ResType;
+  typedef Matrix<T,Dynamic,Dynamic> RefType;
+  Index m = internal::random<Index>(4*EIGEN_SKINNY_PRODUCT_MAX_SIZE,EIGEN_TEST_MAX_SIZE);
+  Index n = internal::random<Index>(1,EIGEN_SKINNY_PRODUCT_MAX_SIZE);
+  Index k = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+  T alpha = internal::random<T>();
+  LhsType a = LhsType::Random(m,k), ta = a.adjoint();
+  RhsType b = RhsType::Random(k,n), tb = b.adjoint();
+  ResType c = ResType::Random(m,n), tc = c.transpose();
+  RefType ref = c;
+
+  ref.noalias() += alpha * a.lazyProduct(b);
+  c.noalias() += alpha * a * b;
+  VERIFY_IS_APPROX(c, ref);
+  ref.noalias() -= ta.adjoint().lazyProduct(tb.adjoint());
+  c.noalias() -= ta.adjoint() * tb.adjoint();
+  VERIFY_IS_APPROX(c, ref);
+
+  // result with a few rows
+  RefType tref = tc;
+  tref.noalias() += (alpha * b.transpose()).lazyProduct(a.transpose());
+  tc.noalias() += alpha * b.transpose() * a.transpose();
+  VERIFY_IS_APPROX(tc, tref);
+  tref.noalias() -= tb.conjugate().lazyProduct(ta.conjugate());
+  tc.noalias() -= tb.conjugate() * ta.conjugate();
+  VERIFY_IS_APPROX(tc, tref);
+
+  // strided blocks
+  Index m2 = internal::random<Index>(4*EIGEN_SKINNY_PRODUCT_MAX_SIZE,m);
+  Index k2 = internal::random<Index>(1,k);
+  Index n2 = internal::random<Index>(1,n);
+  Index i0 = internal::random<Index>(0,m-m2), j0 = internal::random<Index>(0,n-n2), l0 = internal::random<Index>(0,k-k2);
+  ref = c;
+  ref.block(i0,j0,m2,n2).noalias() += a.block(i0,l0,m2,k2).lazyProduct(b.block(l0,j0,k2,n2));
+  c.block(i0,j0,m2,n2).noalias() += a.block(i0,l0,m2,k2) * b.block(l0,j0,k2,n2);
+  VERIFY_IS_APPROX(c, ref);
+}
+
+template<typename T>
+void test_skinny_products()
+{
+  CALL_SUBTEST(( test_skinny_product<T,ColMajor,ColMajor,ColMajor>() ));
+  CALL_SUBTEST(( test_skinny_product<T,ColMajor,ColMajor,RowMajor>() ));
+  CALL_SUBTEST(( test_skinny_product<T,ColMajor,RowMajor,ColMajor>() ));
+  CALL_SUBTEST(( test_skinny_product<T,ColMajor,RowMajor,RowMajor>() ));
+  CALL_SUBTEST(( test_skinny_product<T,RowMajor,ColMajor,ColMajor>() ));
+  CALL_SUBTEST(( test_skinny_product<T,RowMajor,ColMajor,RowMajor>() ));
+  CALL_SUBTEST(( test_skinny_product<T,RowMajor,RowMajor,ColMajor>() ));
+  CALL_SUBTEST(( test_skinny_product<T,RowMajor,RowMajor,RowMajor>() ));
+}
+
+template<typename MatrixType>
+void test_large_matrix_vector_products(Index rows, Index cols)
+{
+  // large enough to be split across the threads by the matrix * vector kernels
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> RefType;
+  const Index size = (std::min)(rows,cols);
+  MatrixType m = MatrixType::Random(rows,cols);
+  m.diagonal() = m.diagonal().real().template cast<Scalar>();
+  VectorType x = VectorType::Random(cols), y = VectorType::Random(rows), res = VectorType::Random(rows), ref = res;
+  Scalar alpha = internal::random<Scalar>();
+
+  res.noalias() += alpha * m * x;
+  ref.noalias() += alpha * m.lazyProduct(x);
+  VERIFY_IS_APPROX(res, ref);
+
+  VectorType resT = VectorType::Random(cols), refT = resT;
+  resT.noalias() -= m.adjoint() * y;
+  refT.noalias() -= m.adjoint().lazyProduct(y);
+  VERIFY_IS_APPROX(resT, refT);
+
+  res.setRandom(); ref = res;
+  res.noalias() += m.template triangularView<Lower>() * (alpha * x);
+  ref.noalias() += (alpha * RefType(m.template triangularView<Lower>())).lazyProduct(x);
+  VERIFY_IS_APPROX(res, ref);
+
+  resT.setRandom(); refT = resT;
+  resT.noalias() += m.adjoint().template triangularView<UnitLower>() * y;
+  refT.noalias() += RefType(m.adjoint().template triangularView<UnitLower>()).lazyProduct(y);
+  VERIFY_IS_APPROX(resT, refT);
+
+  VectorType s = VectorType::Random(size), sres = VectorType::Random(size), sref = sres;
+  sres.noalias() += alpha * (m.topLeftCorner(size,size).template selfadjointView<Upper>() * s);
+  sref.noalias() += alpha * RefType(m.topLeftCorner(size,size).template selfadjointView<Upper>()).lazyProduct(s);
+  VERIFY_IS_APPROX(sres, sref);
+}
+
 void test_product_large()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -40,6 +135,11 @@ void test_product_large()
     CALL_SUBTEST_5( product(Matrix<float,Dynamic,Dynamic,RowMajor>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
 
     CALL_SUBTEST_1( test_aliasing<float>() );
+
+    CALL_SUBTEST_1( test_skinny_products<float>() );
+    CALL_SUBTEST_2( test_skinny_products<double>() );
+    CALL_SUBTEST_3( test_skinny_products<int>() );
+    CALL_SUBTEST_4( test_skinny_products<std::complex<float> >() );
   }
 
 #if defined EIGEN_TEST_PART_6
@@ -103,5 +203,16 @@ void test_product_large()
   for(int i = 0; i < g_repeat; i++) {
     CALL_SUBTEST_6( product(Matrix<float,Dynamic,Dynamic>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
   }
+
+  // the matrix * vector kernels ask for several threads even on a single core, and must not split the product
+  // again when OpenMP grants fewer threads than requested, as it may with dynamic threads
+  int nb_threads = Eigen::nbThreads();
+  Eigen::setNbThreads((std::max)(nb_threads,4));
+  CALL_SUBTEST_6(( test_large_matrix_vector_products<MatrixXd>(1000,1200) ));
+  CALL_SUBTEST_6(( test_large_matrix_vector_products<Matrix<float,Dynamic,Dynamic,RowMajor> >(1300,900) ));
+  CALL_SUBTEST_6(( test_large_matrix_vector_products<MatrixXcf>(20,30000) ));
+  CALL_SUBTEST_6(( test_large_matrix_vector_products<Matrix<double,Dynamic,Dynamic,RowMajor> >(30000,20) ));
+  CALL_SUBTEST_6(( test_large_matrix_vector_products<MatrixXf>(600,600) ));
+  Eigen::setNbThreads(nb_threads);
 #endif
 }
@@ -0,0 +1,94 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+template<typename MatrixType> void product_packed(Index rows, Index depth, Index cols)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseType;
+  typedef Matrix<Scalar, Dynamic, Dynamic, RowMajor> RowDenseType;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+
+  MatrixType w = MatrixType::Random(rows, depth);
+  PackedMatrix<MatrixType> wp(w, cols);
+  VERIFY_IS_EQUAL(wp.rows(), rows);
+  VERIFY_IS_EQUAL(wp.cols(), depth);
+
+  DenseType x = DenseType::Random(depth, cols), y;
+  y = wp * x;
+  VERIFY_IS_APPROX(y, w * x);
+
+  // the packed matrix is reused
+  x.setRandom();
+  y = wp * x;
+  VERIFY_IS_APPROX(y, w * x);
+
+  // vectors, row-major and strided operands
+  VectorType v = VectorType::Random(depth), u;
+  u = wp * v;
+  VERIFY_IS_APPROX(u, w * v);
+  RowDenseType xr = x;
+  y = wp * xr;
+  VERIFY_IS_APPROX(y, w * x);
+  RowDenseType yr;
+  yr = wp * x;
+  VERIFY_IS_APPROX(yr, w * x);
+  DenseType big = DenseType::Random(depth+3, cols+2);
+  y = wp * big.block(1, 2, depth, cols);
+  VERIFY_IS_APPROX(y, w * big.block(1, 2, depth, cols));
+  DenseType res = DenseType::Zero(rows+2, cols+1);
+  res.block(1, 1, rows, cols) = wp * x;
+  VERIFY_IS_APPROX(res.block(1, 1, rows, cols), w * x);
+
+  // the result overwrites the rhs
+  Scalar s = internal::random<Scalar>();
+  if(rows==depth)
+  {
+    DenseType x0 = x;
+    x = wp * x;
+    VERIFY_IS_APPROX(x, w * x0);
+    x = x0;
+    v = VectorType::Random(depth);
+    VectorType v0 = v;
+    v = wp * (s * v);
+    VERIFY_IS_APPROX(v, w * (s * v0));
+    DenseType x1 = DenseType::Random(depth, cols);
+    x = wp * (x + x1);
+    VERIFY_IS_APPROX(x, w * (x0 + x1));
+    x = x0;
+  }
+
+  // scaled and conjugated rhs, accumulation
+  y = wp * (s * x.conjugate());
+  VERIFY_IS_APPROX(y, w * (s * x.conjugate()));
+  DenseType z = DenseType::Random(rows, cols), z0 = z;
+  wp.scaleAndAddTo(z, x, s);
+  VERIFY_IS_APPROX(z, z0 + s * (w * x));
+}
+
+void test_product_packed()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    Index rows = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+    Index depth = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+    CALL_SUBTEST_1(( product_packed<MatrixXf>(rows, depth, internal::random<Index>(1,EIGEN_TEST_MAX_SIZE)) ));
+    CALL_SUBTEST_1(( product_packed<MatrixXf>(rows, depth, 1) ));
+    CALL_SUBTEST_2(( product_packed<MatrixXd>(rows, depth, internal::random<Index>(1,8)) ));
+    CALL_SUBTEST_2(( product_packed<MatrixXd>(rows, rows, internal::random<Index>(1,EIGEN_TEST_MAX_SIZE)) ));
+    CALL_SUBTEST_3(( product_packed<MatrixXcf>(rows/2+1, depth/2+1, internal::random<Index>(1,EIGEN_TEST_MAX_SIZE/2)) ));
+    CALL_SUBTEST_4(( product_packed<Matrix<double,Dynamic,Dynamic,RowMajor> >(rows, depth, internal::random<Index>(1,EIGEN_TEST_MAX_SIZE)) ));
+  }
+
+  // small cache sizes, such that the matrix is split in many blocks
+  std::ptrdiff_t l1 = l1CacheSize(), l2 = l2CacheSize(), l3 = l3CacheSize();
+  setCpuCacheSizes(1024, 4096, 16384);
+  CALL_SUBTEST_1(( product_packed<MatrixXf>(300, 500, 20) ));
+  CALL_SUBTEST_2(( product_packed<MatrixXd>(257, 333, 1) ));
+  CALL_SUBTEST_3(( product_packed<MatrixXcf>(130, 170, 7) ));
+  setCpuCacheSizes(l1, l2, l3);
+}
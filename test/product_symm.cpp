@@ -95,6 +95,42 @@ template<typename Scalar, int Size, int OtherSize> void symm(int size = Size, in
 
 }
 
+template<typename Scalar> void symm_threads(Index size, Index cols)
+{
+  // large enough to be split across the threads by parallelize_gemm
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RMatrixType;
+  MatrixType s = MatrixType::Random(size,size), rhs = MatrixType::Random(size,cols);
+  s.diagonal() = s.diagonal().real().template cast<Scalar>();
+  Scalar alpha = internal::random<Scalar>();
+
+#ifdef EIGEN_HAS_OPENMP
+  int nb_threads = Eigen::nbThreads();
+  int dynamic = omp_get_dynamic();
+  int max_levels = omp_get_max_active_levels();
+  Eigen::setNbThreads((std::max)(nb_threads,4));
+  // all the requested threads, dynamic threads, then a single thread granted by OpenMP
+  for(int k=0; k<3; ++k)
+  {
+    omp_set_dynamic(k==1);
+    omp_set_max_active_levels(k==2 ? 0 : max_levels);
+#endif
+    MatrixType res = MatrixType::Random(size,cols), ref = res;
+    res.noalias() += alpha * s.template selfadjointView<Lower>() * rhs;
+    ref.noalias() += alpha * MatrixType(s.template selfadjointView<Lower>()) * rhs;
+    VERIFY_IS_APPROX(res, ref);
+
+    RMatrixType rres = rhs.adjoint() * s.template selfadjointView<Upper>();
+    RMatrixType rref = rhs.adjoint() * MatrixType(s.template selfadjointView<Upper>());
+    VERIFY_IS_APPROX(rres, rref);
+#ifdef EIGEN_HAS_OPENMP
+  }
+  omp_set_dynamic(dynamic);
+  omp_set_max_active_levels(max_levels);
+  Eigen::setNbThreads(nb_threads);
+#endif
+}
+
 void test_product_symm()
 {
   for(int i = 0; i < g_repeat ; i++)
@@ -109,4 +145,6 @@ void test_product_symm()
     CALL_SUBTEST_7(( symm<std::complex<float>,Dynamic,1>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE)) ));
     CALL_SUBTEST_8(( symm<std::complex<double>,Dynamic,1>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE)) ));
   }
+  CALL_SUBTEST_2(( symm_threads<double>(300,400) ));
+  CALL_SUBTEST_3(( symm_threads<std::complex<float> >(200,300) ));
 }
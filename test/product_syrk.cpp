@@ -118,6 +118,48 @@ template<typename MatrixType> void syrk(const MatrixType& m)
                    ((s1 * m1.row(c).adjoint() * m1.row(c).adjoint().adjoint()).eval().template triangularView<Upper>().toDenseMatrix()));
 }
 
+template<typename Scalar> void syrk_threads(Index size, Index depth)
+{
+  // large enough to be split across the threads by the rank-k update kernel
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RMatrixType;
+  MatrixType x = MatrixType::Random(depth,size), y = MatrixType::Random(depth,size), g = MatrixType::Random(size,size);
+  RealScalar alpha = internal::random<RealScalar>();
+
+#ifdef EIGEN_HAS_OPENMP
+  int nb_threads = Eigen::nbThreads();
+  int dynamic = omp_get_dynamic();
+  int max_levels = omp_get_max_active_levels();
+  Eigen::setNbThreads((std::max)(nb_threads,4));
+  // all the requested threads, dynamic threads, then a single thread granted by OpenMP
+  for(int k=0; k<3; ++k)
+  {
+    omp_set_dynamic(k==1);
+    omp_set_max_active_levels(k==2 ? 0 : max_levels);
+#endif
+    MatrixType res = g, ref = g;
+    res.template selfadjointView<Lower>().rankUpdate(x.adjoint(), alpha);
+    ref.template triangularView<Lower>() += MatrixType(alpha * x.adjoint() * x);
+    VERIFY_IS_APPROX(res, ref);
+
+    RMatrixType rres = g, rref = g;
+    rres.template selfadjointView<Upper>().rankUpdate(x.adjoint(), alpha);
+    rref.template triangularView<Upper>() += MatrixType(alpha * x.adjoint() * x);
+    VERIFY_IS_APPROX(rres, rref);
+
+    res = g; ref = g;
+    res.template triangularView<Upper>() += x.adjoint() * y;
+    ref.template triangularView<Upper>() += MatrixType(x.adjoint() * y);
+    VERIFY_IS_APPROX(res, ref);
+#ifdef EIGEN_HAS_OPENMP
+  }
+  omp_set_dynamic(dynamic);
+  omp_set_max_active_levels(max_levels);
+  Eigen::setNbThreads(nb_threads);
+#endif
+}
+
 void test_product_syrk()
 {
   for(int i = 0; i < g_repeat ; i++)
@@ -133,4 +175,6 @@ void test_product_syrk()
     CALL_SUBTEST_4( syrk(MatrixXcd(s, s)) );
     TEST_SET_BUT_UNUSED_VARIABLE(s)
   }
+  CALL_SUBTEST_2( syrk_threads<double>(300,600) );
+  CALL_SUBTEST_3( syrk_threads<std::complex<float> >(200,300) );
 }
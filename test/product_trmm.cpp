@@ -80,6 +80,34 @@ void trmm(int rows=get_random_size<Scalar>(), int cols=get_random_size<Scalar>()
   trmm<Scalar,Mode,TriOrder,OtherOrder,ResOrder,Dynamic>(rows,cols,otherCols);
 }
 
+template<typename Scalar>
+void trmm_threads(int size, int otherCols)
+{
+  // large enough non triangular operands to be split across the threads
+#ifdef EIGEN_HAS_OPENMP
+  int nb_threads = Eigen::nbThreads();
+  int dynamic = omp_get_dynamic();
+  int max_levels = omp_get_max_active_levels();
+  Eigen::setNbThreads((std::max)(nb_threads,4));
+  // all the requested threads, dynamic threads, then a single thread granted by OpenMP
+  for(int k=0; k<3; ++k)
+  {
+    omp_set_dynamic(k==1);
+    omp_set_max_active_levels(k==2 ? 0 : max_levels);
+#endif
+    // the triangular matrix is applied on the left and on the right
+    trmm<Scalar, Lower, ColMajor,ColMajor,ColMajor>(size,size,otherCols);
+    trmm<Scalar, Upper, RowMajor,RowMajor,ColMajor>(size,size,otherCols);
+    trmm<Scalar, UnitUpper, ColMajor,RowMajor,RowMajor>(size+7,size,otherCols);
+    trmm<Scalar, StrictlyLower, RowMajor,ColMajor,RowMajor>(size,size+7,otherCols);
+#ifdef EIGEN_HAS_OPENMP
+  }
+  omp_set_dynamic(dynamic);
+  omp_set_max_active_levels(max_levels);
+  Eigen::setNbThreads(nb_threads);
+#endif
+}
+
 #define CALL_ALL_ORDERS(NB,SCALAR,MODE)                                             \
   EIGEN_CAT(CALL_SUBTEST_,NB)((trmm<SCALAR, MODE, ColMajor,ColMajor,ColMajor>()));  \
   EIGEN_CAT(CALL_SUBTEST_,NB)((trmm<SCALAR, MODE, ColMajor,ColMajor,RowMajor>()));  \
@@ -112,4 +140,7 @@ void test_product_trmm()
     CALL_ALL(3,std::complex<float>);  //  EIGEN_SUFFIXES;13;113;23;123;33;133
     CALL_ALL(4,std::complex<double>); //  EIGEN_SUFFIXES;14;114;24;124;34;134
   }
+
+  CALL_SUBTEST_12((trmm_threads<double>(300,500)));
+  CALL_SUBTEST_13((trmm_threads<std::complex<float> >(150,300)));
 }
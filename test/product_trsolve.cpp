@@ -73,6 +73,43 @@ template<typename Scalar,int Size, int Cols> void trsolve(int size=Size,int cols
   VERIFY_TRSM(cmLhs.template triangularView<Lower>(), rmRhs.col(c));
 }
 
+template<typename Scalar> void trsolve_threads(int size, int cols)
+{
+  // large enough right hand sides to be split across the threads
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  Matrix<Scalar,Dynamic,Dynamic,ColMajor> cmLhs(size,size);
+  Matrix<Scalar,Dynamic,Dynamic,RowMajor> rmLhs(size,size);
+  Matrix<Scalar,Dynamic,Dynamic,ColMajor> cmRhs(size,cols), ref(size,cols);
+  Matrix<Scalar,Dynamic,Dynamic,RowMajor> rmRhs(size,cols);
+  cmLhs.setRandom(); cmLhs *= static_cast<RealScalar>(0.1); cmLhs.diagonal().array() += static_cast<RealScalar>(1);
+  rmLhs.setRandom(); rmLhs *= static_cast<RealScalar>(0.1); rmLhs.diagonal().array() += static_cast<RealScalar>(1);
+
+#ifdef EIGEN_HAS_OPENMP
+  int nb_threads = Eigen::nbThreads();
+  int dynamic = omp_get_dynamic();
+  int max_levels = omp_get_max_active_levels();
+  Eigen::setNbThreads((std::max)(nb_threads,4));
+  // all the requested threads, dynamic threads, then a single thread granted by OpenMP
+  for(int k=0; k<3; ++k)
+  {
+    omp_set_dynamic(k==1);
+    omp_set_max_active_levels(k==2 ? 0 : max_levels);
+#endif
+    VERIFY_TRSM(cmLhs.template triangularView<Lower>(), cmRhs);
+    VERIFY_TRSM(cmLhs.adjoint().template triangularView<Upper>(), rmRhs);
+    VERIFY_TRSM(rmLhs.template triangularView<UnitUpper>(), cmRhs);
+
+    VERIFY_TRSM_ONTHERIGHT(cmLhs.template triangularView<Upper>(), cmRhs);
+    VERIFY_TRSM_ONTHERIGHT(cmLhs.conjugate().template triangularView<Lower>(), rmRhs);
+    VERIFY_TRSM_ONTHERIGHT(rmLhs.template triangularView<UnitLower>(), rmRhs);
+#ifdef EIGEN_HAS_OPENMP
+  }
+  omp_set_dynamic(dynamic);
+  omp_set_max_active_levels(max_levels);
+  Eigen::setNbThreads(nb_threads);
+#endif
+}
+
 void test_product_trsolve()
 {
   for(int i = 0; i < g_repeat ; i++)
@@ -98,4 +135,7 @@ void test_product_trsolve()
     CALL_SUBTEST_14((trsolve<float,3,1>()));
     
   }
+
+  CALL_SUBTEST_2((trsolve_threads<double>(300,500)));
+  CALL_SUBTEST_3((trsolve_threads<std::complex<float> >(150,300)));
 }
@@ -200,6 +200,51 @@ template<typename MatrixType, int Cols2> void qr_fixedsize()
   }
 }
 
+// Large dynamic-size matrices are factorized by panels of columns,
+// make sure that the rank-revealing properties are preserved across panels.
+template<typename MatrixType> void qr_blocked()
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<Scalar, MatrixType::RowsAtCompileTime, MatrixType::RowsAtCompileTime> MatrixQType;
+
+  Index cols = internal::random<Index>(70,200);
+  Index rows = cols + internal::random<Index>(0,200);
+  Index rank = internal::random<Index>(cols/2, cols-1);
+
+  MatrixType m1;
+  createRandomPIMatrixOfRank(rank,rows,cols,m1);
+  ColPivHouseholderQR<MatrixType> qr(m1);
+  VERIFY_IS_EQUAL(rank, qr.rank());
+
+  // make the column norms very different to trigger norm recomputations
+  for(Index j = 0; j < cols; ++j)
+    m1.col(j) *= RealScalar(std::pow(RealScalar(10), RealScalar(internal::random<int>(-3,3))));
+  qr.compute(m1);
+
+  MatrixQType q = qr.householderQ();
+  VERIFY_IS_UNITARY(q);
+
+  MatrixType r = qr.matrixQR().template triangularView<Upper>();
+  MatrixType c = q * r * qr.colsPermutation().inverse();
+  VERIFY_IS_APPROX(m1, c);
+
+  RealScalar threshold =
+      std::sqrt(RealScalar(rows)) * numext::abs(r(0, 0)) * NumTraits<Scalar>::epsilon();
+  for (Index i = 0; i < cols - 1; ++i) {
+    RealScalar x = numext::abs(r(i, i));
+    RealScalar y = numext::abs(r(i + 1, i + 1));
+    if (x < threshold && y < threshold) continue;
+    VERIFY_IS_APPROX_OR_LESS_THAN(y, x);
+  }
+
+  MatrixType m2 = MatrixType::Random(cols,3);
+  MatrixType m3 = m1*m2;
+  m2 = qr.solve(m3);
+  VERIFY_IS_APPROX(m3, m1*m2);
+}
+
 // This test is meant to verify that pivots are chosen such that
 // even for a graded matrix, the diagonal of R falls of roughly
 // monotonically until it reaches the threshold for singularity.
@@ -337,6 +382,10 @@ void test_qr_colpivoting()
   // Test problem size constructors
   CALL_SUBTEST_9(ColPivHouseholderQR<MatrixXf>(10, 20));
 
+  CALL_SUBTEST_1( qr_blocked<MatrixXf>() );
+  CALL_SUBTEST_2( qr_blocked<MatrixXd>() );
+  CALL_SUBTEST_3( qr_blocked<MatrixXcd>() );
+
   CALL_SUBTEST_1( qr_kahan_matrix<MatrixXf>() );
   CALL_SUBTEST_2( qr_kahan_matrix<MatrixXd>() );
 }
@@ -0,0 +1,64 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/QR>
+
+template<typename MatrixType> void qr_tallskinny(Index rows, Index cols, Index blockRows)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseType;
+
+  MatrixType a = MatrixType::Random(rows,cols);
+  TallSkinnyQR<MatrixType> qr;
+  qr.setBlockRows(blockRows).compute(a);
+  if(rows >= 2*cols && blockRows > 0)
+    VERIFY_IS_EQUAL(qr.blocks(), rows/(std::max)(blockRows,cols));
+
+  DenseType q = qr.householderQ();
+  VERIFY_IS_UNITARY(q);
+
+  Index size = (std::min)(rows,cols);
+  DenseType r = DenseType::Zero(rows,cols);
+  r.topRows(size) = qr.matrixQR().topRows(size).template triangularView<Upper>();
+  VERIFY_IS_APPROX(a, q * r);
+
+  // the thin factor and the products by Q and its adjoint
+  DenseType thinQ = qr.householderQ() * DenseType::Identity(rows, size);
+  VERIFY_IS_APPROX(thinQ, q.leftCols(size));
+  DenseType b = DenseType::Random(rows, 3);
+  DenseType qtb = qr.householderQ().adjoint() * b;
+  VERIFY_IS_APPROX(qtb, q.adjoint() * b);
+
+  // R must match the one of HouseholderQR up to the signs of its rows
+  HouseholderQR<MatrixType> ref(a);
+  DenseType rRef = ref.matrixQR().topRows(size).template triangularView<Upper>();
+  VERIFY_IS_APPROX(r.topRows(size).cwiseAbs(), rRef.cwiseAbs());
+
+  // least-squares solve
+  DenseType x = qr.solve(b);
+  VERIFY_IS_APPROX(x, ref.solve(b));
+  if(rows >= cols)
+    VERIFY_IS_APPROX((a.adjoint()*(a*x - b)).norm() + Scalar(1), Scalar(1));
+}
+
+void test_qr_tallskinny()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    Index cols = internal::random<Index>(1,20);
+    Index rows = cols * internal::random<Index>(2,30) + internal::random<Index>(0,cols);
+    Index blockRows = internal::random<Index>(0, rows/2);
+    CALL_SUBTEST_1( qr_tallskinny<MatrixXf>(rows, cols, blockRows) );
+    CALL_SUBTEST_2( qr_tallskinny<MatrixXd>(rows, cols, blockRows) );
+    CALL_SUBTEST_3( qr_tallskinny<MatrixXcd>(rows, cols, blockRows) );
+
+    // a single block reduces to HouseholderQR, including for wide matrices
+    CALL_SUBTEST_2( qr_tallskinny<MatrixXd>(internal::random<Index>(1,20), internal::random<Index>(1,20), 0) );
+    CALL_SUBTEST_4(( qr_tallskinny<Matrix<double,Dynamic,4> >(internal::random<Index>(8,200), 4, 8) ));
+    CALL_SUBTEST_4(( qr_tallskinny<Matrix<std::complex<float>,Dynamic,Dynamic,RowMajor> >(rows, cols, blockRows) ));
+  }
+}
@@ -39,9 +39,77 @@ template<typename T, typename I> void test_simplicial_cholesky_T()
   check_sparse_spd_solving(ldlt_colmajor_upper_nat, 300, 1000);
 }
 
+template<typename T, typename I> void test_simplicial_cholesky_orderings()
+{
+  typedef SparseMatrix<T,0,I> SparseMatrixType;
+  typedef PermutationMatrix<Dynamic,Dynamic,I> PermutationType;
+  SimplicialLLT<     SparseMatrixType, Lower, RCMOrdering<I> > llt_colmajor_lower_rcm;
+  SimplicialLDLT<    SparseMatrixType, Upper, RCMOrdering<I> > ldlt_colmajor_upper_rcm;
+  SimplicialLLT<     SparseMatrixType, Upper, NestedDissectionOrdering<I> > llt_colmajor_upper_nd;
+  SimplicialLDLT<    SparseMatrixType, Lower, NestedDissectionOrdering<I> > ldlt_colmajor_lower_nd;
+
+  check_sparse_spd_solving(llt_colmajor_lower_rcm, 300, 1000);
+  check_sparse_spd_solving(ldlt_colmajor_upper_rcm, 300, 1000);
+  check_sparse_spd_solving(llt_colmajor_upper_nd, 300, 1000);
+  check_sparse_spd_solving(ldlt_colmajor_lower_nd, 300, 1000);
+
+  // 2D Laplacian with randomly numbered unknowns
+  const Index m = internal::random<Index>(30,50), n = m*m;
+  std::vector<Triplet<T,I> > triplets;
+  for(Index i = 0; i < m; ++i)
+    for(Index j = 0; j < m; ++j)
+    {
+      triplets.push_back(Triplet<T,I>(I(i*m+j), I(i*m+j), T(4)));
+      if(i>0) triplets.push_back(Triplet<T,I>(I(i*m+j), I((i-1)*m+j), T(-1)));
+      if(j>0) triplets.push_back(Triplet<T,I>(I(i*m+j), I(i*m+j-1), T(-1)));
+    }
+  SparseMatrixType L(n,n), A;
+  L.setFromTriplets(triplets.begin(), triplets.end());
+  PermutationType shuffle(n);
+  shuffle.setIdentity();
+  std::random_shuffle(shuffle.indices().data(), shuffle.indices().data()+n);
+  A = L.template selfadjointView<Lower>().twistedBy(shuffle);
+
+  // the orderings are permutations of the unknowns
+  PermutationType rcm, nd;
+  RCMOrdering<I>()(A, rcm);
+  NestedDissectionOrdering<I> ndOrdering;
+  ndOrdering.setLeafSize(32);
+  ndOrdering(A.template selfadjointView<Lower>(), nd);
+  VERIFY_IS_EQUAL(rcm.size(), n);
+  VERIFY_IS_EQUAL(nd.size(), n);
+  Matrix<I,Dynamic,1> sorted = rcm.indices();
+  std::sort(sorted.data(), sorted.data()+n);
+  VERIFY_IS_EQUAL(sorted, (Matrix<I,Dynamic,1>::LinSpaced(n, 0, I(n-1))));
+  sorted = nd.indices();
+  std::sort(sorted.data(), sorted.data()+n);
+  VERIFY_IS_EQUAL(sorted, (Matrix<I,Dynamic,1>::LinSpaced(n, 0, I(n-1))));
+
+  // reverse Cuthill-McKee recovers a bandwidth of the order of the width of the grid
+  SparseMatrixType B;
+  B = A.template selfadjointView<Lower>().twistedBy(rcm.inverse());
+  Index bandwidth = 0;
+  for(Index j = 0; j < n; ++j)
+    for(typename SparseMatrixType::InnerIterator it(B, j); it; ++it)
+      bandwidth = (std::max)(bandwidth, Index(numext::abs(it.index()-j)));
+  VERIFY(bandwidth <= 2*m);
+
+  // nested dissection produces less fill-in than the banded ordering
+  SimplicialLLT<SparseMatrixType, Lower, RCMOrdering<I> > llt_rcm(A);
+  SimplicialLLT<SparseMatrixType, Lower, NestedDissectionOrdering<I> > llt_nd(A);
+  VERIFY_IS_EQUAL(llt_rcm.info(), Success);
+  VERIFY_IS_EQUAL(llt_nd.info(), Success);
+  SparseMatrixType Lrcm = llt_rcm.matrixL(), Lnd = llt_nd.matrixL();
+  VERIFY(Lnd.nonZeros() < Lrcm.nonZeros());
+  Matrix<T,Dynamic,1> b = Matrix<T,Dynamic,1>::Random(n);
+  VERIFY_IS_APPROX(A.template selfadjointView<Lower>() * llt_nd.solve(b), b);
+}
+
 void test_simplicial_cholesky()
 {
   CALL_SUBTEST_1(( test_simplicial_cholesky_T<double,int>() ));
   CALL_SUBTEST_2(( test_simplicial_cholesky_T<std::complex<double>, int>() ));
   CALL_SUBTEST_3(( test_simplicial_cholesky_T<double,long int>() ));
+  CALL_SUBTEST_4(( test_simplicial_cholesky_orderings<double,int>() ));
+  CALL_SUBTEST_4(( test_simplicial_cholesky_orderings<std::complex<double>,long int>() ));
 }
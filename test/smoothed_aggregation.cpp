@@ -0,0 +1,127 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "sparse_solver.h"
+#include <Eigen/IterativeLinearSolvers>
+
+template<typename T, typename I> void test_smoothed_aggregation_T()
+{
+  typedef SparseMatrix<T,0,I> SparseMatrixType;
+  typedef SmoothedAggregationPreconditioner<T,Lower,I> LowerAMG;
+  typedef SmoothedAggregationPreconditioner<T,Upper,I> UpperAMG;
+  typedef SmoothedAggregationPreconditioner<T,Lower|Upper,I> FullAMG;
+  ConjugateGradient<SparseMatrixType, Lower, LowerAMG>        cg_amg_lower;
+  ConjugateGradient<SparseMatrixType, Upper, UpperAMG>        cg_amg_upper;
+  ConjugateGradient<SparseMatrixType, Lower|Upper, FullAMG>   cg_amg_uplo;
+  ConjugateGradient<SparseMatrixType, Lower|Upper, FullAMG>   cg_amg_jacobi;
+  // coarsen the small test matrices anyway
+  cg_amg_lower.preconditioner().setCoarseSize(4);
+  cg_amg_upper.preconditioner().setCoarseSize(4);
+  cg_amg_uplo.preconditioner().setCoarseSize(4);
+  cg_amg_uplo.preconditioner().setMaxLevels(2);
+  cg_amg_jacobi.preconditioner().setCoarseSize(4);
+  cg_amg_jacobi.preconditioner().setSmoother(FullAMG::JacobiSmoother);
+  cg_amg_jacobi.preconditioner().setSmootherSweeps(2);
+
+  CALL_SUBTEST( check_sparse_spd_solving(cg_amg_lower) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_amg_upper) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_amg_uplo) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_amg_jacobi) );
+}
+
+// 5-point discretization of the Poisson equation on a n x n grid
+template<typename SparseMatrixType>
+void poisson_2d(int n, SparseMatrixType& A)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  std::vector<Triplet<Scalar> > triplets;
+  for(int j = 0; j < n; ++j)
+    for(int i = 0; i < n; ++i)
+    {
+      const int k = i + j*n;
+      triplets.push_back(Triplet<Scalar>(k, k, Scalar(4)));
+      if(i>0)   triplets.push_back(Triplet<Scalar>(k, k-1, Scalar(-1)));
+      if(i<n-1) triplets.push_back(Triplet<Scalar>(k, k+1, Scalar(-1)));
+      if(j>0)   triplets.push_back(Triplet<Scalar>(k, k-n, Scalar(-1)));
+      if(j<n-1) triplets.push_back(Triplet<Scalar>(k, k+n, Scalar(-1)));
+    }
+  A.resize(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+template<int Smoother> void test_smoothed_aggregation_poisson()
+{
+  typedef SparseMatrix<double> SparseMatrixType;
+  typedef SmoothedAggregationPreconditioner<double,Lower|Upper> AMG;
+  Index iterations[2];
+  const int sizes[2] = { 40, 160 };
+  for(int k = 0; k < 2; ++k)
+  {
+    SparseMatrixType A;
+    poisson_2d(sizes[k], A);
+    VectorXd b = VectorXd::Random(A.rows());
+
+    ConjugateGradient<SparseMatrixType, Lower|Upper, AMG> cg;
+    cg.preconditioner().setCoarseSize(50);
+    cg.preconditioner().setSmoother(typename AMG::SmootherType(Smoother));
+    cg.setTolerance(1e-8);
+    cg.compute(A);
+    VERIFY(cg.info() == Success);
+    VERIFY(cg.preconditioner().levels() >= 3);
+    VERIFY(cg.preconditioner().operatorComplexity() < 2);
+    VERIFY(cg.preconditioner().levelMatrix(1).rows() < A.rows()/4);
+    VectorXd x = cg.solve(b);
+    VERIFY(cg.info() == Success);
+    VERIFY((A*x-b).norm() <= 1e-7 * b.norm());
+    iterations[k] = cg.iterations();
+
+    // far less iterations than with the diagonal preconditioner
+    ConjugateGradient<SparseMatrixType, Lower|Upper> cg_diag(A);
+    cg_diag.setTolerance(1e-8);
+    x = cg_diag.solve(b);
+    VERIFY(iterations[k] * 3 < cg_diag.iterations());
+  }
+  // the number of iterations barely depends on the size of the mesh
+  VERIFY(iterations[1] <= 2 * iterations[0]);
+}
+
+void test_smoothed_aggregation_zero_diagonal()
+{
+  typedef SparseMatrix<double> SparseMatrixType;
+  typedef SmoothedAggregationPreconditioner<double,Lower|Upper> AMG;
+  SparseMatrixType A;
+  poisson_2d(20, A);
+  A.coeffRef(7,7) = 0;
+
+  AMG amg;
+  amg.setCoarseSize(4);
+  amg.compute(A);
+  VERIFY(amg.info() == NumericalIssue);
+  VERIFY_IS_EQUAL(amg.levels(), 0);
+  // no level was built, the preconditioner is the identity
+  VectorXd b = VectorXd::Random(A.rows());
+  VectorXd x = amg.solve(b);
+  VERIFY_IS_EQUAL(x, b);
+
+  // the solver still runs
+  ConjugateGradient<SparseMatrixType, Lower|Upper, AMG> cg;
+  cg.setMaxIterations(10);
+  cg.compute(A);
+  VERIFY(cg.preconditioner().info() == NumericalIssue);
+  x = cg.solve(b);
+  VERIFY((x.array()==x.array()).all());
+}
+
+void test_smoothed_aggregation()
+{
+  CALL_SUBTEST_1(( test_smoothed_aggregation_T<double,int>() ));
+  CALL_SUBTEST_2(( test_smoothed_aggregation_T<std::complex<double>, int>() ));
+  CALL_SUBTEST_3(( test_smoothed_aggregation_T<double,long int>() ));
+  CALL_SUBTEST_4(( test_smoothed_aggregation_poisson<SmoothedAggregationPreconditioner<double>::GaussSeidelSmoother>() ));
+  CALL_SUBTEST_4(( test_smoothed_aggregation_poisson<SmoothedAggregationPreconditioner<double>::JacobiSmoother>() ));
+  CALL_SUBTEST_5(( test_smoothed_aggregation_zero_diagonal() ));
+}
@@ -389,6 +389,33 @@ template<typename SparseMatrixType> void sparse_basic(const SparseMatrixType& re
     m.setFromTriplets(triplets.begin(), triplets.end(), [] (Scalar,Scalar b) { return b; });
     VERIFY_IS_APPROX(m, refMat_last);
 #endif
+
+    // assemble again with new values through a recorded plan
+    TripletAssemblyPlan<SparseMatrixType> plan;
+    SparseMatrixType m2(rows,cols);
+    plan.analyzePattern(triplets.begin(), triplets.end(), m2);
+    VERIFY(m2.isCompressed());
+    VERIFY_IS_EQUAL(plan.triplets(), ntriplets);
+    VERIFY_IS_APPROX(m2, refMat_sum);
+    std::vector<Scalar> values(triplets.size());
+    refMat_sum.setZero();
+    for(Index i=0;i<ntriplets;++i)
+    {
+      values[i] = internal::random<Scalar>();
+      triplets[i] = TripletType(triplets[i].row(), triplets[i].col(), values[i]);
+      refMat_sum(triplets[i].row(),triplets[i].col()) += values[i];
+    }
+    plan.computeValues(triplets.begin(), triplets.end(), m2);
+    VERIFY_IS_APPROX(m2, refMat_sum);
+    m.setFromTriplets(triplets.begin(), triplets.end());
+    VERIFY_IS_EQUAL(m2.nonZeros(), m.nonZeros());
+    VERIFY_IS_APPROX(m2, m);
+    if(ntriplets>0)
+    {
+      plan.computeValues(&values[0], m2, std::multiplies<Scalar>());
+      m.setFromTriplets(triplets.begin(), triplets.end(), std::multiplies<Scalar>());
+      VERIFY_IS_APPROX(m2, m);
+    }
   }
   
   // test Map
@@ -640,6 +667,46 @@ void big_sparse_triplet(Index rows, Index cols, double density) {
   VERIFY_IS_APPROX(sum, m.sum());
 }
 
+template<typename SparseMatrixType>
+void sparse_triplet_threads() {
+  typedef typename SparseMatrixType::StorageIndex StorageIndex;
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef Triplet<Scalar,StorageIndex> TripletType;
+  Index rows = internal::random<Index>(1,500);
+  Index cols = internal::random<Index>(1,500);
+  Index ntriplets = internal::random<Index>(20000,100000);
+  std::vector<TripletType> triplets;
+  triplets.reserve(ntriplets);
+  for(Index i=0;i<ntriplets;++i)
+  {
+    StorageIndex r = internal::random<StorageIndex>(0,StorageIndex(rows-1));
+    StorageIndex c = internal::random<StorageIndex>(0,StorageIndex(cols-1));
+    triplets.push_back(TripletType(r,c,internal::random<Scalar>()));
+  }
+
+  // the duplicates are combined in the same order whatever the number of threads
+  int nb_threads = Eigen::nbThreads();
+  Eigen::setNbThreads(1);
+  SparseMatrixType mseq(rows,cols), mseq_last(rows,cols);
+  mseq.setFromTriplets(triplets.begin(), triplets.end());
+  mseq_last.setFromTriplets(triplets.begin(), triplets.end(), std::minus<Scalar>());
+  // several threads even on a single core
+  Eigen::setNbThreads((std::max)(nb_threads, 4));
+
+  SparseMatrixType m(rows,cols);
+  m.reserve(VectorXi::Constant(m.outerSize(), 2));
+  m.setFromTriplets(triplets.begin(), triplets.end());
+  VERIFY(m.isCompressed());
+  VERIFY_IS_EQUAL(m.nonZeros(), mseq.nonZeros());
+  VERIFY_IS_EQUAL(m.toDense(), mseq.toDense());
+  for(Index j=0;j<m.outerSize();++j)
+    for(Index k=m.outerIndexPtr()[j]+1;k<m.outerIndexPtr()[j+1];++k)
+      VERIFY(m.innerIndexPtr()[k-1] < m.innerIndexPtr()[k]);
+
+  m.setFromTriplets(triplets.begin(), triplets.end(), std::minus<Scalar>());
+  VERIFY_IS_EQUAL(m.toDense(), mseq_last.toDense());
+  Eigen::setNbThreads(nb_threads);
+}
 
 void test_sparse_basic()
 {
@@ -671,6 +738,11 @@ void test_sparse_basic()
   CALL_SUBTEST_3((big_sparse_triplet<SparseMatrix<float, RowMajor, int> >(10000, 10000, 0.125)));
   CALL_SUBTEST_4((big_sparse_triplet<SparseMatrix<double, ColMajor, long int> >(10000, 10000, 0.125)));
 
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_3((sparse_triplet_threads<SparseMatrix<float, RowMajor, int> >()));
+    CALL_SUBTEST_4((sparse_triplet_threads<SparseMatrix<std::complex<double>, ColMajor, long int> >()));
+  }
+
   // Regression test for bug 1105
 #ifdef EIGEN_TEST_PART_7
   {
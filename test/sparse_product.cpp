@@ -322,6 +322,68 @@ template<typename SparseMatrixType> void sparse_product()
   }
 }
 
+// products large enough to be multi-threaded when OpenMP is enabled
+template<typename SparseMatrixType> void sparse_product_large()
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  const Index rows  = internal::random<Index>(500,700);
+  const Index cols  = internal::random<Index>(500,700);
+  const Index depth = internal::random<Index>(500,700);
+  double density = 0.05;
+
+  DenseMatrix refMat2 = DenseMatrix::Zero(rows, depth);
+  DenseMatrix refMat3 = DenseMatrix::Zero(depth, cols);
+  DenseMatrix refMat4 = DenseMatrix::Zero(rows, cols);
+  SparseMatrixType m2(rows, depth), m3(depth, cols), m4(rows, cols);
+  initSparse(density, refMat2, m2);
+  initSparse(density, refMat3, m3);
+  // above the threshold of conservative_sparse_sparse_product_threads, with several threads even on a single core
+  VERIFY(m2.nonZeros() + m3.nonZeros() > 20000);
+  int nb_threads = Eigen::nbThreads();
+  Eigen::setNbThreads((std::max)(nb_threads, 4));
+
+  VERIFY_IS_APPROX(m4 = m2*m3, refMat4 = refMat2*refMat3);
+  VERIFY_IS_APPROX(m4 = m2.transpose()*m2, refMat4 = refMat2.transpose()*refMat2);
+
+  // the result does not depend on the number of threads
+  int nb_threads_par = Eigen::nbThreads();
+  Eigen::setNbThreads(1);
+  SparseMatrixType m4seq = m2*m3;
+  Eigen::setNbThreads(nb_threads_par);
+  m4 = m2*m3;
+  VERIFY_IS_EQUAL(m4.nonZeros(), m4seq.nonZeros());
+  VERIFY_IS_APPROX(m4, m4seq);
+
+  // recompute the values only, for operands with the same structure
+  m4.makeCompressed();
+  SparseMatrixType m2b = m2;
+  for(Index k = 0; k < m2b.nonZeros(); ++k)
+    m2b.valuePtr()[k] = internal::random<Scalar>();
+  if(SparseMatrixType::IsRowMajor)
+    internal::conservative_sparse_sparse_product_numeric(m3, m2b, m4);
+  else
+    internal::conservative_sparse_sparse_product_numeric(m2b, m3, m4);
+  VERIFY_IS_EQUAL(m4.nonZeros(), m4seq.nonZeros());
+  VERIFY_IS_APPROX(DenseMatrix(m4), DenseMatrix(m2b)*refMat3);
+
+  // same through a recorded plan, for new values of both operands
+  SparseProductPlan<SparseMatrixType> plan;
+  SparseMatrixType m5;
+  plan.analyzePattern(m2, m3, m5);
+  VERIFY(m5.isCompressed());
+  VERIFY_IS_APPROX(m5, refMat4 = refMat2*refMat3);
+  SparseMatrixType m3b = m3;
+  for(Index k = 0; k < m3b.nonZeros(); ++k)
+    m3b.valuePtr()[k] = internal::random<Scalar>();
+  plan.computeValues(m2b, m3b, m5);
+  VERIFY_IS_EQUAL(m5.nonZeros(), m4seq.nonZeros());
+  VERIFY_IS_APPROX(DenseMatrix(m5), DenseMatrix(m2b)*DenseMatrix(m3b));
+  plan.computeValues(m2, m3, m5);
+  VERIFY_IS_APPROX(m5, m4seq);
+  Eigen::setNbThreads(nb_threads);
+}
+
 // New test for Bug in SparseTimeDenseProduct
 template<typename SparseMatrixType, typename DenseMatrixType> void sparse_product_regression_test()
 {
@@ -378,4 +440,7 @@ void test_sparse_product()
     CALL_SUBTEST_3( (sparse_product<SparseMatrix<float,ColMajor,long int> >()) );
     CALL_SUBTEST_4( (sparse_product_regression_test<SparseMatrix<double,RowMajor>, Matrix<double, Dynamic, Dynamic, RowMajor> >()) );
   }
+  CALL_SUBTEST_5( (sparse_product_large<SparseMatrix<double,ColMajor> >()) );
+  CALL_SUBTEST_5( (sparse_product_large<SparseMatrix<double,RowMajor> >()) );
+  CALL_SUBTEST_5( (sparse_product_large<SparseMatrix<std::complex<double>,ColMajor,long int> >()) );
 }
@@ -101,6 +101,102 @@ template<typename Scalar> void sparse_solvers(int rows, int cols)
   }
 }
 
+// the plan declines the systems which are not worth solving in parallel, x being then left unchanged
+#define CHECK_PLAN_SOLVE(PLAN_SOLVE, FALLBACK_SOLVE, REF) { \
+    x = b; \
+    if(!PLAN_SOLVE) { \
+      VERIFY_IS_EQUAL(x, b); \
+      FALLBACK_SOLVE; \
+    } \
+    VERIFY_IS_APPROX(x, REF); \
+  }
+
+template<typename Scalar, int Options> void sparse_triangular_solve_plan(int size, int rhsCols)
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef SparseMatrix<Scalar,Options> SparseMatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  double density = (std::max)(8./(size*size), 0.01);
+
+  // both triangular parts are stored: the plan must only read the selected one
+  SparseMatrixType m(size, size);
+  DenseMatrix refMat = DenseMatrix::Zero(size, size);
+  initSparse<Scalar>(density, refMat, m, ForceNonZeroDiag);
+  for(int i = 0; i < size; ++i)
+    m.coeffRef(i,i) = refMat(i,i) = refMat(i,i) + Scalar(RealScalar(4));
+  m.makeCompressed();
+  DenseMatrix b = DenseMatrix::Random(size, rhsCols), x;
+
+  TriangularSolvePlan<SparseMatrixType> plan;
+  plan.analyzePattern(m, Lower);
+  VERIFY_IS_EQUAL(plan.rows(), Index(size));
+  VERIFY(plan.levels()>=1 && plan.levels()<=size);
+  CHECK_PLAN_SOLVE(plan.solveInPlace(m, x), m.template triangularView<Lower>().solveInPlace(x),
+                   refMat.template triangularView<Lower>().solve(b));
+  CHECK_PLAN_SOLVE(plan.transposeSolveInPlace(m, x), m.transpose().template triangularView<Upper>().solveInPlace(x),
+                   refMat.transpose().template triangularView<Upper>().solve(b));
+  CHECK_PLAN_SOLVE(plan.adjointSolveInPlace(m, x), m.adjoint().template triangularView<Upper>().solveInPlace(x),
+                   refMat.adjoint().template triangularView<Upper>().solve(b));
+
+  plan.analyzePattern(m, UnitUpper);
+  CHECK_PLAN_SOLVE(plan.solveInPlace(m, x), m.template triangularView<UnitUpper>().solveInPlace(x),
+                   refMat.template triangularView<UnitUpper>().solve(b));
+  CHECK_PLAN_SOLVE(plan.adjointSolveInPlace(m, x), m.adjoint().template triangularView<UnitLower>().solveInPlace(x),
+                   refMat.adjoint().template triangularView<UnitLower>().solve(b));
+
+  // the plan only depends on the pattern
+  m.coeffs() *= Scalar(RealScalar(2));
+  refMat *= Scalar(RealScalar(2));
+  CHECK_PLAN_SOLVE(plan.solveInPlace(m, x), m.template triangularView<UnitUpper>().solveInPlace(x),
+                   refMat.template triangularView<UnitUpper>().solve(b));
+}
+
+// a lower triangular matrix with two wide levels, such that the plan is solved in parallel
+template<typename Scalar> void sparse_triangular_solve_plan_parallel(int size)
+{
+  typedef SparseMatrix<Scalar> SparseMatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i = 0; i < size; ++i)
+  {
+    triplets.push_back(Triplet<Scalar>(i, i, Scalar(4)));
+    if(i >= size/2)
+      for(int k = 0; k < 8; ++k)
+        triplets.push_back(Triplet<Scalar>(i, internal::random<int>(0,size/2-1), internal::random<Scalar>()));
+  }
+  SparseMatrixType m(size, size);
+  m.setFromTriplets(triplets.begin(), triplets.end());
+  DenseMatrix b = DenseMatrix::Random(size, 4), x;
+
+  int nb_threads = Eigen::nbThreads();
+  Eigen::setNbThreads(4);
+  TriangularSolvePlan<SparseMatrixType> plan;
+#ifdef EIGEN_HAS_OPENMP
+  VERIFY(TriangularSolvePlan<SparseMatrixType>::worthAnalyzing(m));
+#else
+  VERIFY(!TriangularSolvePlan<SparseMatrixType>::worthAnalyzing(m));
+#endif
+  plan.analyzePattern(m, Lower);
+  VERIFY_IS_EQUAL(plan.levels(), 2);
+  x = b;
+#ifdef EIGEN_HAS_OPENMP
+  VERIFY(plan.solveInPlace(m, x));
+  VERIFY_IS_APPROX(x, DenseMatrix(m).template triangularView<Lower>().solve(b));
+  x = b;
+  VERIFY(plan.adjointSolveInPlace(m, x));
+  VERIFY_IS_APPROX(x, DenseMatrix(m).adjoint().template triangularView<Upper>().solve(b));
+#else
+  VERIFY(!plan.solveInPlace(m, x));
+  VERIFY_IS_EQUAL(x, b);
+#endif
+
+  // a single thread always falls back to the sequential substitutions
+  Eigen::setNbThreads(1);
+  VERIFY(!TriangularSolvePlan<SparseMatrixType>::worthAnalyzing(m));
+  VERIFY(!plan.solveInPlace(m, x));
+  Eigen::setNbThreads(nb_threads);
+}
+
 void test_sparse_solvers()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -108,5 +204,10 @@ void test_sparse_solvers()
     int s = internal::random<int>(1,300);
     CALL_SUBTEST_2(sparse_solvers<std::complex<double> >(s,s) );
     CALL_SUBTEST_1(sparse_solvers<double>(s,s) );
+    CALL_SUBTEST_3(( sparse_triangular_solve_plan<double,ColMajor>(s, internal::random<int>(1,4)) ));
+    CALL_SUBTEST_3(( sparse_triangular_solve_plan<std::complex<double>,RowMajor>(s, internal::random<int>(1,4)) ));
+    CALL_SUBTEST_3(( sparse_triangular_solve_plan<double,RowMajor>(internal::random<int>(1000,3000), 3) ));
   }
+  CALL_SUBTEST_3(( sparse_triangular_solve_plan_parallel<double>(4000) ));
+  CALL_SUBTEST_3(( sparse_triangular_solve_plan_parallel<std::complex<double> >(3000) ));
 }
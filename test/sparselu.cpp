@@ -24,10 +24,14 @@ template<typename T> void test_sparselu_T()
   SparseLU<SparseMatrix<T, ColMajor> /*, COLAMDOrdering<int>*/ > sparselu_colamd; // COLAMDOrdering is the default
   SparseLU<SparseMatrix<T, ColMajor>, AMDOrdering<int> > sparselu_amd; 
   SparseLU<SparseMatrix<T, ColMajor, long int>, NaturalOrdering<long int> > sparselu_natural;
+  SparseLU<SparseMatrix<T, ColMajor>, RCMOrdering<int> > sparselu_rcm;
+  SparseLU<SparseMatrix<T, ColMajor, long int>, NestedDissectionOrdering<long int> > sparselu_nd;
   
   check_sparse_square_solving(sparselu_colamd,  300, 100000, true); 
   check_sparse_square_solving(sparselu_amd,     300,  10000, true);
   check_sparse_square_solving(sparselu_natural, 300,   2000, true);
+  check_sparse_square_solving(sparselu_rcm,     300,   2000, true);
+  check_sparse_square_solving(sparselu_nd,      300,  10000, true);
   
   check_sparse_square_abs_determinant(sparselu_colamd);
   check_sparse_square_abs_determinant(sparselu_amd);
@@ -0,0 +1,309 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_CXX11_BATCHED_KERNELS_H
+#define EIGEN_CXX11_BATCHED_KERNELS_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * Number of matrices processed together by the batched kernels. A few packets per coefficient
+  * give the compiler enough independent instructions to hide the latencies.
+  */
+template<typename Scalar>
+struct batched_lanes
+{
+  enum { value = 4 * packet_traits<Scalar>::size };
+};
+
+/** \internal
+  * \class batched_block
+  * A group of Lanes matrices of size Rows x Cols. Each coefficient is stored as a fixed-size array
+  * over the lanes, so that the arithmetic on a coefficient is performed on all the matrices at once
+  * with packet operations.
+  */
+template<typename Scalar, int Rows, int Cols>
+struct batched_block
+{
+  enum { Lanes = batched_lanes<Scalar>::value };
+  typedef Array<Scalar,Lanes,1> Lane;
+  typedef Array<bool,Lanes,1> Mask;
+
+  Lane& operator()(Index i, Index j) { return m_coeffs[i+Rows*j]; }
+  const Lane& operator()(Index i, Index j) const { return m_coeffs[i+Rows*j]; }
+
+  /** Loads the \a count matrices starting at \a first from the structure-of-arrays \a data holding \a batch
+    * matrices. If \a count is smaller than Lanes, the remaining lanes are filled with the identity so that
+    * they remain harmless. */
+  void load(const Scalar* data, Index batch, Index first, Index count)
+  {
+    for(Index j = 0; j < Cols; ++j)
+    {
+      for(Index i = 0; i < Rows; ++i)
+      {
+        const Scalar* src = data + (i+Rows*j)*batch + first;
+        Lane& dst = (*this)(i,j);
+        if(count == Lanes)
+          dst = Map<const Lane>(src);
+        else
+        {
+          dst.setConstant(i==j ? Scalar(1) : Scalar(0));
+          dst.head(count) = Map<const Array<Scalar,Dynamic,1> >(src, count);
+        }
+      }
+    }
+  }
+
+  /** Stores the \a count first lanes into the structure-of-arrays \a data, see load() */
+  void store(Scalar* data, Index batch, Index first, Index count) const
+  {
+    for(Index j = 0; j < Cols; ++j)
+    {
+      for(Index i = 0; i < Rows; ++i)
+      {
+        Map<Array<Scalar,Dynamic,1> > dst(data + (i+Rows*j)*batch + first, count);
+        dst = (*this)(i,j).head(count);
+      }
+    }
+  }
+
+  Lane m_coeffs[Rows*Cols];
+};
+
+/** \internal Lane-wise matrix product: dst = lhs * rhs */
+template<typename Scalar, int Rows, int Depth, int Cols>
+void batched_product(const batched_block<Scalar,Rows,Depth>& lhs, const batched_block<Scalar,Depth,Cols>& rhs,
+                     batched_block<Scalar,Rows,Cols>& dst)
+{
+  for(Index j = 0; j < Cols; ++j)
+  {
+    for(Index i = 0; i < Rows; ++i)
+    {
+      typename batched_block<Scalar,Rows,Cols>::Lane acc = lhs(i,0) * rhs(0,j);
+      for(Index k = 1; k < Depth; ++k)
+        acc += lhs(i,k) * rhs(k,j);
+      dst(i,j) = acc;
+    }
+  }
+}
+
+/** \internal
+  * Lane-wise Cholesky factorization, following llt_inplace::unblocked: the lower triangular part of \a mat
+  * is overwritten by \b L such that \b A = \b L \b L<sup>*</sup>, and the strictly upper part is set to zero.
+  * The lanes of \a ok corresponding to non positive definite matrices are set to false.
+  */
+template<typename Scalar, int Size>
+void batched_llt_inplace(batched_block<Scalar,Size,Size>& mat, typename batched_block<Scalar,Size,Size>::Mask& ok)
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef typename batched_block<Scalar,Size,Size>::Lane Lane;
+
+  ok.setConstant(true);
+  for(Index j = 0; j < Size; ++j)
+  {
+    Lane x = mat(j,j);
+    for(Index k = 0; k < j; ++k)
+      x -= mat(j,k) * mat(j,k).conjugate();
+    ok = ok && (x.real() > RealScalar(0));
+    mat(j,j) = x.sqrt();
+
+    for(Index i = j+1; i < Size; ++i)
+    {
+      Lane s = mat(i,j);
+      for(Index k = 0; k < j; ++k)
+        s -= mat(i,k) * mat(j,k).conjugate();
+      mat(i,j) = s / mat(j,j);
+    }
+    for(Index i = 0; i < j; ++i)
+      mat(i,j).setZero();
+  }
+}
+
+/** \internal Lane-wise solve of \b L \b L<sup>*</sup> x = b in place, given the factor computed by batched_llt_inplace */
+template<typename Scalar, int Size>
+void batched_llt_solve_inplace(const batched_block<Scalar,Size,Size>& llt, batched_block<Scalar,Size,1>& b)
+{
+  typedef typename batched_block<Scalar,Size,1>::Lane Lane;
+
+  for(Index i = 0; i < Size; ++i)
+  {
+    Lane s = b(i,0);
+    for(Index k = 0; k < i; ++k)
+      s -= llt(i,k) * b(k,0);
+    b(i,0) = s / llt(i,i);
+  }
+  for(Index i = Size-1; i >= 0; --i)
+  {
+    Lane s = b(i,0);
+    for(Index k = i+1; k < Size; ++k)
+      s -= llt(k,i).conjugate() * b(k,0);
+    b(i,0) = s / llt(i,i).conjugate();
+  }
+}
+
+/** \internal
+  * Lane-wise LU factorization with partial pivoting, following partial_lu_impl::unblocked_lu.
+  * The pivot search and the row interchanges depend on the lane and are performed lane by lane,
+  * while the elimination, which dominates the cost, is performed on all the lanes at once.
+  * The row transpositions are stored in \a transpositions, and the lanes of \a ok corresponding
+  * to exactly singular matrices are set to false.
+  */
+template<typename Scalar, int Size>
+void batched_partial_lu_inplace(batched_block<Scalar,Size,Size>& lu,
+                                Array<int,batched_lanes<Scalar>::value,1>* transpositions,
+                                typename batched_block<Scalar,Size,Size>::Mask& ok)
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef typename batched_block<Scalar,Size,Size>::Lane Lane;
+  enum { Lanes = batched_block<Scalar,Size,Size>::Lanes };
+
+  ok.setConstant(true);
+  for(Index k = 0; k < Size; ++k)
+  {
+    for(Index l = 0; l < Lanes; ++l)
+    {
+      Index p = k;
+      RealScalar biggest = numext::abs(lu(k,k).coeff(l));
+      for(Index i = k+1; i < Size; ++i)
+      {
+        RealScalar a = numext::abs(lu(i,k).coeff(l));
+        if(a > biggest)
+        {
+          biggest = a;
+          p = i;
+        }
+      }
+      transpositions[k].coeffRef(l) = int(p);
+      if(p != k)
+        for(Index j = 0; j < Size; ++j)
+          std::swap(lu(k,j).coeffRef(l), lu(p,j).coeffRef(l));
+    }
+
+    ok = ok && (lu(k,k) != Scalar(0));
+    Lane inv = lu(k,k).inverse();
+    for(Index i = k+1; i < Size; ++i)
+      lu(i,k) *= inv;
+    for(Index j = k+1; j < Size; ++j)
+      for(Index i = k+1; i < Size; ++i)
+        lu(i,j) -= lu(i,k) * lu(k,j);
+  }
+}
+
+/** \internal Lane-wise solve of \b A x = b in place, given the factorization computed by batched_partial_lu_inplace */
+template<typename Scalar, int Size>
+void batched_partial_lu_solve_inplace(const batched_block<Scalar,Size,Size>& lu,
+                                      const Array<int,batched_lanes<Scalar>::value,1>* transpositions,
+                                      batched_block<Scalar,Size,1>& b)
+{
+  typedef typename batched_block<Scalar,Size,1>::Lane Lane;
+  enum { Lanes = batched_block<Scalar,Size,1>::Lanes };
+
+  for(Index k = 0; k < Size; ++k)
+    for(Index l = 0; l < Lanes; ++l)
+      if(transpositions[k].coeff(l) != k)
+        std::swap(b(k,0).coeffRef(l), b(transpositions[k].coeff(l),0).coeffRef(l));
+
+  for(Index i = 1; i < Size; ++i)
+  {
+    Lane s = b(i,0);
+    for(Index k = 0; k < i; ++k)
+      s -= lu(i,k) * b(k,0);
+    b(i,0) = s;
+  }
+  for(Index i = Size-1; i >= 0; --i)
+  {
+    Lane s = b(i,0);
+    for(Index k = i+1; k < Size; ++k)
+      s -= lu(i,k) * b(k,0);
+    b(i,0) = s / lu(i,i);
+  }
+}
+
+/** \internal Lane-wise inverse. Small sizes use the cofactor formulas of InverseImpl.h, which do not
+  * need any pivoting, larger ones go through the LU factorization. */
+template<typename Scalar, int Size>
+struct batched_inverse
+{
+  static void run(const batched_block<Scalar,Size,Size>& mat, batched_block<Scalar,Size,Size>& result)
+  {
+    batched_block<Scalar,Size,Size> lu = mat;
+    Array<int,batched_lanes<Scalar>::value,1> transpositions[Size];
+    typename batched_block<Scalar,Size,Size>::Mask ok;
+    batched_partial_lu_inplace(lu, transpositions, ok);
+    for(Index j = 0; j < Size; ++j)
+    {
+      batched_block<Scalar,Size,1> col;
+      for(Index i = 0; i < Size; ++i)
+        col(i,0).setConstant(i==j ? Scalar(1) : Scalar(0));
+      batched_partial_lu_solve_inplace(lu, transpositions, col);
+      for(Index i = 0; i < Size; ++i)
+        result(i,j) = col(i,0);
+    }
+  }
+};
+
+template<typename Scalar>
+struct batched_inverse<Scalar,1>
+{
+  static void run(const batched_block<Scalar,1,1>& mat, batched_block<Scalar,1,1>& result)
+  {
+    result(0,0) = mat(0,0).inverse();
+  }
+};
+
+template<typename Scalar>
+struct batched_inverse<Scalar,2>
+{
+  static void run(const batched_block<Scalar,2,2>& mat, batched_block<Scalar,2,2>& result)
+  {
+    typedef typename batched_block<Scalar,2,2>::Lane Lane;
+    const Lane invdet = (mat(0,0) * mat(1,1) - mat(0,1) * mat(1,0)).inverse();
+    const Lane a00 = mat(0,0);
+    result(0,0) =  mat(1,1) * invdet;
+    result(1,0) = -mat(1,0) * invdet;
+    result(0,1) = -mat(0,1) * invdet;
+    result(1,1) =  a00 * invdet;
+  }
+};
+
+template<typename Scalar>
+struct batched_inverse<Scalar,3>
+{
+  typedef typename batched_block<Scalar,3,3>::Lane Lane;
+
+  static Lane cofactor(const batched_block<Scalar,3,3>& m, Index i, Index j)
+  {
+    Index i1 = (i+1) % 3, i2 = (i+2) % 3;
+    Index j1 = (j+1) % 3, j2 = (j+2) % 3;
+    return m(i1,j1) * m(i2,j2) - m(i1,j2) * m(i2,j1);
+  }
+
+  static void run(const batched_block<Scalar,3,3>& mat, batched_block<Scalar,3,3>& result)
+  {
+    Lane cofactors_col0[3];
+    for(Index i = 0; i < 3; ++i)
+      cofactors_col0[i] = cofactor(mat, i, 0);
+    const Lane invdet = (mat(0,0) * cofactors_col0[0] + mat(1,0) * cofactors_col0[1]
+                       + mat(2,0) * cofactors_col0[2]).inverse();
+    batched_block<Scalar,3,3> tmp;
+    for(Index i = 0; i < 3; ++i)
+    {
+      tmp(0,i) = cofactors_col0[i] * invdet;
+      tmp(1,i) = cofactor(mat, i, 1) * invdet;
+      tmp(2,i) = cofactor(mat, i, 2) * invdet;
+    }
+    result = tmp;
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_CXX11_BATCHED_KERNELS_H
@@ -0,0 +1,410 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_CXX11_BATCHED_LINEAR_ALGEBRA_H
+#define EIGEN_CXX11_BATCHED_LINEAR_ALGEBRA_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * Runs \a kernel over the groups of lanes [0, groups). The generic version runs on the calling thread.
+  */
+template<typename Device>
+struct batched_executor
+{
+  template<typename Kernel>
+  static void run(const Device&, Index groups, const TensorOpCost&, const Kernel& kernel)
+  {
+    kernel(0, groups);
+  }
+};
+
+#ifdef EIGEN_USE_THREADS
+template<>
+struct batched_executor<ThreadPoolDevice>
+{
+  template<typename Kernel>
+  static void run(const ThreadPoolDevice& device, Index groups, const TensorOpCost& cost, const Kernel& kernel)
+  {
+    device.parallelFor(groups, cost, kernel);
+  }
+};
+#endif
+
+template<typename TensorType, int Rank>
+struct batched_check_tensor
+{
+  typedef typename internal::remove_const<typename internal::traits<TensorType>::Scalar>::type Scalar;
+  static void run(const TensorType& t)
+  {
+    EIGEN_STATIC_ASSERT(int(internal::traits<TensorType>::NumDimensions) == Rank, YOU_MADE_A_PROGRAMMING_MISTAKE);
+    EIGEN_STATIC_ASSERT(int(internal::traits<TensorType>::Layout) == int(ColMajor), YOU_MADE_A_PROGRAMMING_MISTAKE);
+    EIGEN_UNUSED_VARIABLE(t);
+  }
+  static Scalar* data(const TensorType& t) { return const_cast<Scalar*>(t.data()); }
+};
+
+template<typename Scalar, int Rows, int Cols>
+TensorOpCost batched_cost(Index flopsPerMatrix, Index matricesIn, Index matricesOut)
+{
+  enum { Lanes = batched_lanes<Scalar>::value };
+  const double bytes = double(Lanes * Rows * Cols * sizeof(Scalar));
+  return TensorOpCost(matricesIn * bytes, matricesOut * bytes,
+                      double(flopsPerMatrix * Lanes) / double(packet_traits<Scalar>::size),
+                      true, packet_traits<Scalar>::size);
+}
+
+template<typename Scalar, int Rows, int Depth, int Cols>
+struct batched_product_kernel
+{
+  void operator()(Index firstGroup, Index lastGroup) const
+  {
+    enum { Lanes = batched_lanes<Scalar>::value };
+    for(Index g = firstGroup; g < lastGroup; ++g)
+    {
+      Index first = g*Lanes, count = numext::mini<Index>(Lanes, m_batch-first);
+      batched_block<Scalar,Rows,Depth> lhs;
+      batched_block<Scalar,Depth,Cols> rhs;
+      batched_block<Scalar,Rows,Cols> dst;
+      lhs.load(m_lhs, m_batch, first, count);
+      rhs.load(m_rhs, m_batch, first, count);
+      batched_product(lhs, rhs, dst);
+      dst.store(m_dst, m_batch, first, count);
+    }
+  }
+  const Scalar* m_lhs;
+  const Scalar* m_rhs;
+  Scalar* m_dst;
+  Index m_batch;
+};
+
+template<typename Scalar, int Size>
+struct batched_inverse_kernel
+{
+  void operator()(Index firstGroup, Index lastGroup) const
+  {
+    enum { Lanes = batched_lanes<Scalar>::value };
+    for(Index g = firstGroup; g < lastGroup; ++g)
+    {
+      Index first = g*Lanes, count = numext::mini<Index>(Lanes, m_batch-first);
+      batched_block<Scalar,Size,Size> mat, inv;
+      mat.load(m_src, m_batch, first, count);
+      batched_inverse<Scalar,Size>::run(mat, inv);
+      inv.store(m_dst, m_batch, first, count);
+    }
+  }
+  const Scalar* m_src;
+  Scalar* m_dst;
+  Index m_batch;
+};
+
+template<typename Scalar, int Size>
+struct batched_llt_kernel
+{
+  void operator()(Index firstGroup, Index lastGroup) const
+  {
+    enum { Lanes = batched_lanes<Scalar>::value };
+    for(Index g = firstGroup; g < lastGroup; ++g)
+    {
+      Index first = g*Lanes, count = numext::mini<Index>(Lanes, m_batch-first);
+      batched_block<Scalar,Size,Size> mat;
+      typename batched_block<Scalar,Size,Size>::Mask ok;
+      mat.load(m_mat, m_batch, first, count);
+      batched_llt_inplace(mat, ok);
+      mat.store(m_mat, m_batch, first, count);
+      for(Index l = 0; l < count; ++l)
+        m_info[first+l] = ok.coeff(l) ? Success : NumericalIssue;
+    }
+  }
+  Scalar* m_mat;
+  ComputationInfo* m_info;
+  Index m_batch;
+};
+
+template<typename Scalar, int Size>
+struct batched_llt_solve_kernel
+{
+  void operator()(Index firstGroup, Index lastGroup) const
+  {
+    enum { Lanes = batched_lanes<Scalar>::value };
+    for(Index g = firstGroup; g < lastGroup; ++g)
+    {
+      Index first = g*Lanes, count = numext::mini<Index>(Lanes, m_batch-first);
+      batched_block<Scalar,Size,Size> llt;
+      llt.load(m_llt, m_batch, first, count);
+      for(Index c = 0; c < m_rhsCols; ++c)
+      {
+        batched_block<Scalar,Size,1> b;
+        Scalar* rhs = m_rhs + c*Size*m_batch;
+        b.load(rhs, m_batch, first, count);
+        batched_llt_solve_inplace(llt, b);
+        b.store(rhs, m_batch, first, count);
+      }
+    }
+  }
+  const Scalar* m_llt;
+  Scalar* m_rhs;
+  Index m_batch, m_rhsCols;
+};
+
+template<typename Scalar, int Size>
+struct batched_partial_lu_kernel
+{
+  void operator()(Index firstGroup, Index lastGroup) const
+  {
+    enum { Lanes = batched_lanes<Scalar>::value };
+    for(Index g = firstGroup; g < lastGroup; ++g)
+    {
+      Index first = g*Lanes, count = numext::mini<Index>(Lanes, m_batch-first);
+      batched_block<Scalar,Size,Size> lu;
+      Array<int,Lanes,1> transpositions[Size];
+      typename batched_block<Scalar,Size,Size>::Mask ok;
+      lu.load(m_lu, m_batch, first, count);
+      batched_partial_lu_inplace(lu, transpositions, ok);
+      lu.store(m_lu, m_batch, first, count);
+      for(Index k = 0; k < Size; ++k)
+        Map<Array<int,Dynamic,1> >(m_transpositions + k*m_batch + first, count) = transpositions[k].head(count);
+      for(Index l = 0; l < count; ++l)
+        m_info[first+l] = ok.coeff(l) ? Success : NumericalIssue;
+    }
+  }
+  Scalar* m_lu;
+  int* m_transpositions;
+  ComputationInfo* m_info;
+  Index m_batch;
+};
+
+template<typename Scalar, int Size>
+struct batched_partial_lu_solve_kernel
+{
+  void operator()(Index firstGroup, Index lastGroup) const
+  {
+    enum { Lanes = batched_lanes<Scalar>::value };
+    for(Index g = firstGroup; g < lastGroup; ++g)
+    {
+      Index first = g*Lanes, count = numext::mini<Index>(Lanes, m_batch-first);
+      batched_block<Scalar,Size,Size> lu;
+      Array<int,Lanes,1> transpositions[Size];
+      lu.load(m_lu, m_batch, first, count);
+      for(Index k = 0; k < Size; ++k)
+      {
+        // the padding lanes hold the identity, which does not need any interchange
+        transpositions[k].setConstant(int(k));
+        transpositions[k].head(count) = Map<const Array<int,Dynamic,1> >(m_transpositions + k*m_batch + first, count);
+      }
+      for(Index c = 0; c < m_rhsCols; ++c)
+      {
+        batched_block<Scalar,Size,1> b;
+        Scalar* rhs = m_rhs + c*Size*m_batch;
+        b.load(rhs, m_batch, first, count);
+        batched_partial_lu_solve_inplace(lu, transpositions, b);
+        b.store(rhs, m_batch, first, count);
+      }
+    }
+  }
+  const Scalar* m_lu;
+  const int* m_transpositions;
+  Scalar* m_rhs;
+  Index m_batch, m_rhsCols;
+};
+
+template<typename Scalar>
+Index batched_groups(Index batch)
+{
+  enum { Lanes = batched_lanes<Scalar>::value };
+  return (batch + Lanes - 1) / Lanes;
+}
+
+} // end namespace internal
+
+/** \ingroup CXX11_BatchedLinearAlgebra_Module
+  *
+  * Computes the products \c dst(k) = \c lhs(k) * \c rhs(k) of all the matrices of the batches.
+  *
+  * \param device the device used to run the computation, such as DefaultDevice or ThreadPoolDevice
+  * \param lhs a tensor of dimensions (batch, Rows, Depth)
+  * \param rhs a tensor of dimensions (batch, Depth, Cols)
+  * \param dst a tensor of dimensions (batch, Rows, Cols), it may alias \a lhs or \a rhs if the sizes match
+  */
+template<int Rows, int Depth, int Cols, typename Device, typename Lhs, typename Rhs, typename Dst>
+void batchedProduct(const Device& device, const Lhs& lhs, const Rhs& rhs, const Dst& dst)
+{
+  typedef typename internal::batched_check_tensor<Dst,3>::Scalar Scalar;
+  internal::batched_check_tensor<Lhs,3>::run(lhs);
+  internal::batched_check_tensor<Rhs,3>::run(rhs);
+  internal::batched_check_tensor<Dst,3>::run(dst);
+  const Index batch = dst.dimension(0);
+  eigen_assert(lhs.dimension(0) == batch && lhs.dimension(1) == Rows && lhs.dimension(2) == Depth);
+  eigen_assert(rhs.dimension(0) == batch && rhs.dimension(1) == Depth && rhs.dimension(2) == Cols);
+  eigen_assert(dst.dimension(1) == Rows && dst.dimension(2) == Cols);
+
+  internal::batched_product_kernel<Scalar,Rows,Depth,Cols> kernel;
+  kernel.m_lhs = lhs.data();
+  kernel.m_rhs = rhs.data();
+  kernel.m_dst = internal::batched_check_tensor<Dst,3>::data(dst);
+  kernel.m_batch = batch;
+  internal::batched_executor<Device>::run(device, internal::batched_groups<Scalar>(batch),
+      internal::batched_cost<Scalar,Rows,Cols>(2*Rows*Depth*Cols, 2, 1), kernel);
+}
+
+/** \ingroup CXX11_BatchedLinearAlgebra_Module
+  *
+  * Computes the inverses of all the matrices of the batch \a src into \a dst.
+  * If a matrix is not invertible, the coefficients of its inverse are undefined.
+  *
+  * \param device the device used to run the computation, such as DefaultDevice or ThreadPoolDevice
+  * \param src a tensor of dimensions (batch, Size, Size)
+  * \param dst a tensor of dimensions (batch, Size, Size), it may alias \a src
+  */
+template<int Size, typename Device, typename Src, typename Dst>
+void batchedInverse(const Device& device, const Src& src, const Dst& dst)
+{
+  typedef typename internal::batched_check_tensor<Dst,3>::Scalar Scalar;
+  internal::batched_check_tensor<Src,3>::run(src);
+  internal::batched_check_tensor<Dst,3>::run(dst);
+  const Index batch = dst.dimension(0);
+  eigen_assert(src.dimension(0) == batch && src.dimension(1) == Size && src.dimension(2) == Size);
+  eigen_assert(dst.dimension(1) == Size && dst.dimension(2) == Size);
+
+  internal::batched_inverse_kernel<Scalar,Size> kernel;
+  kernel.m_src = src.data();
+  kernel.m_dst = internal::batched_check_tensor<Dst,3>::data(dst);
+  kernel.m_batch = batch;
+  internal::batched_executor<Device>::run(device, internal::batched_groups<Scalar>(batch),
+      internal::batched_cost<Scalar,Size,Size>(2*Size*Size*Size, 1, 1), kernel);
+}
+
+/** \ingroup CXX11_BatchedLinearAlgebra_Module
+  *
+  * Computes in place the Cholesky factorizations \b A = \b L \b L<sup>*</sup> of all the matrices of a batch.
+  * Only the lower triangular part of the matrices is referenced. It is overwritten by the factor \b L while
+  * the strictly upper triangular part is set to zero.
+  *
+  * \param device the device used to run the computation, such as DefaultDevice or ThreadPoolDevice
+  * \param matrices a tensor of dimensions (batch, Size, Size)
+  * \param info a rank-1 tensor of ComputationInfo of dimension batch, set to NumericalIssue for the
+  *             matrices which are not positive definite, and to Success otherwise.
+  *
+  * \sa batchedLLTSolve(), class LLT
+  */
+template<int Size, typename Device, typename Matrices, typename Info>
+void batchedLLT(const Device& device, const Matrices& matrices, const Info& info)
+{
+  typedef typename internal::batched_check_tensor<Matrices,3>::Scalar Scalar;
+  internal::batched_check_tensor<Matrices,3>::run(matrices);
+  internal::batched_check_tensor<Info,1>::run(info);
+  const Index batch = matrices.dimension(0);
+  eigen_assert(matrices.dimension(1) == Size && matrices.dimension(2) == Size);
+  eigen_assert(info.dimension(0) == batch);
+
+  internal::batched_llt_kernel<Scalar,Size> kernel;
+  kernel.m_mat = internal::batched_check_tensor<Matrices,3>::data(matrices);
+  kernel.m_info = internal::batched_check_tensor<Info,1>::data(info);
+  kernel.m_batch = batch;
+  internal::batched_executor<Device>::run(device, internal::batched_groups<Scalar>(batch),
+      internal::batched_cost<Scalar,Size,Size>(Size*Size*Size/3, 1, 1), kernel);
+}
+
+/** \ingroup CXX11_BatchedLinearAlgebra_Module
+  *
+  * Solves in place the systems \b A x = b for all the matrices of a batch, given their Cholesky factors.
+  *
+  * \param device the device used to run the computation, such as DefaultDevice or ThreadPoolDevice
+  * \param factors a tensor of dimensions (batch, Size, Size) as computed by batchedLLT()
+  * \param rhs a tensor of dimensions (batch, Size, cols), overwritten by the solutions
+  */
+template<int Size, typename Device, typename Factors, typename Rhs>
+void batchedLLTSolve(const Device& device, const Factors& factors, const Rhs& rhs)
+{
+  typedef typename internal::batched_check_tensor<Rhs,3>::Scalar Scalar;
+  internal::batched_check_tensor<Factors,3>::run(factors);
+  internal::batched_check_tensor<Rhs,3>::run(rhs);
+  const Index batch = rhs.dimension(0);
+  eigen_assert(factors.dimension(0) == batch && factors.dimension(1) == Size && factors.dimension(2) == Size);
+  eigen_assert(rhs.dimension(1) == Size);
+
+  internal::batched_llt_solve_kernel<Scalar,Size> kernel;
+  kernel.m_llt = factors.data();
+  kernel.m_rhs = internal::batched_check_tensor<Rhs,3>::data(rhs);
+  kernel.m_batch = batch;
+  kernel.m_rhsCols = rhs.dimension(2);
+  internal::batched_executor<Device>::run(device, internal::batched_groups<Scalar>(batch),
+      internal::batched_cost<Scalar,Size,Size>(2*Size*Size*rhs.dimension(2), 1, 0), kernel);
+}
+
+/** \ingroup CXX11_BatchedLinearAlgebra_Module
+  *
+  * Computes in place the LU factorizations with partial pivoting \b P \b A = \b L \b U of all the matrices
+  * of a batch. The strictly lower part of the matrices is overwritten by \b L, whose diagonal is
+  * made of ones, and the upper part by \b U.
+  *
+  * \param device the device used to run the computation, such as DefaultDevice or ThreadPoolDevice
+  * \param matrices a tensor of dimensions (batch, Size, Size)
+  * \param transpositions a tensor of int of dimensions (batch, Size) receiving the row interchanges:
+  *                       at step k, the row k has been swapped with the row transpositions(b,k).
+  * \param info a rank-1 tensor of ComputationInfo of dimension batch, set to NumericalIssue for the
+  *             matrices which are exactly singular, and to Success otherwise.
+  *
+  * \sa batchedPartialPivLUSolve(), class PartialPivLU
+  */
+template<int Size, typename Device, typename Matrices, typename Transpositions, typename Info>
+void batchedPartialPivLU(const Device& device, const Matrices& matrices, const Transpositions& transpositions, const Info& info)
+{
+  typedef typename internal::batched_check_tensor<Matrices,3>::Scalar Scalar;
+  internal::batched_check_tensor<Matrices,3>::run(matrices);
+  internal::batched_check_tensor<Transpositions,2>::run(transpositions);
+  internal::batched_check_tensor<Info,1>::run(info);
+  const Index batch = matrices.dimension(0);
+  eigen_assert(matrices.dimension(1) == Size && matrices.dimension(2) == Size);
+  eigen_assert(transpositions.dimension(0) == batch && transpositions.dimension(1) == Size);
+  eigen_assert(info.dimension(0) == batch);
+
+  internal::batched_partial_lu_kernel<Scalar,Size> kernel;
+  kernel.m_lu = internal::batched_check_tensor<Matrices,3>::data(matrices);
+  kernel.m_transpositions = internal::batched_check_tensor<Transpositions,2>::data(transpositions);
+  kernel.m_info = internal::batched_check_tensor<Info,1>::data(info);
+  kernel.m_batch = batch;
+  internal::batched_executor<Device>::run(device, internal::batched_groups<Scalar>(batch),
+      internal::batched_cost<Scalar,Size,Size>(2*Size*Size*Size/3, 1, 1), kernel);
+}
+
+/** \ingroup CXX11_BatchedLinearAlgebra_Module
+  *
+  * Solves in place the systems \b A x = b for all the matrices of a batch, given their LU factorizations.
+  *
+  * \param device the device used to run the computation, such as DefaultDevice or ThreadPoolDevice
+  * \param lu a tensor of dimensions (batch, Size, Size) as computed by batchedPartialPivLU()
+  * \param transpositions the row interchanges computed by batchedPartialPivLU()
+  * \param rhs a tensor of dimensions (batch, Size, cols), overwritten by the solutions
+  */
+template<int Size, typename Device, typename Factors, typename Transpositions, typename Rhs>
+void batchedPartialPivLUSolve(const Device& device, const Factors& lu, const Transpositions& transpositions, const Rhs& rhs)
+{
+  typedef typename internal::batched_check_tensor<Rhs,3>::Scalar Scalar;
+  internal::batched_check_tensor<Factors,3>::run(lu);
+  internal::batched_check_tensor<Transpositions,2>::run(transpositions);
+  internal::batched_check_tensor<Rhs,3>::run(rhs);
+  const Index batch = rhs.dimension(0);
+  eigen_assert(lu.dimension(0) == batch && lu.dimension(1) == Size && lu.dimension(2) == Size);
+  eigen_assert(transpositions.dimension(0) == batch && transpositions.dimension(1) == Size);
+  eigen_assert(rhs.dimension(1) == Size);
+
+  internal::batched_partial_lu_solve_kernel<Scalar,Size> kernel;
+  kernel.m_lu = lu.data();
+  kernel.m_transpositions = transpositions.data();
+  kernel.m_rhs = internal::batched_check_tensor<Rhs,3>::data(rhs);
+  kernel.m_batch = batch;
+  kernel.m_rhsCols = rhs.dimension(2);
+  internal::batched_executor<Device>::run(device, internal::batched_groups<Scalar>(batch),
+      internal::batched_cost<Scalar,Size,Size>(2*Size*Size*rhs.dimension(2), 1, 0), kernel);
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_CXX11_BATCHED_LINEAR_ALGEBRA_H
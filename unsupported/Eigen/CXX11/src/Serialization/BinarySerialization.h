@@ -0,0 +1,374 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_CXX11_BINARY_SERIALIZATION_H
+#define EIGEN_CXX11_BINARY_SERIALIZATION_H
+
+namespace Eigen {
+
+namespace internal {
+
+template<typename Traits>
+void binary_init_header(binary_header& header, std::int64_t nonZeros, std::uint32_t indexSize)
+{
+  binary_init_header<typename Traits::Scalar>(header, Traits::Kind, Traits::Rank, Traits::IsRowMajor, nonZeros, indexSize);
+}
+
+template<typename T> struct binary_traits;
+
+template<typename Derived>
+struct binary_dense_traits
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef Map<Derived> MapType;
+  enum { Kind = BinaryDenseKind, Rank = 2, IsRowMajor = Derived::IsRowMajor, IndexSize = 0 };
+
+  static void dimensions(const Derived& m, std::int64_t* dims) { dims[0] = m.rows(); dims[1] = m.cols(); }
+  static bool checkDimensions(const std::int64_t* dims)
+  {
+    return (Derived::RowsAtCompileTime==Dynamic || dims[0]==Derived::RowsAtCompileTime)
+        && (Derived::ColsAtCompileTime==Dynamic || dims[1]==Derived::ColsAtCompileTime)
+        && (Derived::MaxRowsAtCompileTime==Dynamic || dims[0]<=Derived::MaxRowsAtCompileTime)
+        && (Derived::MaxColsAtCompileTime==Dynamic || dims[1]<=Derived::MaxColsAtCompileTime);
+  }
+  static const Scalar* data(const Derived& m) { return m.data(); }
+  static MapType map(char* base, const binary_layout& layout, const std::int64_t* dims, std::int64_t)
+  {
+    return MapType(reinterpret_cast<Scalar*>(base + layout.values), Index(dims[0]), Index(dims[1]));
+  }
+};
+
+template<typename Scalar_, int Rows_, int Cols_, int Options_, int MaxRows_, int MaxCols_>
+struct binary_traits<Matrix<Scalar_,Rows_,Cols_,Options_,MaxRows_,MaxCols_> >
+  : binary_dense_traits<Matrix<Scalar_,Rows_,Cols_,Options_,MaxRows_,MaxCols_> >
+{};
+
+template<typename Scalar_, int Rows_, int Cols_, int Options_, int MaxRows_, int MaxCols_>
+struct binary_traits<Array<Scalar_,Rows_,Cols_,Options_,MaxRows_,MaxCols_> >
+  : binary_dense_traits<Array<Scalar_,Rows_,Cols_,Options_,MaxRows_,MaxCols_> >
+{};
+
+template<typename Scalar_, int NumIndices_, int Options_, typename IndexType>
+struct binary_traits<Tensor<Scalar_,NumIndices_,Options_,IndexType> >
+{
+  typedef Tensor<Scalar_,NumIndices_,Options_,IndexType> TensorType;
+  typedef Scalar_ Scalar;
+  typedef TensorMap<TensorType> MapType;
+  enum { Kind = BinaryTensorKind, Rank = NumIndices_, IsRowMajor = (Options_&RowMajor)!=0, IndexSize = 0 };
+
+  static void dimensions(const TensorType& t, std::int64_t* dims)
+  {
+    for(int i = 0; i < Rank; ++i)
+      dims[i] = t.dimension(i);
+  }
+  static bool checkDimensions(const std::int64_t*) { return true; }
+  static const Scalar* data(const TensorType& t) { return t.data(); }
+  static MapType map(char* base, const binary_layout& layout, const std::int64_t* dims, std::int64_t)
+  {
+    array<IndexType,NumIndices_> dimensions;
+    for(int i = 0; i < Rank; ++i)
+      dimensions[i] = IndexType(dims[i]);
+    return MapType(reinterpret_cast<Scalar*>(base + layout.values), dimensions);
+  }
+};
+
+template<typename Scalar_, typename Dimensions_, int Options_, typename IndexType>
+struct binary_traits<TensorFixedSize<Scalar_,Dimensions_,Options_,IndexType> >
+{
+  typedef TensorFixedSize<Scalar_,Dimensions_,Options_,IndexType> TensorType;
+  typedef Scalar_ Scalar;
+  typedef TensorMap<TensorType> MapType;
+  enum { Kind = BinaryTensorKind, Rank = Dimensions_::count, IsRowMajor = (Options_&RowMajor)!=0, IndexSize = 0 };
+
+  static void dimensions(const TensorType&, std::int64_t* dims)
+  {
+    for(int i = 0; i < Rank; ++i)
+      dims[i] = Dimensions_()[i];
+  }
+  static bool checkDimensions(const std::int64_t* dims)
+  {
+    for(int i = 0; i < Rank; ++i)
+      if(dims[i]!=std::int64_t(Dimensions_()[i]))
+        return false;
+    return true;
+  }
+  static const Scalar* data(const TensorType& t) { return t.data(); }
+  static MapType map(char* base, const binary_layout& layout, const std::int64_t*, std::int64_t)
+  {
+    return MapType(reinterpret_cast<Scalar*>(base + layout.values), Dimensions_());
+  }
+};
+
+template<typename Scalar_, int Options_, typename StorageIndex_>
+struct binary_traits<SparseMatrix<Scalar_,Options_,StorageIndex_> >
+{
+  typedef SparseMatrix<Scalar_,Options_,StorageIndex_> SparseMatrixType;
+  typedef Scalar_ Scalar;
+  typedef StorageIndex_ StorageIndex;
+  typedef Map<SparseMatrixType> MapType;
+  enum { Kind = BinarySparseKind, Rank = 2, IsRowMajor = SparseMatrixType::IsRowMajor, IndexSize = sizeof(StorageIndex_) };
+
+  static void dimensions(const SparseMatrixType& m, std::int64_t* dims) { dims[0] = m.rows(); dims[1] = m.cols(); }
+  static bool checkDimensions(const std::int64_t*) { return true; }
+  static MapType map(char* base, const binary_layout& layout, const std::int64_t* dims, std::int64_t nonZeros)
+  {
+    return binary_map_sparse<SparseMatrixType>(base, layout, dims, nonZeros);
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup CXX11_Serialization_Module
+  *
+  * \class MappedBinaryFile
+  *
+  * \brief Memory mapped view of a file written by saveBinary() or BinaryStreamWriter
+  *
+  * The objects stored in the file are accessed through maps, without any copy nor parsing:
+  * \code
+  * MappedBinaryFile file;
+  * if(file.open("weights.bin") && file.holds<MatrixXf>())
+  * {
+  *   Map<MatrixXf> weights = file.map<MatrixXf>();
+  *   y = weights * x;
+  * }
+  * \endcode
+  * The supported object types are Matrix, Array, Tensor, TensorFixedSize and SparseMatrix. The map<T>() method
+  * respectively returns a Map<T>, a TensorMap<T> or a Map<SparseMatrix>.
+  *
+  * The mapping is private: modifying the coefficients through the maps does not alter the file. The maps are valid
+  * until the file is closed or this object is destroyed. Where memory mapping is not available, the file is read
+  * into memory.
+  *
+  * \sa saveBinary(), loadBinary(), class BinaryStreamWriter
+  */
+class MappedBinaryFile
+{
+  public:
+    MappedBinaryFile() : m_isOpen(false) {}
+
+    /** Maps the file \a filename, and \returns false if it cannot be read or if it is not a valid binary file */
+    bool open(const std::string& filename)
+    {
+      close();
+      if(!m_file.open(filename))
+        return false;
+      if(!internal::binary_read_header(m_file, m_header, m_dims, m_layout))
+      {
+        close();
+        return false;
+      }
+      m_isOpen = true;
+      return true;
+    }
+
+    /** Unmaps the file */
+    void close()
+    {
+      m_file.close();
+      m_isOpen = false;
+      m_dims.clear();
+    }
+
+    bool isOpen() const { return m_isOpen; }
+
+    /** \returns the number of dimensions of the stored object */
+    Index rank() const { eigen_assert(m_isOpen); return m_header.rank; }
+
+    /** \returns the \a i -th dimension of the stored object */
+    Index dimension(Index i) const { eigen_assert(m_isOpen && i>=0 && i<rank()); return Index(m_dims[i]); }
+
+    /** \returns the number of stored coefficients */
+    Index nonZeros() const { eigen_assert(m_isOpen); return Index(m_header.nonZeros); }
+
+    /** \returns whether the file holds an object that can be mapped as a \a T */
+    template<typename T>
+    bool holds() const
+    {
+      typedef internal::binary_traits<T> Traits;
+      if(!m_isOpen || !internal::binary_check_header<typename Traits::Scalar>(m_header, Traits::Kind, Traits::Rank, Traits::IndexSize)
+         || !Traits::checkDimensions(m_dims.empty() ? 0 : &m_dims[0]))
+        return false;
+      // the storage order of dense vectors does not matter
+      bool isVector = int(Traits::Kind)==int(internal::BinaryDenseKind) && (m_dims[0]==1 || m_dims[1]==1);
+      return isVector || bool(m_header.flags & RowMajorBit)==bool(Traits::IsRowMajor);
+    }
+
+    /** \returns a map of the stored object as a \a T
+      * \pre holds<T>() */
+    template<typename T>
+    typename internal::binary_traits<T>::MapType map() const
+    {
+      eigen_assert(holds<T>() && "MappedBinaryFile::map(): the file does not hold an object of the requested type");
+      return internal::binary_traits<T>::map(m_file.data(), m_layout, m_dims.empty() ? 0 : &m_dims[0], m_header.nonZeros);
+    }
+
+  private:
+    MappedBinaryFile(const MappedBinaryFile&);
+    MappedBinaryFile& operator=(const MappedBinaryFile&);
+
+    internal::mapped_file m_file;
+    bool m_isOpen;
+    internal::binary_header m_header;
+    internal::binary_layout m_layout;
+    std::vector<std::int64_t> m_dims;
+};
+
+/** \ingroup CXX11_Serialization_Module
+  *
+  * \class BinaryStreamWriter
+  *
+  * \brief Writes a dense matrix or a tensor to a binary file by successive chunks of coefficients
+  *
+  * \tparam T the type of the written object, a Matrix, an Array, a Tensor or a TensorFixedSize
+  *
+  * The object does not need to be stored in memory as a whole: its dimensions are given to open(), then its
+  * coefficients are appended in storage order, for instance block of columns by block of columns for a column major
+  * matrix. The file is valid once all the coefficients have been written and close() has been called.
+  *
+  * \code
+  * BinaryStreamWriter<MatrixXd> writer;
+  * writer.open("big.bin", rows, cols);
+  * for(Index j = 0; j < cols; j += 1024)
+  *   writer.append(computeColumns(j, std::min<Index>(1024, cols-j)));
+  * bool ok = writer.close();
+  * \endcode
+  *
+  * \sa saveBinary(), class MappedBinaryFile
+  */
+template<typename T>
+class BinaryStreamWriter
+{
+    typedef internal::binary_traits<T> Traits;
+  public:
+    typedef typename Traits::Scalar Scalar;
+    enum { Rank = Traits::Rank };
+
+    BinaryStreamWriter() : m_count(0), m_total(0) {}
+    ~BinaryStreamWriter() { if(m_out.is_open()) close(); }
+
+    /** Creates the file \a filename for an object of dimensions \a dimensions */
+    template<typename... IndexTypes>
+    bool open(const std::string& filename, IndexTypes... dimensions)
+    {
+      EIGEN_STATIC_ASSERT(sizeof...(IndexTypes)==std::size_t(Rank), YOU_MADE_A_PROGRAMMING_MISTAKE);
+      EIGEN_STATIC_ASSERT(int(Traits::Kind)!=int(internal::BinarySparseKind), YOU_MADE_A_PROGRAMMING_MISTAKE);
+      std::int64_t dims[Rank+1] = { std::int64_t(dimensions)... };
+      if(m_out.is_open())
+        close();
+      m_dims.assign(dims, dims+Rank);
+      eigen_assert(Traits::checkDimensions(dims));
+      m_total = 1;
+      for(int i = 0; i < Rank; ++i)
+        m_total *= dims[i];
+      m_count = 0;
+      internal::binary_init_header<Traits>(m_header, m_total, 0);
+      m_layout = internal::binary_compute_layout(m_header, dims);
+
+      m_out.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      // the header is written by close(), such that incomplete files cannot be opened
+      return m_out && internal::binary_write_padding(m_out, m_layout.values);
+    }
+
+    /** Appends the \a count coefficients \a data */
+    bool append(const Scalar* data, Index count)
+    {
+      eigen_assert(m_out.is_open() && m_count+count<=m_total && "BinaryStreamWriter::append(): too many coefficients");
+      m_out.write(reinterpret_cast<const char*>(data), std::streamsize(count*sizeof(Scalar)));
+      m_count += count;
+      return bool(m_out);
+    }
+
+    /** Appends the coefficients of \a chunk, taken in the storage order of the written object */
+    template<typename Derived>
+    bool append(const DenseBase<Derived>& chunk)
+    {
+      typedef Matrix<Scalar,Dynamic,Dynamic,Traits::IsRowMajor ? RowMajor : ColMajor> Chunk;
+      typename internal::conditional<internal::is_same<Derived,Chunk>::value, const Chunk&, Chunk>::type tmp(chunk.derived());
+      return append(tmp.data(), tmp.size());
+    }
+
+    /** \returns the number of coefficients still to be written */
+    Index remaining() const { return Index(m_total - m_count); }
+
+    /** Finalizes the file, and \returns false if an error occured or if some coefficients have not been written */
+    bool close()
+    {
+      bool ok = m_out.is_open() && m_out && m_count==m_total;
+      if(ok)
+      {
+        m_out.seekp(0);
+        m_out.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+        if(Rank>0)
+          m_out.write(reinterpret_cast<const char*>(&m_dims[0]), std::streamsize(Rank*sizeof(std::int64_t)));
+        ok = bool(m_out);
+      }
+      m_out.close();
+      return ok && bool(m_out);
+    }
+
+  protected:
+    std::ofstream m_out;
+    internal::binary_header m_header;
+    internal::binary_layout m_layout;
+    std::vector<std::int64_t> m_dims;
+    std::int64_t m_count, m_total;
+};
+
+/** \ingroup CXX11_Serialization_Module
+  * \brief Writes the dense matrix or array, or the tensor \a object to the binary file \a filename
+  * \sa loadBinary(), class MappedBinaryFile, class BinaryStreamWriter */
+template<typename T>
+bool saveBinary(const T& object, const std::string& filename)
+{
+  typedef internal::binary_traits<T> Traits;
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!out)
+    return false;
+  std::int64_t dims[Traits::Rank+1];
+  Traits::dimensions(object, dims);
+  std::int64_t size = 1;
+  for(int i = 0; i < Traits::Rank; ++i)
+    size *= dims[i];
+  internal::binary_header header;
+  internal::binary_init_header<Traits>(header, size, 0);
+  internal::binary_layout layout = internal::binary_compute_layout(header, dims);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(dims), std::streamsize(Traits::Rank*sizeof(std::int64_t)));
+  internal::binary_write_padding(out, layout.values);
+  out.write(reinterpret_cast<const char*>(Traits::data(object)), std::streamsize(size*sizeof(typename Traits::Scalar)));
+  return bool(out);
+}
+
+/** \ingroup CXX11_Serialization_Module
+  * \brief Writes the compressed storage of the sparse matrix \a mat to the binary file \a filename
+  *
+  * The file can as well be read by loadMarketBinary() and MappedMarketBinary of the SparseExtra module.
+  * \sa loadBinary(), class MappedBinaryFile */
+template<typename Scalar, int Options, typename StorageIndex>
+bool saveBinary(const SparseMatrix<Scalar,Options,StorageIndex>& mat, const std::string& filename)
+{
+  return internal::binary_save_sparse(mat, filename);
+}
+
+/** \ingroup CXX11_Serialization_Module
+  * \brief Reads \a object from the binary file \a filename
+  * \returns false if the file cannot be read or if it does not hold an object of the type of \a object
+  * \sa saveBinary(), class MappedBinaryFile */
+template<typename T>
+bool loadBinary(T& object, const std::string& filename)
+{
+  MappedBinaryFile file;
+  if(!file.open(filename) || !file.holds<T>())
+    return false;
+  object = file.map<T>();
+  return true;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_CXX11_BINARY_SERIALIZATION_H
@@ -56,16 +56,16 @@ struct packRhsAndKernelArg {
 }  // end namespace internal
 #endif  // EIGEN_USE_SIMPLE_THREAD_POOL
 
-template<typename Indices, typename LeftArgType, typename RightArgType>
-struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgType>, ThreadPoolDevice> :
-    public TensorContractionEvaluatorBase<TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgType>, ThreadPoolDevice> > {
+template<typename Indices, typename LeftArgType, typename RightArgType, typename OutputKernelType>
+struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgType, OutputKernelType>, ThreadPoolDevice> :
+    public TensorContractionEvaluatorBase<TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgType, OutputKernelType>, ThreadPoolDevice> > {
 
   typedef ThreadPoolDevice Device;
 
-  typedef TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgType>, Device> Self;
+  typedef TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgType, OutputKernelType>, Device> Self;
   typedef TensorContractionEvaluatorBase<Self> Base;
 
-  typedef TensorContractionOp<Indices, LeftArgType, RightArgType> XprType;
+  typedef TensorContractionOp<Indices, LeftArgType, RightArgType, OutputKernelType> XprType;
   typedef typename internal::remove_const<typename XprType::Scalar>::type Scalar;
   typedef typename XprType::Index Index;
   typedef typename XprType::CoeffReturnType CoeffReturnType;
@@ -211,6 +211,17 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
     // model is not tuned. Remove this when the cost model is tuned.
     if (n == 1) num_threads = 1;
 
+    // Contractions with a small output and a large contracting dimension, e.g.
+    // [256 x 1M] * [1M x 256], offer little parallelism over rows or columns:
+    // shard them over the contracting dimension instead.
+    const int num_threads_by_k = numThreadsInnerDim(m, n, k);
+    if (shardByInnerDim(m, n, k, num_threads, num_threads_by_k)) {
+      evalShardedByInnerDim<lhs_inner_dim_contiguous, rhs_inner_dim_contiguous,
+                            rhs_inner_dim_reordered, Alignment>(num_threads_by_k,
+                                                                buffer);
+      return;
+    }
+
     if (num_threads == 1) {
       // The single-threaded algorithm should be faster in this case.
       if (n == 1)
@@ -293,7 +304,8 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
     Context<LhsPacker, RhsPacker, GebpKernel, LhsMapper, RhsMapper,
             OutputMapper>(this->m_device, num_threads, lhs, rhs, buffer, m, n,
                           k, bm, bn, bk, nm, nn, nk, gm, gn, nm0, nn0,
-                          shard_by_col, parallel_pack)
+                          shard_by_col, parallel_pack, this->m_output_kernel,
+                          this->m_tensor_contraction_params)
         .run();
   }
 
@@ -306,7 +318,8 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
             RhsMapper& rhs, Scalar* buffer, Index tm, Index tn, Index tk, Index bm,
             Index bn, Index bk, Index nm, Index nn, Index nk, Index gm,
             Index gn, Index nm0, Index nn0, bool shard_by_col,
-            bool parallel_pack)
+            bool parallel_pack, const OutputKernelType& output_kernel,
+            const TensorContractionParams& tensor_contraction_params)
         : device_(device),
           lhs_(lhs),
           rhs_(rhs),
@@ -315,6 +328,8 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
           num_threads_(num_threads),
           shard_by_col_(shard_by_col),
           parallel_pack_(parallel_pack),
+          output_kernel_(output_kernel),
+          tensor_contraction_params_(tensor_contraction_params),
           m_(tm),
           n_(tn),
           k_(tk),
@@ -406,6 +421,8 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
     const int num_threads_;
     const bool shard_by_col_;
     const bool parallel_pack_;
+    const OutputKernelType output_kernel_;
+    const TensorContractionParams tensor_contraction_params_;
     // Matrix sizes.
     const Index m_;
     const Index n_;
@@ -520,24 +537,30 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
       if (shard_by_col_) {
         for (Index n1 = n * gn_; n1 < nend; n1++) {
           for (Index m1 = m * gm_; m1 < mend; m1++)
-            GebpKernel()(output_.getSubMapper(m1 * bm_, n1 * bn_),
-                         packed_lhs_[k % (P - 1)][m1],
-                         packed_rhs_[k % (P - 1)][n1], bm(m1), bk(k), bn(n1),
-                         Scalar(1), -1, -1, 0, 0);
+            kernelBlock(m1, n1, k);
         }
       } else {
         for (Index m1 = m * gm_; m1 < mend; m1++)
           for (Index n1 = n * gn_; n1 < nend; n1++) {
-            GebpKernel()(output_.getSubMapper(m1 * bm_, n1 * bn_),
-                         packed_lhs_[k % (P - 1)][m1],
-                         packed_rhs_[k % (P - 1)][n1], bm(m1), bk(k), bn(n1),
-                         Scalar(1), -1, -1, 0, 0);
+            kernelBlock(m1, n1, k);
           }
       }
       signal_kernel(m, n, k + 1, false);
       signal_switch(k + 2);
     }
 
+    void kernelBlock(Index m1, Index n1, Index k) {
+      const OutputMapper output = output_.getSubMapper(m1 * bm_, n1 * bn_);
+      GebpKernel()(output, packed_lhs_[k % (P - 1)][m1],
+                   packed_rhs_[k % (P - 1)][n1], bm(m1), bk(k), bn(n1),
+                   Scalar(1), -1, -1, 0, 0);
+      // We are done with the last task for the [m1, n1] block.
+      if (k + 1 == nk_) {
+        output_kernel_(output, tensor_contraction_params_, m1 * bm_, n1 * bn_,
+                       bm(m1), bn(n1));
+      }
+    }
+
     void signal_packing(Index k) {
       eigen_assert(!parallel_pack_);
       Index s = state_packing_ready_[k % P].fetch_sub(1);
@@ -654,6 +677,136 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
     return true;
   }
 
+  // Decide whether we want to shard the contraction over the contracting
+  // dimension: each thread then contracts a slice of k into its own m x n
+  // buffer, and the buffers are summed at the end.
+  static bool shardByInnerDim(Index m, Index n, Index k, int num_threads,
+                              int num_threads_by_k) {
+    // The per-thread buffers must fit in cache, and each thread must get
+    // enough of k to amortize the summation of the buffers.
+    const std::ptrdiff_t bufsize = m * n * sizeof(Scalar);
+    if (num_threads_by_k < 2 ||
+        bufsize > static_cast<std::ptrdiff_t>(l3CacheSize()) / num_threads_by_k ||
+        k / num_threads_by_k < 8 * Traits::nr)
+      return false;
+    // Shard by k when the output is small compared to the contracting
+    // dimension, or when it gives more parallelism than rows or columns.
+    return m * n <= k || num_threads_by_k > num_threads;
+  }
+
+  // Number of threads for the contraction sharded by inner dimension, given by
+  // the cost of a rank-1 update of the m x n output per index of k.
+  int numThreadsInnerDim(Index m, Index n, Index k) const {
+    const TensorOpCost cost = contractionCostPerInnerDim(m, n);
+    int num_threads = TensorCostModel<ThreadPoolDevice>::numThreads(
+        static_cast<double>(k), cost, this->m_device.numThreads());
+    // Slices of k are multiples of the largest packet size.
+    return static_cast<int>(numext::mini<Index>(num_threads, numext::maxi<Index>(1, k / 16)));
+  }
+
+  TensorOpCost contractionCostPerInnerDim(Index m, Index n) const {
+    const int packed_size = std::min<int>(PacketType<LhsScalar, Device>::size,
+                                          PacketType<RhsScalar, Device>::size);
+#ifdef EIGEN_VECTORIZE_FMA
+    const double computeBandwidth = 0.5;
+#else
+    const double computeBandwidth = 1.0;
+#endif
+    // Computations: m x n multiply-adds. The outputs stay in the registers of
+    // the kernel and their loads and stores are negligible.
+    TensorOpCost cost(0, 0, static_cast<double>(m) * n * computeBandwidth, true, packed_size);
+    // Lhs/rhs loads: a column of lhs and a row of rhs.
+    TensorOpCost lhsCost = this->m_leftImpl.costPerCoeff(true) * static_cast<double>(m);
+    TensorOpCost rhsCost = this->m_rightImpl.costPerCoeff(true) * static_cast<double>(n);
+    return cost + lhsCost + rhsCost;
+  }
+
+  template <bool lhs_inner_dim_contiguous, bool rhs_inner_dim_contiguous,
+            bool rhs_inner_dim_reordered, int Alignment>
+  void evalShardedByInnerDim(int num_threads, Scalar* result) const {
+    const Index m = this->m_i_size;
+    const Index n = this->m_j_size;
+    const Index k = this->m_k_size;
+    const Index size = m * n;
+
+    // The slices of k are multiples of the largest packet size (16), the
+    // first one being contracted directly into the result.
+    const Index num_blocks = num_threads;
+    MaxSizeVector<Scalar*> buffers(num_blocks);
+    buffers.push_back(result);
+    for (Index i = 1; i < num_blocks; ++i)
+      buffers.push_back(static_cast<Scalar*>(
+          this->m_device.allocate(size * sizeof(Scalar))));
+
+    {
+      Barrier barrier(static_cast<unsigned int>(num_blocks));
+      Index start = 0;
+      for (Index i = 0; i < num_blocks; ++i) {
+        const Index blocks_left = num_blocks - i;
+        const Index end = numext::mini(
+            k, start + 16 * divup<Index>(k - start, 16 * blocks_left));
+        Scalar* buf = buffers[i];
+        this->m_device.enqueueNoNotification([=, &barrier]() {
+          this->template evalGemmPartial<lhs_inner_dim_contiguous,
+                                         rhs_inner_dim_contiguous,
+                                         rhs_inner_dim_reordered, Alignment,
+                                         false>(buf, start, end);
+          barrier.Notify();
+        });
+        start = end;
+      }
+      barrier.Wait();
+    }
+
+    // Tree summation of the partial results into the first one: at each level
+    // the pairs of buffers are summed in parallel, each sum being split in
+    // chunks to keep all the threads busy until the last level.
+    const Index packet_size = internal::unpacket_traits<PacketReturnType>::size;
+    for (Index stride = 1; stride < num_blocks; stride *= 2) {
+      const Index pairs = divup<Index>(num_blocks - stride, 2 * stride);
+      const Index chunks_per_pair = numext::maxi<Index>(1, num_threads / pairs);
+      const Index chunk = packet_size * divup<Index>(size, packet_size * chunks_per_pair);
+      const Index chunks = divup<Index>(size, chunk);
+      Barrier barrier(static_cast<unsigned int>(pairs * chunks));
+      for (Index p = 0; p < pairs; ++p) {
+        Scalar* dst = buffers[2 * stride * p];
+        const Scalar* src = buffers[2 * stride * p + stride];
+        for (Index c = 0; c < chunks; ++c) {
+          const Index begin = c * chunk;
+          const Index len = numext::mini(chunk, size - begin);
+          this->m_device.enqueueNoNotification([=, &barrier]() {
+            addToBuffer(len, src + begin, dst + begin);
+            barrier.Notify();
+          });
+        }
+      }
+      barrier.Wait();
+    }
+
+    for (Index i = 1; i < num_blocks; ++i)
+      this->m_device.deallocate(buffers[i]);
+
+    // The partial results did not go through the output kernel: apply it once
+    // to the whole sum.
+    typedef internal::blas_data_mapper<Scalar, Index, ColMajor> OutputMapper;
+    this->m_output_kernel(OutputMapper(result, m), this->m_tensor_contraction_params,
+                          static_cast<Index>(0), static_cast<Index>(0), m, n);
+  }
+
+  // Vectorized dst += src.
+  static void addToBuffer(Index n, const Scalar* src, Scalar* dst) {
+    const Index packet_size = internal::unpacket_traits<PacketReturnType>::size;
+    const Index vectorized_size = (n / packet_size) * packet_size;
+    Index i = 0;
+    for (; i < vectorized_size; i += packet_size) {
+      const PacketReturnType sum =
+          internal::padd(internal::ploadu<PacketReturnType>(src + i),
+                         internal::ploadu<PacketReturnType>(dst + i));
+      internal::pstoreu<Scalar>(dst + i, sum);
+    }
+    for (; i < n; ++i) dst[i] += src[i];
+  }
+
   Index coarsenM(Index m, Index n, Index bm, Index bn, Index bk, Index gn,
                  int num_threads, bool shard_by_col) const {
     Index gm = 1;
@@ -957,6 +1110,11 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
       this->m_device.deallocate(blockBs[i]);
     }
 
+    // The kernels of this scheduler do not know which one completes an output
+    // block, so the output kernel is applied once all of them are done.
+    this->m_output_kernel(output, this->m_tensor_contraction_params,
+                          static_cast<Index>(0), static_cast<Index>(0), m, n);
+
 #undef CEIL_DIV
   }
 
@@ -10,8 +10,7 @@
 #ifndef EIGEN_CXX11_TENSOR_TENSOR_FFT_H
 #define EIGEN_CXX11_TENSOR_TENSOR_FFT_H
 
-// This code requires the ability to initialize arrays of constant
-// values directly inside a class.
+// This code requires C++11 for the thread safe cache of the plans.
 #if __cplusplus >= 201103L || EIGEN_COMP_MSVC >= 1900
 
 namespace Eigen {
@@ -21,9 +20,11 @@ namespace Eigen {
   *
   * \brief Tensor FFT class.
   *
+  * The transforms of the lines along each dimension are computed with the
+  * plans of their length, which are cached across evaluations, and are run in
+  * parallel on a ThreadPoolDevice.
+  *
   * TODO:
-  * Vectorize the Cooley Tukey and the Bluestein algorithm
-  * Add support for multithreaded evaluation
   * Improve the performance on GPU
   */
 
@@ -57,6 +58,348 @@ template <> struct PartOf<ImagPart> {
   template <typename T> T operator() (const std::complex<T>& val) const { return val.imag(); }
 };
 
+namespace internal {
+
+/** \internal
+  * Plan of the 1D transforms of a given length: the twiddle factors of the
+  * power of two transforms and, for the other lengths, the chirp and the
+  * transformed kernel of Bluestein's algorithm.
+  *
+  * The plans only depend on the length and the scalar type, and are shared
+  * across evaluations through a cache: get() returns the plan of a length,
+  * computing it on the first request only.
+  */
+template <typename RealScalar>
+class TensorFFTPlan {
+ public:
+  typedef std::complex<RealScalar> ComplexScalar;
+  typedef Matrix<ComplexScalar, Dynamic, 1> ComplexVector;
+  typedef typename packet_traits<ComplexScalar>::type Packet;
+
+  static std::shared_ptr<const TensorFFTPlan> get(Index n) {
+    // The cache is bounded: when full, it is emptied, the plans in use
+    // remaining alive until their last evaluation completes.
+    static const size_t max_plans = 64;
+    static std::mutex mutex;
+    static std::map<Index, std::shared_ptr<const TensorFFTPlan> > plans;
+    std::lock_guard<std::mutex> lock(mutex);
+    typename std::map<Index, std::shared_ptr<const TensorFFTPlan> >::const_iterator it = plans.find(n);
+    if (it != plans.end()) {
+      return it->second;
+    }
+    if (plans.size() >= max_plans) {
+      plans.clear();
+    }
+    std::shared_ptr<const TensorFFTPlan> plan(new TensorFFTPlan(n));
+    plans[n] = plan;
+    return plan;
+  }
+
+  explicit TensorFFTPlan(Index n)
+      : m_size(n),
+        m_fft_size(isPowerOfTwo(n) ? n : findGoodComposite(n)) {
+    eigen_assert(n >= 1);
+    // m_twiddles[half + j] = exp(-sqrt(-1) * pi * j / half) for the powers of
+    // two half < m_fft_size and j < half, such that the twiddle factors of
+    // each stage of the butterflies are contiguous.
+    m_twiddles.resize(m_fft_size);
+    m_twiddles[0] = ComplexScalar(1, 0);
+    for (Index half = 1; half < m_fft_size; half *= 2) {
+      for (Index j = 0; j < half; ++j) {
+        const RealScalar angle = -RealScalar(EIGEN_PI) * RealScalar(j) / RealScalar(half);
+        m_twiddles[half + j] = ComplexScalar(std::cos(angle), std::sin(angle));
+      }
+    }
+    if (bluestein()) {
+      // Compute the chirp
+      //   t_j = exp(sqrt(-1) * pi * j^2 / n)
+      // for j = 0, 1,..., n-1, reducing j^2 modulo 2n to preserve the accuracy.
+      m_chirp.resize(n);
+      for (Index j = 0; j < n; ++j) {
+        const RealScalar angle = RealScalar(EIGEN_PI) * RealScalar((j * j) % (2 * n)) / RealScalar(n);
+        m_chirp[j] = ComplexScalar(std::cos(angle), std::sin(angle));
+      }
+      // The chirp is convolved with the same kernel for all the lines: its
+      // transform is computed once, with the 1/m_fft_size scaling of the
+      // inverse transform folded in.
+      ComplexVector kernel = ComplexVector::Zero(m_fft_size);
+      kernel[0] = m_chirp[0];
+      for (Index j = 1; j < n; ++j) {
+        kernel[j] = kernel[m_fft_size - j] = m_chirp[j];
+      }
+      m_kernel_fft[FFT_FORWARD] = kernel;
+      m_kernel_fft[FFT_REVERSE] = kernel.conjugate();
+      for (int dir = 0; dir < 2; ++dir) {
+        computePowerOfTwo<FFT_FORWARD>(m_kernel_fft[dir].data(), m_fft_size);
+        m_kernel_fft[dir] /= RealScalar(m_fft_size);
+      }
+    }
+  }
+
+  Index size() const { return m_size; }
+
+  // Length of the scratch buffer to pass to compute()
+  Index scratchSize() const { return bluestein() ? m_fft_size : 0; }
+
+  // Cost of the transform of one line
+  TensorOpCost cost() const {
+    const double fft_flops = 5.0 * m_fft_size * std::max<double>(1.0, std::log(double(m_fft_size)) / std::log(2.0));
+    const double bytes = static_cast<double>(sizeof(ComplexScalar) * m_size);
+    return TensorOpCost(bytes, bytes, bluestein() ? 2 * fft_flops + 12.0 * m_size : fft_flops);
+  }
+
+  // Computes the unnormalized transform of the line, in place.
+  template <int Dir>
+  void compute(ComplexScalar* line, ComplexScalar* scratch) const {
+    if (!bluestein()) {
+      computePowerOfTwo<Dir>(line, m_size);
+      return;
+    }
+    // Bluestein's algorithm: the transform is the convolution of the line,
+    // multiplied by the chirp, with the kernel, and multiplied by the chirp
+    // again. The convolution is done by power of two transforms of length
+    // m_fft_size >= 2n-1.
+    typedef Map<Array<ComplexScalar, Dynamic, 1> > ArrayMap;
+    ArrayMap x(line, m_size);
+    ArrayMap a(scratch, m_fft_size);
+    if (Dir == FFT_FORWARD) {
+      a.head(m_size) = x * m_chirp.array().conjugate();
+    } else {
+      a.head(m_size) = x * m_chirp.array();
+    }
+    a.tail(m_fft_size - m_size).setZero();
+    computePowerOfTwo<FFT_FORWARD>(scratch, m_fft_size);
+    a *= m_kernel_fft[Dir].array();
+    computePowerOfTwo<FFT_REVERSE>(scratch, m_fft_size);
+    if (Dir == FFT_FORWARD) {
+      x = a.head(m_size) * m_chirp.array().conjugate();
+    } else {
+      x = a.head(m_size) * m_chirp.array();
+    }
+  }
+
+  static bool isPowerOfTwo(Index x) {
+    eigen_assert(x > 0);
+    return !(x & (x - 1));
+  }
+
+  // The composite number for padding, used in Bluestein's FFT algorithm
+  static Index findGoodComposite(Index n) {
+    Index i = 2;
+    while (i < 2 * n - 1) i *= 2;
+    return i;
+  }
+
+ private:
+  bool bluestein() const { return m_fft_size != m_size; }
+
+  // Decimation in time transform of a power of two length n <= m_fft_size
+  template <int Dir>
+  void computePowerOfTwo(ComplexScalar* data, Index n) const {
+    eigen_assert(isPowerOfTwo(n) && n <= m_fft_size);
+    scramble_FFT(data, n);
+    compute_1D_Butterfly<Dir>(data, n);
+  }
+
+  static void scramble_FFT(ComplexScalar* data, Index n) {
+    Index j = 1;
+    for (Index i = 1; i < n; ++i){
+      if (j > i) {
+        std::swap(data[j-1], data[i-1]);
+      }
+      Index m = n >> 1;
+      while (m >= 2 && j > m) {
+        j -= m;
+        m >>= 1;
+      }
+      j += m;
+    }
+  }
+
+  // The transforms are merged two stages at a time by radix 4 butterflies,
+  // the halves of each block being transformed first for locality.
+  template <int Dir>
+  void compute_1D_Butterfly(ComplexScalar* data, Index n) const {
+    if (n > 16) {
+      const Index quarter = n / 4;
+      for (Index i = 0; i < 4; ++i) {
+        compute_1D_Butterfly<Dir>(data + i * quarter, quarter);
+      }
+      if (quarter % unpacket_traits<Packet>::size == 0) {
+        butterfly_radix4<Dir, Packet>(data, quarter);
+      } else {
+        butterfly_radix4<Dir, ComplexScalar>(data, quarter);
+      }
+    } else if (n == 16) {
+      butterfly_8<Dir>(data);
+      butterfly_8<Dir>(data + 8);
+      if (8 % unpacket_traits<Packet>::size == 0) {
+        butterfly_radix2<Dir, Packet>(data, 8);
+      } else {
+        butterfly_radix2<Dir, ComplexScalar>(data, 8);
+      }
+    } else if (n == 8) {
+      butterfly_8<Dir>(data);
+    } else if (n == 4) {
+      butterfly_4<Dir>(data);
+    } else if (n == 2) {
+      butterfly_2<Dir>(data);
+    }
+  }
+
+  // The twiddle factors are stored for the forward transforms, the inverse
+  // transforms use their conjugates.
+  template <int Dir, typename P>
+  static EIGEN_STRONG_INLINE P loadTwiddles(const ComplexScalar* twiddles) {
+    const P w = ploadu<P>(twiddles);
+    return Dir == FFT_FORWARD ? w : pconj(w);
+  }
+
+  // Merges the transforms of the two halves of data, of length half each.
+  template <int Dir, typename P>
+  void butterfly_radix2(ComplexScalar* data, Index half) const {
+    const Index packet_size = unpacket_traits<P>::size;
+    const ComplexScalar* twiddles = m_twiddles.data() + half;
+    for (Index j = 0; j < half; j += packet_size) {
+      const P x0 = ploadu<P>(data + j);
+      const P x1 = pmul(ploadu<P>(data + half + j), loadTwiddles<Dir, P>(twiddles + j));
+      pstoreu(data + j, padd(x0, x1));
+      pstoreu(data + half + j, psub(x0, x1));
+    }
+  }
+
+  // Merges the transforms of the four quarters of data, of length quarter
+  // each: the first two and the last two quarters are merged into halves by
+  // the stage of length 2*quarter, and the halves by the stage of length
+  // 4*quarter, without storing the intermediate results.
+  template <int Dir, typename P>
+  void butterfly_radix4(ComplexScalar* data, Index quarter) const {
+    const Index packet_size = unpacket_traits<P>::size;
+    const ComplexScalar* twiddles_half = m_twiddles.data() + quarter;
+    const ComplexScalar* twiddles_full = m_twiddles.data() + 2 * quarter;
+    ComplexScalar* data0 = data;
+    ComplexScalar* data1 = data + quarter;
+    ComplexScalar* data2 = data + 2 * quarter;
+    ComplexScalar* data3 = data + 3 * quarter;
+    for (Index j = 0; j < quarter; j += packet_size) {
+      const P w1 = loadTwiddles<Dir, P>(twiddles_half + j);
+      const P w2 = loadTwiddles<Dir, P>(twiddles_full + j);
+      const P w3 = loadTwiddles<Dir, P>(twiddles_full + quarter + j);
+      const P x0 = ploadu<P>(data0 + j);
+      const P x1 = pmul(ploadu<P>(data1 + j), w1);
+      const P x2 = ploadu<P>(data2 + j);
+      const P x3 = pmul(ploadu<P>(data3 + j), w1);
+      const P a0 = padd(x0, x1);
+      const P a1 = psub(x0, x1);
+      const P b0 = pmul(padd(x2, x3), w2);
+      const P b1 = pmul(psub(x2, x3), w3);
+      pstoreu(data0 + j, padd(a0, b0));
+      pstoreu(data2 + j, psub(a0, b0));
+      pstoreu(data1 + j, padd(a1, b1));
+      pstoreu(data3 + j, psub(a1, b1));
+    }
+  }
+
+  template <int Dir>
+  static EIGEN_STRONG_INLINE void butterfly_2(ComplexScalar* data) {
+    ComplexScalar tmp = data[1];
+    data[1] = data[0] - data[1];
+    data[0] += tmp;
+  }
+
+  template <int Dir>
+  static EIGEN_STRONG_INLINE void butterfly_4(ComplexScalar* data) {
+    ComplexScalar tmp[4];
+    tmp[0] = data[0] + data[1];
+    tmp[1] = data[0] - data[1];
+    tmp[2] = data[2] + data[3];
+    if (Dir == FFT_FORWARD) {
+      tmp[3] = ComplexScalar(0.0, -1.0) * (data[2] - data[3]);
+    } else {
+      tmp[3] = ComplexScalar(0.0, 1.0) * (data[2] - data[3]);
+    }
+    data[0] = tmp[0] + tmp[2];
+    data[1] = tmp[1] + tmp[3];
+    data[2] = tmp[0] - tmp[2];
+    data[3] = tmp[1] - tmp[3];
+  }
+
+  template <int Dir>
+  static EIGEN_STRONG_INLINE void butterfly_8(ComplexScalar* data) {
+    ComplexScalar tmp_1[8];
+    ComplexScalar tmp_2[8];
+
+    tmp_1[0] = data[0] + data[1];
+    tmp_1[1] = data[0] - data[1];
+    tmp_1[2] = data[2] + data[3];
+    if (Dir == FFT_FORWARD) {
+      tmp_1[3] = (data[2] - data[3]) * ComplexScalar(0, -1);
+    } else {
+      tmp_1[3] = (data[2] - data[3]) * ComplexScalar(0, 1);
+    }
+    tmp_1[4] = data[4] + data[5];
+    tmp_1[5] = data[4] - data[5];
+    tmp_1[6] = data[6] + data[7];
+    if (Dir == FFT_FORWARD) {
+      tmp_1[7] = (data[6] - data[7]) * ComplexScalar(0, -1);
+    } else {
+      tmp_1[7] = (data[6] - data[7]) * ComplexScalar(0, 1);
+    }
+    tmp_2[0] = tmp_1[0] + tmp_1[2];
+    tmp_2[1] = tmp_1[1] + tmp_1[3];
+    tmp_2[2] = tmp_1[0] - tmp_1[2];
+    tmp_2[3] = tmp_1[1] - tmp_1[3];
+    tmp_2[4] = tmp_1[4] + tmp_1[6];
+    // sqrt2_div2 = sqrt(2)/2
+    const RealScalar sqrt2_div2(0.7071067811865476);
+    if (Dir == FFT_FORWARD) {
+      tmp_2[5] = (tmp_1[5] + tmp_1[7]) * ComplexScalar(sqrt2_div2, -sqrt2_div2);
+      tmp_2[6] = (tmp_1[4] - tmp_1[6]) * ComplexScalar(0, -1);
+      tmp_2[7] = (tmp_1[5] - tmp_1[7]) * ComplexScalar(-sqrt2_div2, -sqrt2_div2);
+    } else {
+      tmp_2[5] = (tmp_1[5] + tmp_1[7]) * ComplexScalar(sqrt2_div2, sqrt2_div2);
+      tmp_2[6] = (tmp_1[4] - tmp_1[6]) * ComplexScalar(0, 1);
+      tmp_2[7] = (tmp_1[5] - tmp_1[7]) * ComplexScalar(-sqrt2_div2, sqrt2_div2);
+    }
+    data[0] = tmp_2[0] + tmp_2[4];
+    data[1] = tmp_2[1] + tmp_2[5];
+    data[2] = tmp_2[2] + tmp_2[6];
+    data[3] = tmp_2[3] + tmp_2[7];
+    data[4] = tmp_2[0] - tmp_2[4];
+    data[5] = tmp_2[1] - tmp_2[5];
+    data[6] = tmp_2[2] - tmp_2[6];
+    data[7] = tmp_2[3] - tmp_2[7];
+  }
+
+  Index m_size;
+  Index m_fft_size;
+  ComplexVector m_twiddles;
+  ComplexVector m_chirp;
+  ComplexVector m_kernel_fft[2];
+};
+
+// Transforms the lines [0, num_lines) of a tensor by calling f on subranges,
+// in parallel when the device is a thread pool.
+template <typename Device>
+struct TensorFFTLines {
+  template <typename Function>
+  static void run(const Device&, Index num_lines, const TensorOpCost&, Function f) {
+    f(0, num_lines);
+  }
+};
+
+#ifdef EIGEN_USE_THREADS
+template <>
+struct TensorFFTLines<ThreadPoolDevice> {
+  template <typename Function>
+  static void run(const ThreadPoolDevice& device, Index num_lines, const TensorOpCost& cost, Function f) {
+    device.parallelFor(num_lines, cost, f);
+  }
+};
+#endif
+
+}  // end namespace internal
+
 namespace internal {
 template <typename FFT, typename XprType, int FFTResultType, int FFTDir>
 struct traits<TensorFFTOp<FFT, XprType, FFTResultType, FFTDir> > : public traits<XprType> {
@@ -206,7 +549,7 @@ struct TensorEvaluator<const TensorFFTOp<FFT, ArgType, FFTResultType, FFTDir>, D
 
 
  private:
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void evalToBuf(OutputScalar* data) {
+  void evalToBuf(OutputScalar* data) {
     const bool write_to_out = internal::is_same<OutputScalar, ComplexScalar>::value;
     ComplexScalar* buf = write_to_out ? (ComplexScalar*)data : (ComplexScalar*)m_device.allocate(sizeof(ComplexScalar) * m_size);
 
@@ -217,77 +560,25 @@ struct TensorEvaluator<const TensorFFTOp<FFT, ArgType, FFTResultType, FFTDir>, D
     for (size_t i = 0; i < m_fft.size(); ++i) {
       Index dim = m_fft[i];
       eigen_assert(dim >= 0 && dim < NumDims);
-      Index line_len = m_dimensions[dim];
+      const Index line_len = m_dimensions[dim];
       eigen_assert(line_len >= 1);
-      ComplexScalar* line_buf = (ComplexScalar*)m_device.allocate(sizeof(ComplexScalar) * line_len);
-      const bool is_power_of_two = isPowerOfTwo(line_len);
-      const Index good_composite = is_power_of_two ? 0 : findGoodComposite(line_len);
-      const Index log_len = is_power_of_two ? getLog2(line_len) : getLog2(good_composite);
-
-      ComplexScalar* a = is_power_of_two ? NULL : (ComplexScalar*)m_device.allocate(sizeof(ComplexScalar) * good_composite);
-      ComplexScalar* b = is_power_of_two ? NULL : (ComplexScalar*)m_device.allocate(sizeof(ComplexScalar) * good_composite);
-      ComplexScalar* pos_j_base_powered = is_power_of_two ? NULL : (ComplexScalar*)m_device.allocate(sizeof(ComplexScalar) * (line_len + 1));
-      if (!is_power_of_two) {
-        // Compute twiddle factors
-        //   t_n = exp(sqrt(-1) * pi * n^2 / line_len)
-        // for n = 0, 1,..., line_len-1.
-        // For n > 2 we use the recurrence t_n = t_{n-1}^2 / t_{n-2} * t_1^2
-        pos_j_base_powered[0] = ComplexScalar(1, 0);
-        if (line_len > 1) {
-          const RealScalar pi_over_len(EIGEN_PI / line_len);
-          const ComplexScalar pos_j_base = ComplexScalar(
-	       std::cos(pi_over_len), std::sin(pi_over_len));
-          pos_j_base_powered[1] = pos_j_base;
-          if (line_len > 2) {
-            const ComplexScalar pos_j_base_sq = pos_j_base * pos_j_base;
-            for (int j = 2; j < line_len + 1; ++j) {
-              pos_j_base_powered[j] = pos_j_base_powered[j - 1] *
-                                      pos_j_base_powered[j - 1] /
-                                      pos_j_base_powered[j - 2] * pos_j_base_sq;
-            }
-          }
+      const std::shared_ptr<const internal::TensorFFTPlan<RealScalar> > plan =
+          internal::TensorFFTPlan<RealScalar>::get(line_len);
+
+      // The lines along dim are independent: they are transformed in
+      // parallel on a thread pool, each range of lines using its own buffers.
+      internal::TensorFFTLines<Device>::run(m_device, m_size / line_len, plan->cost(),
+          [this, buf, dim, line_len, &plan](Index first, Index last) {
+        ComplexScalar* line_buf = (ComplexScalar*)m_device.allocate(sizeof(ComplexScalar) * line_len);
+        ComplexScalar* scratch = plan->scratchSize() > 0 ? (ComplexScalar*)m_device.allocate(sizeof(ComplexScalar) * plan->scratchSize()) : NULL;
+        for (Index partial_index = first; partial_index < last; ++partial_index) {
+          processDataLine(*plan, buf, dim, partial_index, line_buf, scratch);
         }
-      }
-
-      for (Index partial_index = 0; partial_index < m_size / line_len; ++partial_index) {
-        const Index base_offset = getBaseOffsetFromIndex(partial_index, dim);
-
-        // get data into line_buf
-        const Index stride = m_strides[dim];
-        if (stride == 1) {
-          memcpy(line_buf, &buf[base_offset], line_len*sizeof(ComplexScalar));
-        } else {
-          Index offset = base_offset;
-          for (int j = 0; j < line_len; ++j, offset += stride) {
-            line_buf[j] = buf[offset];
-          }
-        }
-
-        // processs the line
-        if (is_power_of_two) {
-          processDataLineCooleyTukey(line_buf, line_len, log_len);
+        m_device.deallocate(line_buf);
+        if (scratch) {
+          m_device.deallocate(scratch);
         }
-        else {
-          processDataLineBluestein(line_buf, line_len, good_composite, log_len, a, b, pos_j_base_powered);
-        }
-
-        // write back
-        if (FFTDir == FFT_FORWARD && stride == 1) {
-          memcpy(&buf[base_offset], line_buf, line_len*sizeof(ComplexScalar));
-        } else {
-          Index offset = base_offset;
-          const ComplexScalar div_factor =  ComplexScalar(1.0 / line_len, 0);
-          for (int j = 0; j < line_len; ++j, offset += stride) {
-             buf[offset] = (FFTDir == FFT_FORWARD) ? line_buf[j] : line_buf[j] * div_factor;
-          }
-        }
-      }
-      m_device.deallocate(line_buf);
-      if (!is_power_of_two) {
-        m_device.deallocate(a);
-        m_device.deallocate(b);
-        m_device.deallocate(pos_j_base_powered);
-      }
+      });
     }
 
     if(!write_to_out) {
@@ -298,237 +589,34 @@ struct TensorEvaluator<const TensorFFTOp<FFT, ArgType, FFTResultType, FFTDir>, D
     }
   }
 
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE static bool isPowerOfTwo(Index x) {
-    eigen_assert(x > 0);
-    return !(x & (x - 1));
-  }
-
-  // The composite number for padding, used in Bluestein's FFT algorithm
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE static Index findGoodComposite(Index n) {
-    Index i = 2;
-    while (i < 2 * n - 1) i *= 2;
-    return i;
-  }
-
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE static Index getLog2(Index m) {
-    Index log2m = 0;
-    while (m >>= 1) log2m++;
-    return log2m;
-  }
-
-  // Call Cooley Tukey algorithm directly, data length must be power of 2
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void processDataLineCooleyTukey(ComplexScalar* line_buf, Index line_len, Index log_len) {
-    eigen_assert(isPowerOfTwo(line_len));
-    scramble_FFT(line_buf, line_len);
-    compute_1D_Butterfly<FFTDir>(line_buf, line_len, log_len);
-  }
-
-  // Call Bluestein's FFT algorithm, m is a good composite number greater than (2 * n - 1), used as the padding length
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void processDataLineBluestein(ComplexScalar* line_buf, Index line_len, Index good_composite, Index log_len, ComplexScalar* a, ComplexScalar* b, const ComplexScalar* pos_j_base_powered) {
-    Index n = line_len;
-    Index m = good_composite;
-    ComplexScalar* data = line_buf;
-
-    for (Index i = 0; i < n; ++i) {
-      if(FFTDir == FFT_FORWARD) {
-        a[i] = data[i] * numext::conj(pos_j_base_powered[i]);
-      }
-      else {
-        a[i] = data[i] * pos_j_base_powered[i];
-      }
-    }
-    for (Index i = n; i < m; ++i) {
-      a[i] = ComplexScalar(0, 0);
-    }
-
-    for (Index i = 0; i < n; ++i) {
-      if(FFTDir == FFT_FORWARD) {
-        b[i] = pos_j_base_powered[i];
-      }
-      else {
-        b[i] = numext::conj(pos_j_base_powered[i]);
-      }
-    }
-    for (Index i = n; i < m - n; ++i) {
-      b[i] = ComplexScalar(0, 0);
-    }
-    for (Index i = m - n; i < m; ++i) {
-      if(FFTDir == FFT_FORWARD) {
-        b[i] = pos_j_base_powered[m-i];
-      }
-      else {
-        b[i] = numext::conj(pos_j_base_powered[m-i]);
-      }
-    }
-
-    scramble_FFT(a, m);
-    compute_1D_Butterfly<FFT_FORWARD>(a, m, log_len);
-
-    scramble_FFT(b, m);
-    compute_1D_Butterfly<FFT_FORWARD>(b, m, log_len);
-
-    for (Index i = 0; i < m; ++i) {
-      a[i] *= b[i];
-    }
-
-    scramble_FFT(a, m);
-    compute_1D_Butterfly<FFT_REVERSE>(a, m, log_len);
-
-    //Do the scaling after ifft
-    for (Index i = 0; i < m; ++i) {
-      a[i] /= m;
-    }
-
-    for (Index i = 0; i < n; ++i) {
-      if(FFTDir == FFT_FORWARD) {
-        data[i] = a[i] * numext::conj(pos_j_base_powered[i]);
-      }
-      else {
-        data[i] = a[i] * pos_j_base_powered[i];
-      }
-    }
-  }
-
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE static void scramble_FFT(ComplexScalar* data, Index n) {
-    eigen_assert(isPowerOfTwo(n));
-    Index j = 1;
-    for (Index i = 1; i < n; ++i){
-      if (j > i) {
-        std::swap(data[j-1], data[i-1]);
-      }
-      Index m = n >> 1;
-      while (m >= 2 && j > m) {
-        j -= m;
-        m >>= 1;
-      }
-      j += m;
-    }
-  }
+  void processDataLine(const internal::TensorFFTPlan<RealScalar>& plan, ComplexScalar* buf, Index dim,
+                       Index partial_index, ComplexScalar* line_buf, ComplexScalar* scratch) const {
+    const Index line_len = plan.size();
+    const Index base_offset = getBaseOffsetFromIndex(partial_index, dim);
 
-  template <int Dir>
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void butterfly_2(ComplexScalar* data) {
-    ComplexScalar tmp = data[1];
-    data[1] = data[0] - data[1];
-    data[0] += tmp;
-  }
-
-  template <int Dir>
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void butterfly_4(ComplexScalar* data) {
-    ComplexScalar tmp[4];
-    tmp[0] = data[0] + data[1];
-    tmp[1] = data[0] - data[1];
-    tmp[2] = data[2] + data[3];
-    if (Dir == FFT_FORWARD) {
-      tmp[3] = ComplexScalar(0.0, -1.0) * (data[2] - data[3]);
+    // get data into line_buf
+    const Index stride = m_strides[dim];
+    if (stride == 1) {
+      memcpy(line_buf, &buf[base_offset], line_len*sizeof(ComplexScalar));
     } else {
-      tmp[3] = ComplexScalar(0.0, 1.0) * (data[2] - data[3]);
+      Index offset = base_offset;
+      for (int j = 0; j < line_len; ++j, offset += stride) {
+        line_buf[j] = buf[offset];
+      }
     }
-    data[0] = tmp[0] + tmp[2];
-    data[1] = tmp[1] + tmp[3];
-    data[2] = tmp[0] - tmp[2];
-    data[3] = tmp[1] - tmp[3];
-  }
 
-  template <int Dir>
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void butterfly_8(ComplexScalar* data) {
-    ComplexScalar tmp_1[8];
-    ComplexScalar tmp_2[8];
+    // processs the line
+    plan.template compute<FFTDir>(line_buf, scratch);
 
-    tmp_1[0] = data[0] + data[1];
-    tmp_1[1] = data[0] - data[1];
-    tmp_1[2] = data[2] + data[3];
-    if (Dir == FFT_FORWARD) {
-      tmp_1[3] = (data[2] - data[3]) * ComplexScalar(0, -1);
-    } else {
-      tmp_1[3] = (data[2] - data[3]) * ComplexScalar(0, 1);
-    }
-    tmp_1[4] = data[4] + data[5];
-    tmp_1[5] = data[4] - data[5];
-    tmp_1[6] = data[6] + data[7];
-    if (Dir == FFT_FORWARD) {
-      tmp_1[7] = (data[6] - data[7]) * ComplexScalar(0, -1);
+    // write back
+    if (FFTDir == FFT_FORWARD && stride == 1) {
+      memcpy(&buf[base_offset], line_buf, line_len*sizeof(ComplexScalar));
     } else {
-      tmp_1[7] = (data[6] - data[7]) * ComplexScalar(0, 1);
-    }
-    tmp_2[0] = tmp_1[0] + tmp_1[2];
-    tmp_2[1] = tmp_1[1] + tmp_1[3];
-    tmp_2[2] = tmp_1[0] - tmp_1[2];
-    tmp_2[3] = tmp_1[1] - tmp_1[3];
-    tmp_2[4] = tmp_1[4] + tmp_1[6];
-// SQRT2DIV2 = sqrt(2)/2
-#define SQRT2DIV2 0.7071067811865476
-    if (Dir == FFT_FORWARD) {
-      tmp_2[5] = (tmp_1[5] + tmp_1[7]) * ComplexScalar(SQRT2DIV2, -SQRT2DIV2);
-      tmp_2[6] = (tmp_1[4] - tmp_1[6]) * ComplexScalar(0, -1);
-      tmp_2[7] = (tmp_1[5] - tmp_1[7]) * ComplexScalar(-SQRT2DIV2, -SQRT2DIV2);
-    } else {
-      tmp_2[5] = (tmp_1[5] + tmp_1[7]) * ComplexScalar(SQRT2DIV2, SQRT2DIV2);
-      tmp_2[6] = (tmp_1[4] - tmp_1[6]) * ComplexScalar(0, 1);
-      tmp_2[7] = (tmp_1[5] - tmp_1[7]) * ComplexScalar(-SQRT2DIV2, SQRT2DIV2);
-    }
-    data[0] = tmp_2[0] + tmp_2[4];
-    data[1] = tmp_2[1] + tmp_2[5];
-    data[2] = tmp_2[2] + tmp_2[6];
-    data[3] = tmp_2[3] + tmp_2[7];
-    data[4] = tmp_2[0] - tmp_2[4];
-    data[5] = tmp_2[1] - tmp_2[5];
-    data[6] = tmp_2[2] - tmp_2[6];
-    data[7] = tmp_2[3] - tmp_2[7];
-  }
-
-  template <int Dir>
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void butterfly_1D_merge(
-      ComplexScalar* data, Index n, Index n_power_of_2) {
-    // Original code:
-    // RealScalar wtemp = std::sin(M_PI/n);
-    // RealScalar wpi =  -std::sin(2 * M_PI/n);
-    const RealScalar wtemp = m_sin_PI_div_n_LUT[n_power_of_2];
-    const RealScalar wpi = (Dir == FFT_FORWARD)
-                               ? m_minus_sin_2_PI_div_n_LUT[n_power_of_2]
-                               : -m_minus_sin_2_PI_div_n_LUT[n_power_of_2];
-
-    const ComplexScalar wp(wtemp, wpi);
-    const ComplexScalar wp_one = wp + ComplexScalar(1, 0);
-    const ComplexScalar wp_one_2 = wp_one * wp_one;
-    const ComplexScalar wp_one_3 = wp_one_2 * wp_one;
-    const ComplexScalar wp_one_4 = wp_one_3 * wp_one;
-    const Index n2 = n / 2;
-    ComplexScalar w(1.0, 0.0);
-    for (Index i = 0; i < n2; i += 4) {
-       ComplexScalar temp0(data[i + n2] * w);
-       ComplexScalar temp1(data[i + 1 + n2] * w * wp_one);
-       ComplexScalar temp2(data[i + 2 + n2] * w * wp_one_2);
-       ComplexScalar temp3(data[i + 3 + n2] * w * wp_one_3);
-       w = w * wp_one_4;
-
-       data[i + n2] = data[i] - temp0;
-       data[i] += temp0;
-
-       data[i + 1 + n2] = data[i + 1] - temp1;
-       data[i + 1] += temp1;
-
-       data[i + 2 + n2] = data[i + 2] - temp2;
-       data[i + 2] += temp2;
-
-       data[i + 3 + n2] = data[i + 3] - temp3;
-       data[i + 3] += temp3;
-    }
-  }
-
- template <int Dir>
-  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void compute_1D_Butterfly(
-      ComplexScalar* data, Index n, Index n_power_of_2) {
-    eigen_assert(isPowerOfTwo(n));
-    if (n > 8) {
-      compute_1D_Butterfly<Dir>(data, n / 2, n_power_of_2 - 1);
-      compute_1D_Butterfly<Dir>(data + n / 2, n / 2, n_power_of_2 - 1);
-      butterfly_1D_merge<Dir>(data, n, n_power_of_2);
-    } else if (n == 8) {
-      butterfly_8<Dir>(data);
-    } else if (n == 4) {
-      butterfly_4<Dir>(data);
-    } else if (n == 2) {
-      butterfly_2<Dir>(data);
+      Index offset = base_offset;
+      const ComplexScalar div_factor =  ComplexScalar(1.0 / line_len, 0);
+      for (int j = 0; j < line_len; ++j, offset += stride) {
+         buf[offset] = (FFTDir == FFT_FORWARD) ? line_buf[j] : line_buf[j] * div_factor;
+      }
     }
   }
 
@@ -571,78 +659,6 @@ struct TensorEvaluator<const TensorFFTOp<FFT, ArgType, FFTResultType, FFTDir>, D
   CoeffReturnType* m_data;
   const Device& m_device;
 
-  // This will support a maximum FFT size of 2^32 for each dimension
-  // m_sin_PI_div_n_LUT[i] = (-2) * std::sin(M_PI / std::pow(2,i)) ^ 2;
-  const RealScalar m_sin_PI_div_n_LUT[32] = {
-    RealScalar(0.0),
-    RealScalar(-2),
-    RealScalar(-0.999999999999999),
-    RealScalar(-0.292893218813453),
-    RealScalar(-0.0761204674887130),
-    RealScalar(-0.0192147195967696),
-    RealScalar(-0.00481527332780311),
-    RealScalar(-0.00120454379482761),
-    RealScalar(-3.01181303795779e-04),
-    RealScalar(-7.52981608554592e-05),
-    RealScalar(-1.88247173988574e-05),
-    RealScalar(-4.70619042382852e-06),
-    RealScalar(-1.17654829809007e-06),
-    RealScalar(-2.94137117780840e-07),
-    RealScalar(-7.35342821488550e-08),
-    RealScalar(-1.83835707061916e-08),
-    RealScalar(-4.59589268710903e-09),
-    RealScalar(-1.14897317243732e-09),
-    RealScalar(-2.87243293150586e-10),
-    RealScalar( -7.18108232902250e-11),
-    RealScalar(-1.79527058227174e-11),
-    RealScalar(-4.48817645568941e-12),
-    RealScalar(-1.12204411392298e-12),
-    RealScalar(-2.80511028480785e-13),
-    RealScalar(-7.01277571201985e-14),
-    RealScalar(-1.75319392800498e-14),
-    RealScalar(-4.38298482001247e-15),
-    RealScalar(-1.09574620500312e-15),
-    RealScalar(-2.73936551250781e-16),
-    RealScalar(-6.84841378126949e-17),
-    RealScalar(-1.71210344531737e-17),
-    RealScalar(-4.28025861329343e-18)
-  };
-
-  // m_minus_sin_2_PI_div_n_LUT[i] = -std::sin(2 * M_PI / std::pow(2,i));
-  const RealScalar m_minus_sin_2_PI_div_n_LUT[32] = {
-    RealScalar(0.0),
-    RealScalar(0.0),
-    RealScalar(-1.00000000000000e+00),
-    RealScalar(-7.07106781186547e-01),
-    RealScalar(-3.82683432365090e-01),
-    RealScalar(-1.95090322016128e-01),
-    RealScalar(-9.80171403295606e-02),
-    RealScalar(-4.90676743274180e-02),
-    RealScalar(-2.45412285229123e-02),
-    RealScalar(-1.22715382857199e-02),
-    RealScalar(-6.13588464915448e-03),
-    RealScalar(-3.06795676296598e-03),
-    RealScalar(-1.53398018628477e-03),
-    RealScalar(-7.66990318742704e-04),
-    RealScalar(-3.83495187571396e-04),
-    RealScalar(-1.91747597310703e-04),
-    RealScalar(-9.58737990959773e-05),
-    RealScalar(-4.79368996030669e-05),
-    RealScalar(-2.39684498084182e-05),
-    RealScalar(-1.19842249050697e-05),
-    RealScalar(-5.99211245264243e-06),
-    RealScalar(-2.99605622633466e-06),
-    RealScalar(-1.49802811316901e-06),
-    RealScalar(-7.49014056584716e-07),
-    RealScalar(-3.74507028292384e-07),
-    RealScalar(-1.87253514146195e-07),
-    RealScalar(-9.36267570730981e-08),
-    RealScalar(-4.68133785365491e-08),
-    RealScalar(-2.34066892682746e-08),
-    RealScalar(-1.17033446341373e-08),
-    RealScalar(-5.85167231706864e-09),
-    RealScalar(-2.92583615853432e-09)
-  };
 };
 
 }  // end namespace Eigen
@@ -227,6 +227,24 @@ namespace internal {
         get_plan(n0,n1,true,dst,src).inv2(fftw_cast(dst), fftw_cast(src) ,n0,n1);
       }
 
+      // batched forward FFTs, one after the other
+      template <typename _Src>
+      inline
+      void fwd_batch( Complex * dst, DenseIndex ostride, DenseIndex odist, const _Src * src, DenseIndex istride, DenseIndex idist, int nfft, DenseIndex howmany)
+      {
+        const DenseIndex out_len = NumTraits<_Src>::IsComplex ? nfft : (nfft>>1)+1;
+        fft_batch_range(*this, fft_fwd_op(), dst,ostride,odist,out_len, src,istride,idist,nfft, nfft, 0,howmany);
+      }
+
+      // batched inverse FFTs, one after the other
+      template <typename _Dst>
+      inline
+      void inv_batch( _Dst * dst, DenseIndex ostride, DenseIndex odist, const Complex * src, DenseIndex istride, DenseIndex idist, int nfft, DenseIndex howmany)
+      {
+        const DenseIndex in_len = NumTraits<_Dst>::IsComplex ? nfft : (nfft>>1)+1;
+        fft_batch_range(*this, fft_inv_op(), dst,ostride,odist,nfft, src,istride,idist,in_len, nfft, 0,howmany);
+      }
+
 
   protected:
       typedef fftw_plan<Scalar> PlanData;
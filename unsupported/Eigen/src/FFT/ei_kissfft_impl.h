@@ -19,9 +19,16 @@ struct kiss_cpx_fft
 {
   typedef _Scalar Scalar;
   typedef std::complex<Scalar> Complex;
+  typedef typename packet_traits<Complex>::type Packet;
+  enum { PacketSize = unpacket_traits<Packet>::size };
   std::vector<Complex> m_twiddles;
   std::vector<int> m_stageRadix;
   std::vector<int> m_stageRemainder;
+  // the twiddles of the stages of radix 2 to 5, such that the butterflies
+  // read them contiguously: those of the q-th leg of the k-th butterfly of a
+  // stage of remainder m are at m_stageTwiddles[m_stageTwiddleOffset[stage]+(q-1)*m+k]
+  std::vector<Complex> m_stageTwiddles;
+  std::vector<size_t> m_stageTwiddleOffset;
   std::vector<Complex> m_scratchBuf;
   bool m_inverse;
 
@@ -57,6 +64,20 @@ struct kiss_cpx_fft
       if ( p > 5 )
         m_scratchBuf.resize(p); // scratchbuf will be needed in bfly_generic
     }while(n>1);
+
+    // gather the twiddles of each stage, whose stride in m_twiddles is the
+    // product of the radices of the previous stages
+    size_t fstride = 1;
+    for (size_t stage=0;stage<m_stageRadix.size();++stage) {
+      const int p = m_stageRadix[stage];
+      const int m = m_stageRemainder[stage];
+      m_stageTwiddleOffset.push_back(m_stageTwiddles.size());
+      if ( p <= 5 )
+        for (int q=1;q<p;++q)
+          for (int k=0;k<m;++k)
+            m_stageTwiddles.push_back( m_twiddles[q*k*fstride] );
+      fstride *= p;
+    }
   }
 
   template <typename _Src>
@@ -86,141 +107,152 @@ struct kiss_cpx_fft
       xout=Fout_beg;
 
       // recombine the p smaller DFTs 
+      const Complex * tw = m_stageTwiddles.empty() ? 0 : &m_stageTwiddles[0] + m_stageTwiddleOffset[stage];
       switch (p) {
-        case 2: bfly2(xout,fstride,m); break;
-        case 3: bfly3(xout,fstride,m); break;
-        case 4: bfly4(xout,fstride,m); break;
-        case 5: bfly5(xout,fstride,m); break;
+        case 1: break; // the FFT of size 1 is a copy
+        case 2: bfly2(xout,tw,m); break;
+        case 3: bfly3(xout,tw,fstride,m); break;
+        case 4: bfly4(xout,tw,m); break;
+        case 5: bfly5(xout,tw,fstride,m); break;
         default: bfly_generic(xout,fstride,m,p); break;
       }
     }
 
-  inline
-    void bfly2( Complex * Fout, const size_t fstride, int m)
+  // The butterflies of radix 2 to 5 are vectorized across the m butterflies
+  // of a stage: the k-th butterfly of each leg is loaded from Fout[q*m+k] and
+  // multiplied by the q-th twiddle of the stage, PacketSize butterflies at a
+  // time, the remaining ones being processed one by one.
+  template <typename Kernel>
+  static inline void bfly_loop(const Kernel& kernel, size_t m)
+  {
+    size_t k=0;
+    for (;k+PacketSize<=m;k+=PacketSize)
+      kernel.template run<Packet>(k);
+    for (;k<m;++k)
+      kernel.template run<Complex>(k);
+  }
+
+  // -i*x for the forward transforms, i*x for the inverse ones
+  template <typename P>
+  static EIGEN_STRONG_INLINE P rotate(const P& x, bool inverse)
+  {
+    return inverse ? pcplxflip(pconj(x)) : pconj(pcplxflip(x));
+  }
+
+  struct bfly2_kernel
+  {
+    Complex * Fout; const Complex * tw; size_t m;
+    template <typename P> EIGEN_STRONG_INLINE void run(size_t k) const
     {
-      for (int k=0;k<m;++k) {
-        Complex t = Fout[m+k] * m_twiddles[k*fstride];
-        Fout[m+k] = Fout[k] - t;
-        Fout[k] += t;
-      }
+      const P t = pmul(ploadu<P>(Fout+m+k), ploadu<P>(tw+k));
+      const P f = ploadu<P>(Fout+k);
+      pstoreu(Fout+m+k, psub(f,t));
+      pstoreu(Fout+k, padd(f,t));
     }
+  };
 
   inline
-    void bfly4( Complex * Fout, const size_t fstride, const size_t m)
+    void bfly2( Complex * Fout, const Complex * tw, size_t m)
     {
-      Complex scratch[6];
-      int negative_if_inverse = m_inverse * -2 +1;
-      for (size_t k=0;k<m;++k) {
-        scratch[0] = Fout[k+m] * m_twiddles[k*fstride];
-        scratch[1] = Fout[k+2*m] * m_twiddles[k*fstride*2];
-        scratch[2] = Fout[k+3*m] * m_twiddles[k*fstride*3];
-        scratch[5] = Fout[k] - scratch[1];
-
-        Fout[k] += scratch[1];
-        scratch[3] = scratch[0] + scratch[2];
-        scratch[4] = scratch[0] - scratch[2];
-        scratch[4] = Complex( scratch[4].imag()*negative_if_inverse , -scratch[4].real()* negative_if_inverse );
-
-        Fout[k+2*m]  = Fout[k] - scratch[3];
-        Fout[k] += scratch[3];
-        Fout[k+m] = scratch[5] + scratch[4];
-        Fout[k+3*m] = scratch[5] - scratch[4];
-      }
+      bfly2_kernel kernel = { Fout, tw, m };
+      bfly_loop(kernel, m);
     }
 
-  inline
-    void bfly3( Complex * Fout, const size_t fstride, const size_t m)
+  struct bfly4_kernel
+  {
+    Complex * Fout; const Complex * tw; size_t m; bool inverse;
+    template <typename P> EIGEN_STRONG_INLINE void run(size_t k) const
     {
-      size_t k=m;
-      const size_t m2 = 2*m;
-      Complex *tw1,*tw2;
-      Complex scratch[5];
-      Complex epi3;
-      epi3 = m_twiddles[fstride*m];
-
-      tw1=tw2=&m_twiddles[0];
-
-      do{
-        scratch[1]=Fout[m] * *tw1;
-        scratch[2]=Fout[m2] * *tw2;
-
-        scratch[3]=scratch[1]+scratch[2];
-        scratch[0]=scratch[1]-scratch[2];
-        tw1 += fstride;
-        tw2 += fstride*2;
-        Fout[m] = Complex( Fout->real() - Scalar(.5)*scratch[3].real() , Fout->imag() - Scalar(.5)*scratch[3].imag() );
-        scratch[0] *= epi3.imag();
-        *Fout += scratch[3];
-        Fout[m2] = Complex(  Fout[m].real() + scratch[0].imag() , Fout[m].imag() - scratch[0].real() );
-        Fout[m] += Complex( -scratch[0].imag(),scratch[0].real() );
-        ++Fout;
-      }while(--k);
+      const P s0 = pmul(ploadu<P>(Fout+k+m), ploadu<P>(tw+k));
+      const P s1 = pmul(ploadu<P>(Fout+k+2*m), ploadu<P>(tw+m+k));
+      const P s2 = pmul(ploadu<P>(Fout+k+3*m), ploadu<P>(tw+2*m+k));
+      const P f = ploadu<P>(Fout+k);
+      const P s5 = psub(f,s1);
+      const P f0 = padd(f,s1);
+      const P s3 = padd(s0,s2);
+      const P s4 = rotate(psub(s0,s2), inverse);
+      pstoreu(Fout+k+2*m, psub(f0,s3));
+      pstoreu(Fout+k, padd(f0,s3));
+      pstoreu(Fout+k+m, padd(s5,s4));
+      pstoreu(Fout+k+3*m, psub(s5,s4));
     }
+  };
 
   inline
-    void bfly5( Complex * Fout, const size_t fstride, const size_t m)
+    void bfly4( Complex * Fout, const Complex * tw, size_t m)
     {
-      Complex *Fout0,*Fout1,*Fout2,*Fout3,*Fout4;
-      size_t u;
-      Complex scratch[13];
-      Complex * twiddles = &m_twiddles[0];
-      Complex *tw;
-      Complex ya,yb;
-      ya = twiddles[fstride*m];
-      yb = twiddles[fstride*2*m];
-
-      Fout0=Fout;
-      Fout1=Fout0+m;
-      Fout2=Fout0+2*m;
-      Fout3=Fout0+3*m;
-      Fout4=Fout0+4*m;
-
-      tw=twiddles;
-      for ( u=0; u<m; ++u ) {
-        scratch[0] = *Fout0;
-
-        scratch[1]  = *Fout1 * tw[u*fstride];
-        scratch[2]  = *Fout2 * tw[2*u*fstride];
-        scratch[3]  = *Fout3 * tw[3*u*fstride];
-        scratch[4]  = *Fout4 * tw[4*u*fstride];
-
-        scratch[7] = scratch[1] + scratch[4];
-        scratch[10] = scratch[1] - scratch[4];
-        scratch[8] = scratch[2] + scratch[3];
-        scratch[9] = scratch[2] - scratch[3];
-
-        *Fout0 +=  scratch[7];
-        *Fout0 +=  scratch[8];
-
-        scratch[5] = scratch[0] + Complex(
-            (scratch[7].real()*ya.real() ) + (scratch[8].real() *yb.real() ),
-            (scratch[7].imag()*ya.real()) + (scratch[8].imag()*yb.real())
-            );
-
-        scratch[6] = Complex(
-            (scratch[10].imag()*ya.imag()) + (scratch[9].imag()*yb.imag()),
-            -(scratch[10].real()*ya.imag()) - (scratch[9].real()*yb.imag())
-            );
-
-        *Fout1 = scratch[5] - scratch[6];
-        *Fout4 = scratch[5] + scratch[6];
+      bfly4_kernel kernel = { Fout, tw, m, m_inverse };
+      bfly_loop(kernel, m);
+    }
 
-        scratch[11] = scratch[0] +
-          Complex(
-              (scratch[7].real()*yb.real()) + (scratch[8].real()*ya.real()),
-              (scratch[7].imag()*yb.real()) + (scratch[8].imag()*ya.real())
-              );
+  struct bfly3_kernel
+  {
+    Complex * Fout; const Complex * tw; size_t m; Complex half; Complex epi3;
+    template <typename P> EIGEN_STRONG_INLINE void run(size_t k) const
+    {
+      const P s1 = pmul(ploadu<P>(Fout+m+k), ploadu<P>(tw+k));
+      const P s2 = pmul(ploadu<P>(Fout+2*m+k), ploadu<P>(tw+m+k));
+      const P s3 = padd(s1,s2);
+      // (s1-s2) * (-i*imag(epi3))
+      const P s0 = pmul(psub(s1,s2), pset1<P>(epi3));
+      const P f = ploadu<P>(Fout+k);
+      const P fm = psub(f, pmul(s3, pset1<P>(half)));
+      pstoreu(Fout+k, padd(f,s3));
+      pstoreu(Fout+2*m+k, padd(fm,s0));
+      pstoreu(Fout+m+k, psub(fm,s0));
+    }
+  };
 
-        scratch[12] = Complex(
-            -(scratch[10].imag()*yb.imag()) + (scratch[9].imag()*ya.imag()),
-            (scratch[10].real()*yb.imag()) - (scratch[9].real()*ya.imag())
-            );
+  inline
+    void bfly3( Complex * Fout, const Complex * tw, const size_t fstride, const size_t m)
+    {
+      const Scalar epi3 = m_twiddles[fstride*m].imag();
+      bfly3_kernel kernel = { Fout, tw, m, Complex(Scalar(.5),0), Complex(0,-epi3) };
+      bfly_loop(kernel, m);
+    }
 
-        *Fout2=scratch[11]+scratch[12];
-        *Fout3=scratch[11]-scratch[12];
+  struct bfly5_kernel
+  {
+    Complex * Fout; const Complex * tw; size_t m;
+    Complex yar, ybr, yai, ybi;  // real(ya), real(yb), -i*imag(ya), -i*imag(yb)
+    template <typename P> EIGEN_STRONG_INLINE void run(size_t k) const
+    {
+      const P s0 = ploadu<P>(Fout+k);
+      const P s1 = pmul(ploadu<P>(Fout+m+k), ploadu<P>(tw+k));
+      const P s2 = pmul(ploadu<P>(Fout+2*m+k), ploadu<P>(tw+m+k));
+      const P s3 = pmul(ploadu<P>(Fout+3*m+k), ploadu<P>(tw+2*m+k));
+      const P s4 = pmul(ploadu<P>(Fout+4*m+k), ploadu<P>(tw+3*m+k));
+
+      const P s7 = padd(s1,s4);
+      const P s10 = psub(s1,s4);
+      const P s8 = padd(s2,s3);
+      const P s9 = psub(s2,s3);
+
+      pstoreu(Fout+k, padd(s0, padd(s7,s8)));
+
+      const P yar_ = pset1<P>(yar), ybr_ = pset1<P>(ybr);
+      const P yai_ = pset1<P>(yai), ybi_ = pset1<P>(ybi);
+      const P s5 = padd(s0, padd(pmul(s7,yar_), pmul(s8,ybr_)));
+      const P s6 = padd(pmul(s10,yai_), pmul(s9,ybi_));
+      pstoreu(Fout+m+k, psub(s5,s6));
+      pstoreu(Fout+4*m+k, padd(s5,s6));
+
+      const P s11 = padd(s0, padd(pmul(s7,ybr_), pmul(s8,yar_)));
+      const P s12 = psub(pmul(s9,yai_), pmul(s10,ybi_));
+      pstoreu(Fout+2*m+k, padd(s11,s12));
+      pstoreu(Fout+3*m+k, psub(s11,s12));
+    }
+  };
 
-        ++Fout0;++Fout1;++Fout2;++Fout3;++Fout4;
-      }
+  inline
+    void bfly5( Complex * Fout, const Complex * tw, const size_t fstride, const size_t m)
+    {
+      const Complex ya = m_twiddles[fstride*m];
+      const Complex yb = m_twiddles[fstride*2*m];
+      bfly5_kernel kernel = { Fout, tw, m,
+                              Complex(ya.real(),0), Complex(yb.real(),0),
+                              Complex(0,-ya.imag()), Complex(0,-yb.imag()) };
+      bfly_loop(kernel, m);
     }
 
   /* perform the butterfly for one stage of a mixed radix FFT */
@@ -304,15 +336,16 @@ struct kissfft_impl
   inline
     void fwd( Complex * dst,const Scalar * src,int nfft) 
     {
-      if ( nfft&3  ) {
-        // use generic mode for odd
+      if ( nfft&1  ) {
+        // use generic mode for odd: there is no half-length transform for odd
+        // sizes, the real input goes through the full-length complex FFT
         m_tmpBuf1.resize(nfft);
         get_plan(nfft,false).work(0, &m_tmpBuf1[0], src, 1,1);
         std::copy(m_tmpBuf1.begin(),m_tmpBuf1.begin()+(nfft>>1)+1,dst );
       }else{
         int ncfft = nfft>>1;
-        int ncfft2 = nfft>>2;
-        Complex * rtw = real_twiddles(ncfft2);
+        int ncfft2 = ncfft>>1;
+        const Complex * rtw = real_twiddles(ncfft);
 
         // use optimized mode for even real
         fwd( dst, reinterpret_cast<const Complex*> (src), ncfft);
@@ -344,7 +377,9 @@ struct kissfft_impl
   inline
     void inv( Scalar * dst,const Complex * src,int nfft) 
     {
-      if (nfft&3) {
+      if (nfft&1) {
+        // use generic mode for odd: the full spectrum is rebuilt from its
+        // conjugate symmetry and inverted by the full-length complex FFT
         m_tmpBuf1.resize(nfft);
         m_tmpBuf2.resize(nfft);
         std::copy(src,src+(nfft>>1)+1,m_tmpBuf1.begin() );
@@ -354,10 +389,9 @@ struct kissfft_impl
         for (int k=0;k<nfft;++k)
           dst[k] = m_tmpBuf2[k].real();
       }else{
-        // optimized version for multiple of 4
+        // optimized version for even sizes
         int ncfft = nfft>>1;
-        int ncfft2 = nfft>>2;
-        Complex * rtw = real_twiddles(ncfft2);
+        const Complex * rtw = real_twiddles(ncfft);
         m_tmpBuf1.resize(ncfft);
         m_tmpBuf1[0] = Complex( src[0].real() + src[ncfft].real(), src[0].real() - src[ncfft].real() );
         for (int k = 1; k <= ncfft / 2; ++k) {
@@ -373,7 +407,62 @@ struct kissfft_impl
       }
     }
 
+  // batched forward FFTs
+  template <typename _Src>
+  inline
+    void fwd_batch( Complex * dst, DenseIndex ostride, DenseIndex odist, const _Src * src, DenseIndex istride, DenseIndex idist, int nfft, DenseIndex howmany)
+    {
+      const DenseIndex out_len = NumTraits<_Src>::IsComplex ? nfft : (nfft>>1)+1;
+      run_batch(fft_fwd_op(), dst,ostride,odist,out_len, src,istride,idist,nfft, nfft,howmany);
+    }
+
+  // batched inverse FFTs
+  template <typename _Dst>
+  inline
+    void inv_batch( _Dst * dst, DenseIndex ostride, DenseIndex odist, const Complex * src, DenseIndex istride, DenseIndex idist, int nfft, DenseIndex howmany)
+    {
+      const DenseIndex in_len = NumTraits<_Dst>::IsComplex ? nfft : (nfft>>1)+1;
+      run_batch(fft_inv_op(), dst,ostride,odist,nfft, src,istride,idist,in_len, nfft,howmany);
+    }
+
   protected:
+  template <typename Op, typename Dst, typename Src>
+  inline
+    void run_batch(Op op, Dst * dst, DenseIndex ostride, DenseIndex odist, DenseIndex out_len,
+                   const Src * src, DenseIndex istride, DenseIndex idist, DenseIndex in_len, int nfft, DenseIndex howmany)
+    {
+#ifdef EIGEN_HAS_OPENMP
+      DenseIndex threads = Eigen::nbThreads();
+      if ( omp_get_num_threads()>1 || howmany<2 || howmany*nfft<20000 )
+        threads = 1;
+      if ( threads>1 ) {
+        // the first transform creates the plan, which is then copied by each thread:
+        // the real transforms of even size use a complex plan of half their size
+        // and the real twiddles of that size
+        fft_batch_range(*this, op, dst,ostride,odist,out_len, src,istride,idist,in_len, nfft, 0,1);
+        const bool halfLength = !(NumTraits<Src>::IsComplex && NumTraits<Dst>::IsComplex) && (nfft&1)==0;
+        const int planSize = halfLength ? nfft>>1 : nfft;
+        const int key = PlanKey(planSize, is_same<Op,fft_inv_op>::value);
+        const PlanData & plan = m_plans.find(key)->second;
+        const std::vector<Complex> * realTwiddles = halfLength ? &m_realTwiddles.find(planSize)->second : 0;
+        #pragma omp parallel num_threads(threads)
+        {
+          kissfft_impl local;
+          local.m_plans[key] = plan;
+          if ( realTwiddles )
+            local.m_realTwiddles[planSize] = *realTwiddles;
+          const DenseIndex nt = omp_get_num_threads();
+          const DenseIndex t = omp_get_thread_num();
+          const DenseIndex begin = 1 + ((howmany-1)*t)/nt;
+          const DenseIndex end = 1 + ((howmany-1)*(t+1))/nt;
+          fft_batch_range(local, op, dst,ostride,odist,out_len, src,istride,idist,in_len, nfft, begin,end);
+        }
+        return;
+      }
+#endif
+      fft_batch_range(*this, op, dst,ostride,odist,out_len, src,istride,idist,in_len, nfft, 0,howmany);
+    }
+
   typedef kiss_cpx_fft<Scalar> PlanData;
   typedef std::map<int,PlanData> PlanMap;
 
@@ -397,19 +486,21 @@ struct kissfft_impl
       return pd;
     }
 
+  // the twiddles recombining the half-length complex FFT of the real FFTs of
+  // size 2*ncfft: exp(-i*pi*(k/ncfft + 1/2)) for k = 1,...,ncfft/2
   inline
-    Complex * real_twiddles(int ncfft2)
+    const Complex * real_twiddles(int ncfft)
     {
       using std::acos;
-      std::vector<Complex> & twidref = m_realTwiddles[ncfft2];// creates new if not there
+      const int ncfft2 = ncfft>>1;
+      std::vector<Complex> & twidref = m_realTwiddles[ncfft];// creates new if not there
       if ( (int)twidref.size() != ncfft2 ) {
         twidref.resize(ncfft2);
-        int ncfft= ncfft2<<1;
         Scalar pi =  acos( Scalar(-1) );
         for (int k=1;k<=ncfft2;++k) 
           twidref[k-1] = exp( Complex(0,-pi * (Scalar(k) / ncfft + Scalar(.5)) ) );
       }
-      return &twidref[0];
+      return twidref.empty() ? 0 : &twidref[0];
     }
 };
 
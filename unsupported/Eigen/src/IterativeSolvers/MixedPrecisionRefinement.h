@@ -0,0 +1,312 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_MIXED_PRECISION_REFINEMENT_H
+#define EIGEN_MIXED_PRECISION_REFINEMENT_H
+
+namespace Eigen {
+
+template<typename _MatrixType, typename _Factorization> class MixedPrecisionRefinement;
+
+namespace internal {
+
+template<typename _MatrixType, typename _Factorization>
+struct traits<MixedPrecisionRefinement<_MatrixType,_Factorization> >
+ : traits<_MatrixType>
+{
+  typedef MatrixXpr XprKind;
+  typedef SolverStorage StorageKind;
+  typedef traits<_MatrixType> BaseTraits;
+  enum {
+    Flags = BaseTraits::Flags & RowMajorBit,
+    CoeffReadCost = Dynamic
+  };
+};
+
+/** \internal
+  * Describes how a low precision factorization is used by MixedPrecisionRefinement:
+  *  - FullPrecisionType is the same factorization on \a MatrixType, used as the fallback,
+  *  - product() computes the product of the full precision matrix with a vector,
+  *  - info() reports whether the factorization succeeded.
+  */
+template<typename Factorization, typename MatrixType>
+struct mixed_precision_factorization_traits;
+
+template<typename FactorMatrixType, typename MatrixType>
+struct mixed_precision_factorization_traits<PartialPivLU<FactorMatrixType>, MatrixType>
+{
+  typedef PartialPivLU<MatrixType> FullPrecisionType;
+
+  template<typename Rhs>
+  static const Product<MatrixType,Rhs> product(const MatrixType& mat, const Rhs& x) { return mat * x; }
+
+  template<typename Dec>
+  static ComputationInfo info(const Dec& lu)
+  {
+    // PartialPivLU does not report failures, check that U is finite and invertible
+    bool ok = lu.matrixLU().allFinite() && (lu.matrixLU().diagonal().array() != typename Dec::Scalar(0)).all();
+    return ok ? Success : NumericalIssue;
+  }
+};
+
+template<typename FactorMatrixType, int UpLo, typename MatrixType>
+struct mixed_precision_factorization_traits<LLT<FactorMatrixType,UpLo>, MatrixType>
+{
+  typedef LLT<MatrixType,UpLo> FullPrecisionType;
+
+  template<typename Rhs>
+  static const Product<SelfAdjointView<const MatrixType,UpLo>,Rhs> product(const MatrixType& mat, const Rhs& x)
+  { return mat.template selfadjointView<UpLo>() * x; }
+
+  template<typename Dec>
+  static ComputationInfo info(const Dec& dec) { return dec.info(); }
+};
+
+template<typename FactorMatrixType, int UpLo, typename MatrixType>
+struct mixed_precision_factorization_traits<LDLT<FactorMatrixType,UpLo>, MatrixType>
+{
+  typedef LDLT<MatrixType,UpLo> FullPrecisionType;
+
+  template<typename Rhs>
+  static const Product<SelfAdjointView<const MatrixType,UpLo>,Rhs> product(const MatrixType& mat, const Rhs& x)
+  { return mat.template selfadjointView<UpLo>() * x; }
+
+  template<typename Dec>
+  static ComputationInfo info(const Dec& dec)
+  {
+    // LDLT succeeds on singular matrices, but its solutions are then meaningless
+    return (dec.info()==Success && (dec.vectorD().array() != typename Dec::Scalar(0)).all()) ? Success : NumericalIssue;
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeSolvers_Module
+  *
+  * \class MixedPrecisionRefinement
+  *
+  * \brief Dense solver computing the factorization in low precision and refining the solutions in full precision
+  *
+  * \tparam _MatrixType the type of the matrix of the problem, for instance MatrixXd
+  * \tparam _Factorization the low precision factorization, for instance PartialPivLU<MatrixXf>.
+  *         PartialPivLU, LLT and LDLT are supported.
+  *
+  * This class solves \f$ A x = b \f$ by computing the factorization of A in the scalar type of \a _Factorization,
+  * typically \c float, and by refining the low precision solutions with the residuals \f$ r = b - A x \f$
+  * computed in the scalar type of \a _MatrixType, as LAPACK's xSGESV and xSPOSV routines. On
+  * reasonably well-conditioned problems, this yields full precision solutions at the cost of a
+  * low precision factorization, which is about twice faster.
+  *
+  * The refinement of a solution stops when, for every column, the infinity norm of the residual is less than
+  * \f$ \sqrt{n} \epsilon \| A \|_\infty \| x \|_\infty \f$, where \f$ \epsilon \f$ is the machine
+  * precision of \a _MatrixType. If this does not happen within maxIterations() steps, or if A cannot be
+  * represented or factorized in low precision, the same factorization is computed in full precision
+  * and used from then on.
+  *
+  * \code
+  * MatrixXd A = ...;
+  * VectorXd b = ...;
+  * MixedPrecisionRefinement<MatrixXd, PartialPivLU<MatrixXf> > solver(A);
+  * VectorXd x = solver.solve(b);
+  * \endcode
+  *
+  * This class follows the SolverBase interface. However, only solve() is supported, not transpose().solve().
+  *
+  * \warning The fallback factorization is computed lazily by solve(), which is therefore not thread safe.
+  *
+  * \sa class PartialPivLU, class LLT, class LDLT
+  */
+template<typename _MatrixType, typename _Factorization>
+class MixedPrecisionRefinement
+  : public SolverBase<MixedPrecisionRefinement<_MatrixType,_Factorization> >
+{
+  public:
+
+    typedef _MatrixType MatrixType;
+    typedef _Factorization Factorization;
+    typedef SolverBase<MixedPrecisionRefinement> Base;
+    EIGEN_GENERIC_PUBLIC_INTERFACE(MixedPrecisionRefinement)
+    enum {
+      MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime,
+      MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime
+    };
+    typedef typename Factorization::MatrixType FactorMatrixType;
+    typedef typename FactorMatrixType::Scalar FactorScalar;
+    typedef internal::mixed_precision_factorization_traits<Factorization,MatrixType> FactorizationTraits;
+    typedef typename FactorizationTraits::FullPrecisionType FullPrecisionFactorization;
+
+    /** Default constructor, see compute() */
+    MixedPrecisionRefinement()
+      : m_maxIterations(30), m_anorm(0), m_iterations(0), m_info(InvalidInput),
+        m_useFullPrecision(false), m_isInitialized(false)
+    {}
+
+    /** Constructs and computes the factorization of \a matrix */
+    template<typename InputType>
+    explicit MixedPrecisionRefinement(const EigenBase<InputType>& matrix)
+      : m_maxIterations(30), m_anorm(0), m_iterations(0), m_info(InvalidInput),
+        m_useFullPrecision(false), m_isInitialized(false)
+    {
+      compute(matrix.derived());
+    }
+
+    /** Computes the low precision factorization of \a matrix, which is also copied in full precision
+      * for the computation of the residuals. */
+    template<typename InputType>
+    MixedPrecisionRefinement& compute(const EigenBase<InputType>& matrix);
+
+    /** Sets the maximal number of refinement steps of solve(). The default is 30, as in LAPACK. */
+    MixedPrecisionRefinement& setMaxIterations(Index maxIters)
+    {
+      m_maxIterations = maxIters;
+      return *this;
+    }
+
+    /** \returns the maximal number of refinement steps */
+    Index maxIterations() const { return m_maxIterations; }
+
+    /** \returns the number of refinement steps performed by the last call to solve(),
+      * or -1 if it had to fall back to the full precision factorization. */
+    Index iterations() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionRefinement is not initialized.");
+      return m_iterations;
+    }
+
+    /** \returns true if the solutions are now computed by the full precision factorization */
+    bool usesFullPrecision() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionRefinement is not initialized.");
+      return m_useFullPrecision;
+    }
+
+    /** \returns the low precision factorization */
+    const Factorization& factorization() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionRefinement is not initialized.");
+      return m_factorization;
+    }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was succesful,
+      *          \c NumericalIssue if neither the low precision nor the full precision factorization succeeded.
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionRefinement is not initialized.");
+      return m_info;
+    }
+
+    inline Index rows() const { return m_matrix.rows(); }
+    inline Index cols() const { return m_matrix.cols(); }
+
+    #ifndef EIGEN_PARSED_BY_DOXYGEN
+    template<typename RhsType, typename DstType>
+    void _solve_impl(const RhsType &rhs, DstType &dst) const;
+    #endif
+
+  protected:
+
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar);
+      EIGEN_STATIC_ASSERT((int(NumTraits<Scalar>::IsComplex) == int(NumTraits<FactorScalar>::IsComplex)),
+                          YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY);
+    }
+
+    void computeFullPrecision() const
+    {
+      m_fullPrecision.compute(m_matrix);
+      m_useFullPrecision = true;
+      m_info = FactorizationTraits::info(m_fullPrecision);
+    }
+
+    MatrixType m_matrix;
+    Factorization m_factorization;
+    Index m_maxIterations;
+    RealScalar m_anorm;
+    mutable FullPrecisionFactorization m_fullPrecision;
+    mutable Index m_iterations;
+    mutable ComputationInfo m_info;
+    mutable bool m_useFullPrecision;
+    bool m_isInitialized;
+};
+
+template<typename MatrixType, typename Factorization>
+template<typename InputType>
+MixedPrecisionRefinement<MatrixType,Factorization>&
+MixedPrecisionRefinement<MatrixType,Factorization>::compute(const EigenBase<InputType>& matrix)
+{
+  check_template_parameters();
+
+  eigen_assert(matrix.rows() == matrix.cols() && "MixedPrecisionRefinement is only for square matrices");
+  m_matrix = matrix.derived();
+  m_useFullPrecision = false;
+  m_iterations = 0;
+  m_isInitialized = true;
+
+  // infinity norm of A, it also detects the matrices which do not fit in the low precision type
+  m_anorm = m_matrix.cwiseAbs().rowwise().sum().maxCoeff();
+  typedef typename NumTraits<FactorScalar>::Real FactorRealScalar;
+  if(!((numext::isfinite)(m_anorm) && m_anorm <= RealScalar(NumTraits<FactorRealScalar>::highest())))
+  {
+    computeFullPrecision();
+    return *this;
+  }
+
+  m_factorization.compute(m_matrix.template cast<FactorScalar>());
+  m_info = FactorizationTraits::info(m_factorization);
+  if(m_info != Success)
+    computeFullPrecision();
+  return *this;
+}
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+template<typename MatrixType, typename Factorization>
+template<typename RhsType, typename DstType>
+void MixedPrecisionRefinement<MatrixType,Factorization>::_solve_impl(const RhsType &rhs, DstType &dst) const
+{
+  eigen_assert(m_isInitialized && "MixedPrecisionRefinement is not initialized.");
+  using std::sqrt;
+  typedef typename NumTraits<FactorScalar>::Real FactorRealScalar;
+  typedef typename RhsType::PlainObject RhsPlainObject;
+
+  // rhs might be an expression, or alias dst
+  const RhsPlainObject b(rhs);
+  if(!m_useFullPrecision)
+  {
+    const RealScalar tol = sqrt(RealScalar(rows())) * NumTraits<RealScalar>::epsilon() * m_anorm;
+    const RealScalar overflow = RealScalar(NumTraits<FactorRealScalar>::highest());
+
+    RhsPlainObject r = b;
+    dst.setZero();
+    for(m_iterations = 0; ; ++m_iterations)
+    {
+      // the residuals which do not fit in the low precision type cannot be refined
+      RealScalar rmax = r.cwiseAbs().maxCoeff();
+      if(!((numext::isfinite)(rmax) && rmax <= overflow))
+        break;
+      dst += m_factorization.solve(r.template cast<FactorScalar>()).template cast<Scalar>();
+
+      r = b;
+      r.noalias() -= FactorizationTraits::product(m_matrix, dst);
+      if((r.cwiseAbs().colwise().maxCoeff().array() <= tol * dst.cwiseAbs().colwise().maxCoeff().array()).all())
+        return;
+      if(m_iterations >= m_maxIterations)
+        break;
+    }
+    computeFullPrecision();
+  }
+  m_iterations = -1;
+  dst = m_fullPrecision.solve(b);
+}
+#endif
+
+} // end namespace Eigen
+
+#endif // EIGEN_MIXED_PRECISION_REFINEMENT_H
@@ -0,0 +1,259 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_BINARY_FILE_H
+#define EIGEN_SPARSE_BINARY_FILE_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Content of a file, memory mapped when possible, or read into memory otherwise.
+  * The mapping is private: writing to data() does not modify the file. */
+class mapped_file
+{
+  public:
+    mapped_file() : m_data(0), m_size(0), m_mapped(false) {}
+    ~mapped_file() { close(); }
+
+    bool open(const std::string& filename)
+    {
+      close();
+#if !defined(_WIN32)
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if(fd<0)
+        return false;
+      struct stat st;
+      if(::fstat(fd, &st)!=0)
+      {
+        ::close(fd);
+        return false;
+      }
+      m_size = std::size_t(st.st_size);
+      if(m_size>0)
+      {
+        void* data = ::mmap(0, m_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if(data!=MAP_FAILED)
+        {
+          m_data = static_cast<char*>(data);
+          m_mapped = true;
+        }
+      }
+      ::close(fd);
+      if(m_mapped || m_size==0)
+        return true;
+#endif
+      std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+      if(!in)
+        return false;
+      in.seekg(0, std::ios::end);
+      m_size = std::size_t(in.tellg());
+      in.seekg(0, std::ios::beg);
+      if(m_size==0)
+        return true;
+      m_data = static_cast<char*>(aligned_malloc(m_size));
+      in.read(m_data, std::streamsize(m_size));
+      if(!in)
+      {
+        close();
+        return false;
+      }
+      return true;
+    }
+
+    void close()
+    {
+#if !defined(_WIN32)
+      if(m_mapped)
+        ::munmap(m_data, m_size);
+      else
+#endif
+        aligned_free(m_data);
+      m_data = 0;
+      m_size = 0;
+      m_mapped = false;
+    }
+
+    char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+  private:
+    mapped_file(const mapped_file&);
+    mapped_file& operator=(const mapped_file&);
+
+    char* m_data;
+    std::size_t m_size;
+    bool m_mapped;
+};
+
+enum { BinaryDenseKind = 0, BinaryTensorKind = 1, BinarySparseKind = 2 };
+enum { BinaryFormatVersion = 1, BinaryFormatAlignment = 64 };
+
+/** \internal Header of the binary files, followed by the dimensions as 64 bits integers, then by the arrays
+  * of coefficients, each starting at a multiple of \c alignment bytes from the beginning of the file:
+  *  - the coefficients, in storage order, for dense matrices and tensors,
+  *  - the outer index, the inner index and the value arrays of the compressed storage for sparse matrices.
+  */
+struct binary_header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t kind;         // BinaryDenseKind, BinaryTensorKind or BinarySparseKind
+  uint32_t scalarKind;   // 0 for floating point, 1 for complex, 2 for signed and 3 for unsigned integer types
+  uint32_t scalarSize;
+  uint32_t indexSize;    // size of the indices of the sparse matrices, 0 otherwise
+  uint32_t flags;        // RowMajorBit for row major objects
+  uint32_t rank;         // number of dimensions
+  uint32_t alignment;
+  int64_t nonZeros;      // number of stored coefficients
+};
+
+/** \internal Offsets of the arrays of a binary file */
+struct binary_layout
+{
+  int64_t outer, inner, values, size;
+};
+
+inline int64_t binary_align(int64_t offset, int64_t alignment)
+{
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+inline binary_layout binary_compute_layout(const binary_header& header, const int64_t* dims)
+{
+  binary_layout layout;
+  int64_t offset = binary_align(sizeof(binary_header) + header.rank*sizeof(int64_t), header.alignment);
+  layout.outer = layout.inner = 0;
+  if(header.kind==BinarySparseKind)
+  {
+    const int64_t outerSize = (header.flags & RowMajorBit) ? dims[0] : dims[1];
+    layout.outer = offset;
+    offset = binary_align(offset + (outerSize+1)*header.indexSize, header.alignment);
+    layout.inner = offset;
+    offset = binary_align(offset + header.nonZeros*header.indexSize, header.alignment);
+  }
+  layout.values = offset;
+  layout.size = offset + header.nonZeros*header.scalarSize;
+  return layout;
+}
+
+template<typename Scalar>
+uint32_t binary_scalar_kind()
+{
+  return NumTraits<Scalar>::IsComplex ? 1 : !NumTraits<Scalar>::IsInteger ? 0 : NumTraits<Scalar>::IsSigned ? 2 : 3;
+}
+
+template<typename Scalar>
+void binary_init_header(binary_header& header, uint32_t kind, uint32_t rank, bool isRowMajor, int64_t nonZeros,
+                        uint32_t indexSize)
+{
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "EIGENBIN", 8);
+  header.version = BinaryFormatVersion;
+  header.kind = kind;
+  header.scalarKind = binary_scalar_kind<Scalar>();
+  header.scalarSize = sizeof(Scalar);
+  header.indexSize = indexSize;
+  header.flags = isRowMajor ? RowMajorBit : 0;
+  header.rank = rank;
+  header.alignment = BinaryFormatAlignment;
+  header.nonZeros = nonZeros;
+}
+
+/** \internal Reads the header and the dimensions of the binary file \a file, and computes its layout
+  * \returns false if \a file is not a valid binary file */
+inline bool binary_read_header(const mapped_file& file, binary_header& header, std::vector<int64_t>& dims,
+                               binary_layout& layout)
+{
+  if(file.size() < sizeof(binary_header))
+    return false;
+  std::memcpy(&header, file.data(), sizeof(header));
+  if(std::memcmp(header.magic, "EIGENBIN", 8)!=0 || header.version!=BinaryFormatVersion
+     || header.alignment==0 || header.rank>64
+     || file.size() < sizeof(binary_header) + header.rank*sizeof(int64_t))
+    return false;
+  dims.resize(header.rank);
+  if(header.rank>0)
+    std::memcpy(&dims[0], file.data() + sizeof(header), header.rank*sizeof(int64_t));
+  layout = binary_compute_layout(header, dims.empty() ? 0 : &dims[0]);
+  return int64_t(file.size()) >= layout.size;
+}
+
+/** \internal \returns whether \a header describes an object of the given kind and rank, made of \a Scalar */
+template<typename Scalar>
+bool binary_check_header(const binary_header& header, int kind, int rank, int indexSize)
+{
+  return header.kind==uint32_t(kind) && header.rank==uint32_t(rank)
+      && header.scalarKind==binary_scalar_kind<Scalar>() && header.scalarSize==sizeof(Scalar)
+      && header.indexSize==uint32_t(indexSize);
+}
+
+inline bool binary_write_padding(std::ostream& out, int64_t offset)
+{
+  static const char zeros[BinaryFormatAlignment] = {0};
+  int64_t pos = int64_t(out.tellp());
+  eigen_assert(pos<=offset);
+  for(; pos<offset && out; pos += BinaryFormatAlignment)
+    out.write(zeros, std::streamsize((std::min<int64_t>)(offset-pos, BinaryFormatAlignment)));
+  return bool(out);
+}
+
+/** \internal Writes the compressed storage of \a mat to the binary file \a filename */
+template<typename Scalar, int Options, typename StorageIndex>
+bool binary_save_sparse(const SparseMatrix<Scalar,Options,StorageIndex>& mat, const std::string& filename)
+{
+  typedef SparseMatrix<Scalar,Options,StorageIndex> SparseMatrixType;
+  if(!mat.isCompressed())
+  {
+    SparseMatrixType compressed(mat);
+    compressed.makeCompressed();
+    return binary_save_sparse(compressed, filename);
+  }
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!out)
+    return false;
+  int64_t dims[2] = { mat.rows(), mat.cols() };
+  binary_header header;
+  binary_init_header<Scalar>(header, BinarySparseKind, 2, SparseMatrixType::IsRowMajor, mat.nonZeros(), sizeof(StorageIndex));
+  binary_layout layout = binary_compute_layout(header, dims);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+  binary_write_padding(out, layout.outer);
+  out.write(reinterpret_cast<const char*>(mat.outerIndexPtr()), std::streamsize((mat.outerSize()+1)*sizeof(StorageIndex)));
+  binary_write_padding(out, layout.inner);
+  out.write(reinterpret_cast<const char*>(mat.innerIndexPtr()), std::streamsize(mat.nonZeros()*sizeof(StorageIndex)));
+  binary_write_padding(out, layout.values);
+  out.write(reinterpret_cast<const char*>(mat.valuePtr()), std::streamsize(mat.nonZeros()*sizeof(Scalar)));
+  return bool(out);
+}
+
+/** \internal \returns whether \a header describes a sparse matrix of type \a SparseMatrixType */
+template<typename SparseMatrixType>
+bool binary_holds_sparse(const binary_header& header)
+{
+  return binary_check_header<typename SparseMatrixType::Scalar>(header, BinarySparseKind, 2,
+                                                                 sizeof(typename SparseMatrixType::StorageIndex))
+      && bool(header.flags & RowMajorBit)==bool(SparseMatrixType::IsRowMajor);
+}
+
+/** \internal \returns a map of the sparse matrix stored at \a base */
+template<typename SparseMatrixType>
+Map<SparseMatrixType> binary_map_sparse(char* base, const binary_layout& layout, const int64_t* dims, int64_t nonZeros)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::StorageIndex StorageIndex;
+  return Map<SparseMatrixType>(Index(dims[0]), Index(dims[1]), Index(nonZeros),
+                               reinterpret_cast<StorageIndex*>(base + layout.outer),
+                               reinterpret_cast<StorageIndex*>(base + layout.inner),
+                               reinterpret_cast<Scalar*>(base + layout.values));
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_BINARY_FILE_H
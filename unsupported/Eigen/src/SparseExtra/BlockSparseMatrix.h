@@ -61,6 +61,7 @@ struct traits<BlockSparseMatrix<_Scalar,_BlockAtCompileTime,_Options, _Index> >
 {
   typedef _Scalar Scalar;
   typedef _Index Index;
+  typedef _Index StorageIndex;
   typedef Sparse StorageKind; // FIXME Where is it used ??
   typedef MatrixXpr XprKind;
   enum {
@@ -236,50 +237,6 @@ class BlockVectorReturn
     VectorType& m_vec;
 };
 
-// Block version of the sparse dense product
-template<typename Lhs, typename Rhs>
-class BlockSparseTimeDenseProduct;
-
-namespace internal {
-
-template<typename BlockSparseMatrixT, typename VecType>
-struct traits<BlockSparseTimeDenseProduct<BlockSparseMatrixT, VecType> >
-{
-  typedef Dense StorageKind;
-  typedef MatrixXpr XprKind;
-  typedef typename BlockSparseMatrixT::Scalar Scalar;
-  typedef typename BlockSparseMatrixT::Index Index;
-  enum {
-    RowsAtCompileTime = Dynamic,
-    ColsAtCompileTime = Dynamic,
-    MaxRowsAtCompileTime = Dynamic,
-    MaxColsAtCompileTime = Dynamic,
-    Flags = 0,
-    CoeffReadCost = internal::traits<BlockSparseMatrixT>::CoeffReadCost
-  };
-};
-} // end namespace internal
-
-template<typename Lhs, typename Rhs>
-class BlockSparseTimeDenseProduct
-  : public ProductBase<BlockSparseTimeDenseProduct<Lhs,Rhs>, Lhs, Rhs>
-{
-  public:
-    EIGEN_PRODUCT_PUBLIC_INTERFACE(BlockSparseTimeDenseProduct)
-
-    BlockSparseTimeDenseProduct(const Lhs& lhs, const Rhs& rhs) : Base(lhs,rhs)
-    {}
-
-    template<typename Dest> void scaleAndAddTo(Dest& dest, const typename Rhs::Scalar& alpha) const
-    {
-      BlockVectorReturn<Lhs,Dest> tmpDest(m_lhs, dest);
-      internal::sparse_time_dense_product( BlockSparseMatrixView<Lhs>(m_lhs),  BlockVectorView<Lhs, Rhs>(m_lhs, m_rhs), tmpDest, alpha);
-    }
-
-  private:
-    BlockSparseTimeDenseProduct& operator=(const BlockSparseTimeDenseProduct&);
-};
-
 template<typename _Scalar, int _BlockAtCompileTime, int _Options, typename _StorageIndex>
 class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_BlockAtCompileTime, _Options,_StorageIndex> >
 {
@@ -359,7 +316,7 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
       std::swap(first.m_blockPtr, second.m_blockPtr);
       std::swap(first.m_indices, second.m_indices);
       std::swap(first.m_outerIndex, second.m_outerIndex);
-      std::swap(first.m_BlockSize, second.m_blockSize);
+      std::swap(first.m_blockSize, second.m_blockSize);
     }
 
     BlockSparseMatrix& operator=(BlockSparseMatrix other)
@@ -386,9 +343,15 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
       *
       */
     template<typename MatrixType>
-    inline BlockSparseMatrix(const MatrixType& spmat) : m_blockSize(BlockSize)
+    inline BlockSparseMatrix(const MatrixType& spmat)
+      : m_innerBSize((IsColMajor ? spmat.rows() : spmat.cols()) / BlockSize),
+        m_outerBSize((IsColMajor ? spmat.cols() : spmat.rows()) / BlockSize),
+        m_innerOffset(0),m_outerOffset(0),m_nonzerosblocks(0),
+        m_values(0),m_blockPtr(0),m_indices(0),
+        m_outerIndex(0),m_blockSize(BlockSize)
     {
-      EIGEN_STATIC_ASSERT((m_blockSize != Dynamic), THIS_METHOD_IS_ONLY_FOR_FIXED_SIZE);
+      EIGEN_STATIC_ASSERT((BlockSize != Dynamic), THIS_METHOD_IS_ONLY_FOR_FIXED_SIZE);
+      eigen_assert(spmat.rows()%BlockSize==0 && spmat.cols()%BlockSize==0 && "the sizes must be multiples of the block size");
 
       *this = spmat;
     }
@@ -519,7 +482,7 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
         std::sort(nzBlockIdx.begin(), nzBlockIdx.end());
 
         // Now, fill block indices and (eventually) pointers to blocks
-        for(StorageIndex idx = 0; idx < nzBlockIdx.size(); ++idx)
+        for(StorageIndex idx = 0; idx < StorageIndex(nzBlockIdx.size()); ++idx)
         {
           StorageIndex offset = m_outerIndex[bj]+idx; // offset in m_indices
           m_indices[offset] = nzBlockIdx[idx];
@@ -642,8 +605,8 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
       /* Count the number of rows and column blocks,
        * and the number of nonzero blocks per outer dimension
        */
-      VectorXi rowBlocks(m_innerBSize); // Size of each block row
-      VectorXi colBlocks(m_outerBSize); // Size of each block column
+      VectorXi rowBlocks(blockRows()); // Size of each block row
+      VectorXi colBlocks(blockCols()); // Size of each block column
       rowBlocks.setZero(); colBlocks.setZero();
       VectorXi nzblock_outer(m_outerBSize); // Number of nz blocks per outer vector
       VectorXi nz_outer(m_outerBSize); // Number of nz per outer vector...for variable-size blocks
@@ -849,13 +812,21 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
         eigen_assert("NOT YET SUPPORTED");
     }
 
-    // Block Matrix times vector product
-    template<typename VecType>
-    BlockSparseTimeDenseProduct<BlockSparseMatrix, VecType> operator*(const VecType& lhs) const
+    /** \returns the product of the block matrix by the dense vector or matrix \a x
+      *
+      * Each nonzero block is multiplied by the matching rows of \a x as a small dense matrix, such that the
+      * products with fixed-size blocks are fully unrolled, and only one index is read per block. The block rows of
+      * a row-major matrix are computed in parallel when OpenMP is enabled. */
+    template<typename Rhs>
+    Product<BlockSparseMatrix,Rhs,AliasFreeProduct> operator*(const MatrixBase<Rhs>& x) const
     {
-      return BlockSparseTimeDenseProduct<BlockSparseMatrix, VecType>(*this, lhs);
+      return Product<BlockSparseMatrix,Rhs,AliasFreeProduct>(*this, x.derived());
     }
 
+    /** \internal performs \a dst += \a alpha * \c *this * \a rhs */
+    template<typename Dest, typename Rhs>
+    void scaleAndAddTo(Dest& dst, const Rhs& rhs, const Scalar& alpha) const;
+
     /** \returns the number of nonzero blocks */
     inline Index nonZerosBlocks() const { return m_nonzerosblocks; }
     /** \returns the total number of nonzero elements, including eventual explicit zeros in blocks */
@@ -1074,6 +1045,76 @@ class BlockSparseMatrix<_Scalar, _BlockAtCompileTime, _Options, _StorageIndex>::
     Index m_end; // starting inner index of the next block
 
 };
+
+template<typename _Scalar, int _BlockAtCompileTime, int _Options, typename _StorageIndex>
+template<typename Dest, typename Rhs>
+void BlockSparseMatrix<_Scalar, _BlockAtCompileTime, _Options, _StorageIndex>::scaleAndAddTo(Dest& dst, const Rhs& rhs, const Scalar& alpha) const
+{
+  // the blocks and the matching segments of the vectors have a fixed size when the block size is known at compile time
+  typedef Map<const BlockScalar> BlockMap;
+  typedef Block<const Rhs, BlockSize, Rhs::ColsAtCompileTime> RhsSegment;
+  typedef Block<Dest, BlockSize, Dest::ColsAtCompileTime> DestSegment;
+  const Index outerBlocks = m_outerBSize;
+  if(IsColMajor)
+  {
+    // the products of a block column are scattered to the block rows
+    for(Index bj = 0; bj < outerBlocks; ++bj)
+    {
+      const Index outerSize = blockOuterSize(bj);
+      RhsSegment x(rhs, blockOuterIndex(bj), 0, outerSize, rhs.cols());
+      for(Index k = m_outerIndex[bj]; k < m_outerIndex[bj+1]; ++k)
+      {
+        const Index bi = m_indices[k], innerSize = blockInnerSize(bi);
+        DestSegment y(dst, blockInnerIndex(bi), 0, innerSize, dst.cols());
+        y.noalias() += alpha * BlockMap(m_values + blockPtr(k), innerSize, outerSize).lazyProduct(x);
+      }
+    }
+    return;
+  }
+
+#ifdef EIGEN_HAS_OPENMP
+  Eigen::initParallel();
+  Index threads = Eigen::nbThreads();
+  // this threshold represents the minimal amount of work to be done to be worth it
+  if(m_nonzeros*rhs.cols() < 20000 || omp_get_num_threads()>1)
+    threads = 1;
+  #pragma omp parallel for schedule(dynamic,(std::max)(Index(1),(outerBlocks+threads*4-1)/(threads*4))) num_threads(threads) if(threads>1)
+#endif
+  for(Index bi = 0; bi < outerBlocks; ++bi)
+  {
+    // each block row is accumulated in its own segment of the result
+    const Index outerSize = blockOuterSize(bi);
+    DestSegment y(dst, blockOuterIndex(bi), 0, outerSize, dst.cols());
+    for(Index k = m_outerIndex[bi]; k < m_outerIndex[bi+1]; ++k)
+    {
+      const Index bj = m_indices[k], innerSize = blockInnerSize(bj);
+      RhsSegment x(rhs, blockInnerIndex(bj), 0, innerSize, rhs.cols());
+      y.noalias() += alpha * BlockMap(m_values + blockPtr(k), outerSize, innerSize).lazyProduct(x);
+    }
+  }
+}
+
+namespace internal {
+
+template<typename Scalar, int BlockSize, int Options, typename StorageIndex, typename Rhs, int ProductType>
+struct generic_product_impl<BlockSparseMatrix<Scalar,BlockSize,Options,StorageIndex>, Rhs, SparseShape, DenseShape, ProductType>
+  : generic_product_impl_base<BlockSparseMatrix<Scalar,BlockSize,Options,StorageIndex>, Rhs,
+                              generic_product_impl<BlockSparseMatrix<Scalar,BlockSize,Options,StorageIndex>, Rhs, SparseShape, DenseShape, ProductType> >
+{
+  typedef BlockSparseMatrix<Scalar,BlockSize,Options,StorageIndex> Lhs;
+
+  template<typename Dest>
+  static void scaleAndAddTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Scalar& alpha)
+  {
+    // the segments of the right hand side are read once per nonzero block
+    typedef typename nested_eval<Rhs,Dynamic>::type RhsNested;
+    RhsNested actualRhs(rhs);
+    lhs.scaleAndAddTo(dst, actualRhs, alpha);
+  }
+};
+
+} // end namespace internal
+
 } // end namespace Eigen
 
 #endif // EIGEN_SPARSEBLOCKMATRIX_H
@@ -82,26 +82,195 @@ namespace internal
   }
 
   template<typename Scalar>
-  inline void PutMatrixElt(Scalar value, int row, int col, std::ofstream& out)
+  inline void PutMatrixElt(Scalar value, Index row, Index col, std::ostream& out)
   {
     out << row << " "<< col << " " << value << "\n";
   }
   template<typename Scalar>
-  inline void PutMatrixElt(std::complex<Scalar> value, int row, int col, std::ofstream& out)
+  inline void PutMatrixElt(std::complex<Scalar> value, Index row, Index col, std::ostream& out)
   {
     out << row << " " << col << " " << value.real() << " " << value.imag() << "\n";
   }
 
 
   template<typename Scalar>
-  inline void putVectorElt(Scalar value, std::ofstream& out)
+  inline void putVectorElt(Scalar value, std::ostream& out)
   {
     out << value << "\n"; 
   }
   template<typename Scalar>
-  inline void putVectorElt(std::complex<Scalar> value, std::ofstream& out)
+  inline void putVectorElt(std::complex<Scalar> value, std::ostream& out)
   {
-    out << value.real << " " << value.imag()<< "\n"; 
+    out << value.real() << " " << value.imag()<< "\n"; 
+  }
+
+  inline bool market_is_blank(char c) { return c==' ' || c=='\t' || c=='\r'; }
+
+  inline void market_skip_blanks(const char*& p, const char* end)
+  {
+    while(p<end && market_is_blank(*p))
+      ++p;
+  }
+
+  /** \internal \returns the beginning of the line following the one of \a p */
+  inline const char* market_next_line(const char* p, const char* end)
+  {
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end-p));
+    return eol ? eol+1 : end;
+  }
+
+  /** \internal \returns whether the line beginning at \a p is neither blank nor a comment */
+  inline bool market_is_entry(const char* p, const char* end)
+  {
+    market_skip_blanks(p, end);
+    return p<end && *p!='\n' && *p!='%';
+  }
+
+  inline bool market_parse_index(const char*& p, const char* end, Index& value)
+  {
+    market_skip_blanks(p, end);
+    bool negative = false;
+    if(p<end && (*p=='-' || *p=='+'))
+      negative = *p++=='-';
+    if(p==end || *p<'0' || *p>'9')
+      return false;
+    Index v = 0;
+    while(p<end && *p>='0' && *p<='9')
+      v = 10*v + (*p++ - '0');
+    value = negative ? -v : v;
+    return true;
+  }
+
+  /** \internal Reads the next blank separated token as a RealScalar */
+  template<typename RealScalar>
+  struct market_parse_real
+  {
+    static bool run(const char*& p, const char* end, RealScalar& value)
+    {
+      market_skip_blanks(p, end);
+      const char* start = p;
+      while(p<end && !market_is_blank(*p) && *p!='\n')
+        ++p;
+      std::istringstream token(std::string(start, p));
+      token >> value;
+      return p>start && !token.fail();
+    }
+  };
+
+  // Decimal numbers with at most 15 significant digits and a small exponent are converted exactly
+  // in double precision, the other ones are handed over to strtod.
+  template<>
+  struct market_parse_real<double>
+  {
+    static bool run(const char*& p, const char* end, double& value)
+    {
+      static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+      market_skip_blanks(p, end);
+      const char* start = p;
+      bool negative = false;
+      if(p<end && (*p=='-' || *p=='+'))
+        negative = *p++=='-';
+      double mantissa = 0;
+      int digits = 0, exponent = 0;
+      bool any = false;
+      for(; p<end && *p>='0' && *p<='9'; ++p, any = true)
+        if(digits>0 || *p!='0')
+        {
+          mantissa = 10*mantissa + (*p-'0');
+          ++digits;
+        }
+      if(p<end && *p=='.')
+        for(++p; p<end && *p>='0' && *p<='9'; ++p, any = true)
+        {
+          if(digits>0 || *p!='0')
+          {
+            mantissa = 10*mantissa + (*p-'0');
+            ++digits;
+          }
+          --exponent;
+        }
+      if(any && p<end && (*p=='e' || *p=='E'))
+      {
+        Index e;
+        ++p;
+        if(!market_parse_index(p, end, e) || e<-10000 || e>10000)
+          return parse_slow(start, p, end, value);
+        exponent += int(e);
+      }
+      if(!any || digits>15 || exponent<-22 || exponent>22 || (p<end && !market_is_blank(*p) && *p!='\n'))
+        return parse_slow(start, p, end, value);
+      value = exponent<0 ? mantissa / powers[-exponent] : mantissa * powers[exponent];
+      if(negative)
+        value = -value;
+      return true;
+    }
+
+    static bool parse_slow(const char* start, const char*& p, const char* end, double& value)
+    {
+      p = start;
+      while(p<end && !market_is_blank(*p) && *p!='\n')
+        ++p;
+      std::string token(start, p);
+      char* last;
+      value = std::strtod(token.c_str(), &last);
+      return p>start && last==token.c_str()+token.size();
+    }
+  };
+
+  template<>
+  struct market_parse_real<float>
+  {
+    static bool run(const char*& p, const char* end, float& value)
+    {
+      double v;
+      bool ok = market_parse_real<double>::run(p, end, v);
+      value = float(v);
+      return ok;
+    }
+  };
+
+  template<typename Scalar>
+  inline bool market_parse_value(const char*& p, const char* end, Scalar& value)
+  {
+    return market_parse_real<Scalar>::run(p, end, value);
+  }
+
+  template<typename RealScalar>
+  inline bool market_parse_value(const char*& p, const char* end, std::complex<RealScalar>& value)
+  {
+    RealScalar valR, valI;
+    if(!market_parse_real<RealScalar>::run(p, end, valR) || !market_parse_real<RealScalar>::run(p, end, valI))
+      return false;
+    value = std::complex<RealScalar>(valR, valI);
+    return true;
+  }
+
+  /** \internal Parses the entries of the lines of [\a begin, \a end) into \a elements, and returns the number
+    * of valid entries. */
+  template<typename Scalar, typename StorageIndex>
+  Index market_parse_entries(const char* begin, const char* end, Index M, Index N, Triplet<Scalar,StorageIndex>* elements)
+  {
+    Index count = 0;
+    for(const char* line = begin; line<end; line = market_next_line(line, end))
+    {
+      if(!market_is_entry(line, end))
+        continue;
+      const char* p = line;
+      Index i(-1), j(-1);
+      Scalar value;
+      bool ok = market_parse_index(p, end, i) && market_parse_index(p, end, j) && market_parse_value(p, end, value);
+      if(ok && i>0 && j>0 && i<=M && j<=N)
+        elements[count++] = Triplet<Scalar,StorageIndex>(StorageIndex(i-1), StorageIndex(j-1), value);
+      else
+      {
+#ifdef EIGEN_HAS_OPENMP
+        #pragma omp critical
+#endif
+        std::cerr << "Invalid read: " << i-1 << "," << j-1 << "\n";
+      }
+    }
+    return count;
   }
 
 } // end namepsace internal
@@ -129,63 +298,89 @@ inline bool getMarketHeader(const std::string& filename, int& sym, bool& iscompl
   return true;
 }
   
+/** \brief Reads the sparse matrix \a mat from the Matrix Market file \a filename
+  *
+  * The file is memory mapped and split into chunks of lines which are parsed in parallel when OpenMP is enabled,
+  * the entries being then assembled by SparseMatrix::setFromTriplets().
+  *
+  * \sa saveMarket(), loadMarketBinary()
+  */
 template<typename SparseMatrixType>
 bool loadMarket(SparseMatrixType& mat, const std::string& filename)
 {
   typedef typename SparseMatrixType::Scalar Scalar;
-  typedef typename SparseMatrixType::Index Index;
-  std::ifstream input(filename.c_str(),std::ios::in);
-  if(!input)
+  typedef typename SparseMatrixType::StorageIndex StorageIndex;
+  typedef Triplet<Scalar,StorageIndex> T;
+
+  internal::mapped_file file;
+  if(!file.open(filename))
     return false;
-  
-  const int maxBuffersize = 2048;
-  char buffer[maxBuffersize];
-  
-  bool readsizes = false;
+  const char* p = file.data();
+  const char* end = p + file.size();
 
-  typedef Triplet<Scalar,Index> T;
-  std::vector<T> elements;
-  
+  // skip the header and the comments up to the sizes
   Index M(-1), N(-1), NNZ(-1);
-  Index count = 0;
-  while(input.getline(buffer, maxBuffersize))
+  for(; p<end; p = internal::market_next_line(p, end))
   {
-    // skip comments   
-    //NOTE An appropriate test should be done on the header to get the  symmetry
-    if(buffer[0]=='%')
+    if(!internal::market_is_entry(p, end))
       continue;
-    
-    std::stringstream line(buffer);
-    
-    if(!readsizes)
+    const char* q = p;
+    if(internal::market_parse_index(q, end, M) && internal::market_parse_index(q, end, N) && internal::market_parse_index(q, end, NNZ)
+       && M > 0 && N > 0 && NNZ >= 0)
     {
-      line >> M >> N >> NNZ;
-      if(M > 0 && N > 0 && NNZ > 0) 
-      {
-        readsizes = true;
-        //std::cout << "sizes: " << M << "," << N << "," << NNZ << "\n";
-        mat.resize(M,N);
-        mat.reserve(NNZ);
-      }
-    }
-    else
-    { 
-      Index i(-1), j(-1);
-      Scalar value; 
-      if( internal::GetMarketLine(line, M, N, i, j, value) ) 
-      {
-        ++ count;
-        elements.push_back(T(i,j,value));
-      }
-      else 
-        std::cerr << "Invalid read: " << i << "," << j << "\n";        
+      p = internal::market_next_line(p, end);
+      break;
     }
   }
+  if(M<=0 || N<=0 || NNZ<0)
+    return false;
+  mat.resize(M,N);
+
+  // split the entries into chunks of whole lines
+  Index chunks = 1;
+#ifdef EIGEN_HAS_OPENMP
+  if(end-p > (1<<20) && omp_get_num_threads()==1)
+    chunks = Eigen::nbThreads();
+#endif
+  std::vector<const char*> bounds(chunks+1);
+  bounds[0] = p;
+  bounds[chunks] = end;
+  for(Index c=1; c<chunks; ++c)
+    bounds[c] = (std::max)(bounds[c-1], internal::market_next_line(p + (end-p)/chunks*c - 1, end));
+
+  // pass 1: count the entries of each chunk
+  std::vector<Index> counts(chunks+1, 0);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(static,1) num_threads(chunks) if(chunks>1)
+#endif
+  for(Index c=0; c<chunks; ++c)
+    for(const char* line = bounds[c]; line<bounds[c+1]; line = internal::market_next_line(line, bounds[c+1]))
+      if(internal::market_is_entry(line, bounds[c+1]))
+        ++counts[c+1];
+  for(Index c=0; c<chunks; ++c)
+    counts[c+1] += counts[c];
+
+  // pass 2: parse the entries in place, and remove the invalid ones
+  std::vector<T> elements(counts[chunks]);
+  std::vector<Index> valid(chunks);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(static,1) num_threads(chunks) if(chunks>1)
+#endif
+  for(Index c=0; c<chunks; ++c)
+    if(counts[c+1]>counts[c])
+      valid[c] = internal::market_parse_entries(bounds[c], bounds[c+1], M, N, &elements[counts[c]]);
+  Index count = 0;
+  for(Index c=0; c<chunks; ++c)
+  {
+    if(count!=counts[c])
+      std::copy(elements.begin()+counts[c], elements.begin()+counts[c]+valid[c], elements.begin()+count);
+    count += valid[c];
+  }
+  elements.resize(count);
+
   mat.setFromTriplets(elements.begin(), elements.end());
   if(count!=NNZ)
     std::cerr << count << "!=" << NNZ << "\n";
-  
-  input.close();
   return true;
 }
 
@@ -221,32 +416,156 @@ bool loadMarketVector(VectorType& vec, const std::string& filename)
   return true;
 }
 
+/** \brief Writes the sparse matrix \a mat to the Matrix Market file \a filename
+  *
+  * The values are written with enough digits to be read back exactly. When OpenMP is enabled, blocks
+  * of entries are formatted in parallel before being written in order.
+  *
+  * \sa loadMarket(), saveMarketBinary()
+  */
 template<typename SparseMatrixType>
 bool saveMarket(const SparseMatrixType& mat, const std::string& filename, int sym = 0)
 {
   typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
   std::ofstream out(filename.c_str(),std::ios::out);
   if(!out)
     return false;
   
-  out.flags(std::ios_base::scientific);
-  out.precision(64);
   std::string header; 
   internal::putMarketHeader<Scalar>(header, sym); 
   out << header << std::endl; 
   out << mat.rows() << " " << mat.cols() << " " << mat.nonZeros() << "\n";
-  int count = 0;
-  for(int j=0; j<mat.outerSize(); ++j)
-    for(typename SparseMatrixType::InnerIterator it(mat,j); it; ++it)
+
+  // format blocks of about 2^16 entries, a round of blocks at a time
+  const Index outerSize = mat.outerSize();
+  const Index blockSize = numext::maxi<Index>(1, outerSize * (Index(1)<<16) / numext::maxi<Index>(1, mat.nonZeros()));
+  Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  if(outerSize > blockSize && omp_get_num_threads()==1)
+    threads = Eigen::nbThreads();
+#endif
+  std::vector<std::string> blocks(threads);
+  for(Index round=0; round<outerSize; round+=threads*blockSize)
+  {
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for schedule(static,1) num_threads(threads) if(threads>1)
+#endif
+    for(Index b=0; b<threads; ++b)
     {
-      ++ count;
-      internal::PutMatrixElt(it.value(), it.row()+1, it.col()+1, out);
-      // out << it.row()+1 << " " << it.col()+1 << " " << it.value() << "\n";
+      std::ostringstream block;
+      block.flags(std::ios_base::scientific);
+      block.precision(NumTraits<RealScalar>::digits10()+2);
+      for(Index j=round+b*blockSize; j<numext::mini(round+(b+1)*blockSize, outerSize); ++j)
+        for(typename SparseMatrixType::InnerIterator it(mat,j); it; ++it)
+          internal::PutMatrixElt(it.value(), it.row()+1, it.col()+1, block);
+      blocks[b] = block.str();
     }
+    for(Index b=0; b<threads; ++b)
+      out << blocks[b];
+  }
   out.close();
   return true;
 }
 
+/** \brief Writes the compressed storage of \a mat to the binary file \a filename
+  *
+  * The file, typically stored next to the corresponding Matrix Market file, made of a header followed by the
+  * raw outer index, inner index and value arrays, can be read back by loadMarketBinary() or memory mapped
+  * without any copy by class MappedMarketBinary. It uses the native binary representation of the numbers,
+  * and thus is not meant to be exchanged between different architectures.
+  *
+  * This is the sparse matrix format of the CXX11 Serialization module: the file can as well be read by its
+  * loadBinary() and MappedBinaryFile.
+  *
+  * \sa loadMarketBinary(), class MappedMarketBinary, saveMarket()
+  */
+template<typename Scalar, int Options, typename StorageIndex>
+bool saveMarketBinary(const SparseMatrix<Scalar,Options,StorageIndex>& mat, const std::string& filename)
+{
+  return internal::binary_save_sparse(mat, filename);
+}
+
+/** \brief Memory mapped view of a binary sidecar file written by saveMarketBinary()
+  *
+  * \tparam SparseMatrixType the type of the SparseMatrix stored in the file
+  *
+  * The matrix is directly mapped from the file, without any copy nor parsing:
+  * \code
+  * MappedMarketBinary<SparseMatrix<double> > file;
+  * if(file.open("matrix.mtx.bin"))
+  * {
+  *   Map<SparseMatrix<double> > A = file.matrix();
+  *   x = A * y;
+  * }
+  * \endcode
+  * The mapping is private, modifying the coefficients of matrix() does not alter the file.
+  * The map is valid until the file is closed or this object is destroyed.
+  *
+  * \sa saveMarketBinary(), loadMarketBinary()
+  */
+template<typename SparseMatrixType>
+class MappedMarketBinary
+{
+  public:
+    typedef typename SparseMatrixType::Scalar Scalar;
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+
+    MappedMarketBinary() : m_isOpen(false) {}
+
+    /** Maps the file \a filename, and \returns false if it cannot be read or if it does not hold a SparseMatrixType */
+    bool open(const std::string& filename)
+    {
+      close();
+      if(!m_file.open(filename))
+        return false;
+      if(!internal::binary_read_header(m_file, m_header, m_dims, m_layout)
+         || !internal::binary_holds_sparse<SparseMatrixType>(m_header))
+      {
+        m_file.close();
+        return false;
+      }
+      m_isOpen = true;
+      return true;
+    }
+
+    /** Unmaps the file */
+    void close()
+    {
+      m_file.close();
+      m_isOpen = false;
+    }
+
+    bool isOpen() const { return m_isOpen; }
+
+    /** \returns the matrix stored in the file */
+    Map<SparseMatrixType> matrix() const
+    {
+      eigen_assert(m_isOpen && "MappedMarketBinary is not open.");
+      return internal::binary_map_sparse<SparseMatrixType>(m_file.data(), m_layout, &m_dims[0], m_header.nonZeros);
+    }
+
+  protected:
+    internal::mapped_file m_file;
+    internal::binary_header m_header;
+    internal::binary_layout m_layout;
+    std::vector<int64_t> m_dims;
+    bool m_isOpen;
+};
+
+/** \brief Reads the sparse matrix \a mat from the binary sidecar file \a filename written by saveMarketBinary()
+  * \returns false if the file cannot be read or does not hold a sparse matrix of the same type as \a mat
+  * \sa saveMarketBinary(), class MappedMarketBinary */
+template<typename SparseMatrixType>
+bool loadMarketBinary(SparseMatrixType& mat, const std::string& filename)
+{
+  MappedMarketBinary<SparseMatrixType> file;
+  if(!file.open(filename))
+    return false;
+  mat = file.matrix();
+  return true;
+}
+
 template<typename VectorType>
 bool saveMarketVector (const VectorType& vec, const std::string& filename)
 {
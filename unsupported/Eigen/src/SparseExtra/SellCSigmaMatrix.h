@@ -0,0 +1,354 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SELL_C_SIGMA_MATRIX_H
+#define EIGEN_SELL_C_SIGMA_MATRIX_H
+
+namespace Eigen {
+
+template<typename _Scalar, int _SliceHeight = 8, typename _StorageIndex = int> class SellCSigmaMatrix;
+
+namespace internal {
+
+// SellCSigmaMatrix behaves as a read-only row-major SparseMatrix in expressions
+template<typename _Scalar, int _SliceHeight, typename _StorageIndex>
+struct traits<SellCSigmaMatrix<_Scalar,_SliceHeight,_StorageIndex> >
+  : public traits<SparseMatrix<_Scalar,RowMajor,_StorageIndex> >
+{};
+
+/** \internal Computes the products of the rows of a slice with \a x into \a res */
+template<typename Scalar, int SliceHeight, typename StorageIndex,
+         bool Vectorize = packet_traits<Scalar>::Vectorizable && (int(packet_traits<Scalar>::size)>1)
+                          && (int(SliceHeight) % int(packet_traits<Scalar>::size))==0>
+struct sell_c_sigma_slice_product
+{
+  static void run(const Scalar* values, const StorageIndex* indices, Index width, const Scalar* x, Scalar* res)
+  {
+    for(Index l = 0; l < SliceHeight; ++l)
+      res[l] = Scalar(0);
+    for(Index k = 0; k < width; ++k, values += SliceHeight, indices += SliceHeight)
+      for(Index l = 0; l < SliceHeight; ++l)
+        res[l] += values[l] * x[indices[l]];
+  }
+};
+
+template<typename Scalar, int SliceHeight, typename StorageIndex>
+struct sell_c_sigma_slice_product<Scalar,SliceHeight,StorageIndex,true>
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum { PacketSize = packet_traits<Scalar>::size, Packets = int(SliceHeight) / int(PacketSize) };
+
+  static void run(const Scalar* values, const StorageIndex* indices, Index width, const Scalar* x, Scalar* res)
+  {
+    Packet acc[Packets];
+    for(Index p = 0; p < Packets; ++p)
+      acc[p] = pset1<Packet>(Scalar(0));
+    for(Index k = 0; k < width; ++k, values += SliceHeight, indices += SliceHeight)
+    {
+      for(Index p = 0; p < Packets; ++p)
+      {
+        // gather the coefficients of x of a packet of rows, the values of the slice are contiguous and aligned
+        EIGEN_ALIGN_MAX Scalar gathered[PacketSize];
+        for(Index l = 0; l < PacketSize; ++l)
+          gathered[l] = x[indices[p*PacketSize+l]];
+        acc[p] = pmadd(pload<Packet>(values + p*PacketSize), pload<Packet>(gathered), acc[p]);
+      }
+    }
+    for(Index p = 0; p < Packets; ++p)
+      pstoreu(res + p*PacketSize, acc[p]);
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup SparseExtra_Module
+  *
+  * \class SellCSigmaMatrix
+  *
+  * \brief A read-only sparse matrix in the SELL-C-\f$ \sigma \f$ format, for fast matrix-vector products
+  *
+  * \tparam _Scalar the scalar type, i.e. the type of the coefficients
+  * \tparam _SliceHeight the number C of rows per slice, preferably a multiple of the SIMD packet size
+  * \tparam _StorageIndex the type of the column indices
+  *
+  * In the sliced ELLPACK format, the rows are grouped into slices of C consecutive rows, each slice being stored
+  * column by column as a dense C x w block, w being the length of the longest row of the slice, the shorter rows
+  * being padded by zeros. The products of a slice are thus computed on whole SIMD packets of rows, with contiguous
+  * loads of the coefficients and gathers of the coefficients of the right hand side only.
+  *
+  * To reduce the padding, the rows are sorted by decreasing length within windows of \f$ \sigma \f$ consecutive rows,
+  * and the products are written back to the original rows. A sorting scope \f$ \sigma \f$ of a few tens of slices is
+  * usually enough to get rid of most of the padding while keeping the accesses to the right hand side local.
+  *
+  * The matrix is built from any sparse matrix expression, and supports the products with dense vectors and matrices,
+  * computed in parallel over the slices when OpenMP is enabled. It can directly be used as the matrix of the iterative
+  * solvers, as for instance:
+  * \code
+  * SellCSigmaMatrix<double> A(S);   // S is a SparseMatrix<double>
+  * y = A * x;
+  * ConjugateGradient<SellCSigmaMatrix<double>, Lower|Upper> cg(A);
+  * x = cg.solve(b);
+  * \endcode
+  *
+  * \sa class SparseMatrix
+  */
+template<typename _Scalar, int _SliceHeight, typename _StorageIndex>
+class SellCSigmaMatrix : public EigenBase<SellCSigmaMatrix<_Scalar,_SliceHeight,_StorageIndex> >
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef _StorageIndex StorageIndex;
+    enum {
+      SliceHeight = _SliceHeight,
+      ColsAtCompileTime = Dynamic,
+      MaxColsAtCompileTime = Dynamic,
+      IsRowMajor = true
+    };
+
+    class InnerIterator;
+
+    SellCSigmaMatrix() : m_rows(0), m_cols(0), m_nonZeros(0)
+    {
+      check_template_parameters();
+      m_sliceStart.setZero(1);
+    }
+
+    /** Builds the SELL-C-\f$ \sigma \f$ representation of \a mat with the sorting scope \a sigma */
+    template<typename Derived>
+    explicit SellCSigmaMatrix(const SparseMatrixBase<Derived>& mat, Index sigma = 32*SliceHeight)
+      : m_rows(0), m_cols(0), m_nonZeros(0)
+    {
+      check_template_parameters();
+      compute(mat, sigma);
+    }
+
+    /** Builds the SELL-C-\f$ \sigma \f$ representation of \a mat, sorting the rows by decreasing lengths within
+      * windows of \a sigma rows. A scope of 1 keeps the original order of the rows. */
+    template<typename Derived>
+    SellCSigmaMatrix& compute(const SparseMatrixBase<Derived>& mat, Index sigma = 32*SliceHeight);
+
+    inline Index rows() const { return m_rows; }
+    inline Index cols() const { return m_cols; }
+    inline Index outerSize() const { return m_rows; }
+    inline Index innerSize() const { return m_cols; }
+
+    /** \returns the number of stored non zeros, not counting the padding */
+    inline Index nonZeros() const { return m_nonZeros; }
+
+    /** \returns the number of stored coefficients, including the padding */
+    inline Index storedCoefficients() const { return m_values.size(); }
+
+    /** \returns the number of slices */
+    inline Index slices() const { return m_sliceStart.size()-1; }
+
+    /** \returns a SparseMatrix copy of \c *this */
+    SparseMatrix<Scalar,RowMajor,StorageIndex> toSparse() const
+    {
+      SparseMatrix<Scalar,RowMajor,StorageIndex> res(m_rows, m_cols);
+      res.reserve(m_nonZeros);
+      for(Index i = 0; i < m_rows; ++i)
+      {
+        res.startVec(i);
+        for(InnerIterator it(*this, i); it; ++it)
+          res.insertBackByOuterInner(i, it.index()) = it.value();
+      }
+      res.finalize();
+      return res;
+    }
+
+    template<typename Rhs>
+    Product<SellCSigmaMatrix,Rhs,AliasFreeProduct> operator*(const MatrixBase<Rhs>& x) const
+    {
+      return Product<SellCSigmaMatrix,Rhs,AliasFreeProduct>(*this, x.derived());
+    }
+
+    /** \internal performs \a dst += \a alpha * \c *this * \a x for a vector \a x with unit inner stride */
+    template<typename Dest>
+    void scaleAndAddTo(Dest& dst, const Scalar* x, const Scalar& alpha) const;
+
+  protected:
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT(NumTraits<StorageIndex>::IsSigned,THE_INDEX_TYPE_MUST_BE_A_SIGNED_TYPE);
+      EIGEN_STATIC_ASSERT(SliceHeight>0,INVALID_MATRIX_TEMPLATE_PARAMETERS);
+    }
+
+    typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+
+    Index m_rows, m_cols, m_nonZeros;
+    Matrix<Index,Dynamic,1> m_sliceStart; // the coefficients of the s-th slice start at m_sliceStart[s]
+    Matrix<Scalar,Dynamic,1> m_values;    // the k-th coefficient of the l-th row of a slice is at l + k*SliceHeight
+    IndexVector m_indices;                // the column indices, the padding coefficients referring to a valid column
+    IndexVector m_rowLength;              // the lengths of the sorted rows
+    IndexVector m_perm;                   // the original index of the sorted rows
+    IndexVector m_sortedRow;              // the sorted index of the original rows
+};
+
+/** \ingroup SparseExtra_Module
+  * \brief Iterator over the non zeros of a row of a SellCSigmaMatrix */
+template<typename Scalar, int SliceHeight, typename StorageIndex>
+class SellCSigmaMatrix<Scalar,SliceHeight,StorageIndex>::InnerIterator
+{
+  public:
+    InnerIterator(const SellCSigmaMatrix& mat, Index outer)
+      : m_outer(outer)
+    {
+      Index r = mat.m_sortedRow.coeff(outer);
+      Index start = mat.m_sliceStart.coeff(r / SliceHeight) + r % SliceHeight;
+      m_values = mat.m_values.data() + start;
+      m_indices = mat.m_indices.data() + start;
+      m_end = mat.m_rowLength.coeff(r);
+      m_id = 0;
+    }
+
+    inline InnerIterator& operator++() { ++m_id; return *this; }
+
+    inline const Scalar& value() const { return m_values[m_id*SliceHeight]; }
+    inline StorageIndex index() const { return m_indices[m_id*SliceHeight]; }
+    inline Index outer() const { return m_outer; }
+    inline Index row() const { return m_outer; }
+    inline Index col() const { return index(); }
+
+    inline operator bool() const { return m_id < m_end; }
+
+  protected:
+    const Scalar* m_values;
+    const StorageIndex* m_indices;
+    Index m_outer, m_id, m_end;
+};
+
+template<typename Scalar, int SliceHeight, typename StorageIndex>
+template<typename Derived>
+SellCSigmaMatrix<Scalar,SliceHeight,StorageIndex>&
+SellCSigmaMatrix<Scalar,SliceHeight,StorageIndex>::compute(const SparseMatrixBase<Derived>& mat, Index sigma)
+{
+  eigen_assert(sigma>0);
+  const SparseMatrix<Scalar,RowMajor,StorageIndex> tmp(mat);
+  const StorageIndex* outerIndex = tmp.outerIndexPtr();
+  m_rows = tmp.rows();
+  m_cols = tmp.cols();
+  m_nonZeros = tmp.nonZeros();
+  const Index slices = (m_rows + SliceHeight - 1) / SliceHeight;
+
+  // sort the rows by decreasing length within windows of sigma rows
+  m_rowLength.resize(slices*SliceHeight);
+  m_perm.resize(slices*SliceHeight);
+  m_sortedRow.resize(m_rows);
+  for(Index i = 0; i < m_rows; ++i)
+    m_perm.coeffRef(i) = StorageIndex(i);
+  for(Index w = 0; w < m_rows; w += sigma)
+  {
+    std::vector<std::pair<StorageIndex,StorageIndex> > window;
+    for(Index i = w; i < (std::min)(w+sigma, m_rows); ++i)
+      window.push_back(std::make_pair(StorageIndex(-(outerIndex[i+1]-outerIndex[i])), StorageIndex(i)));
+    std::sort(window.begin(), window.end());
+    for(std::size_t k = 0; k < window.size(); ++k)
+      m_perm.coeffRef(w+k) = window[k].second;
+  }
+  for(Index r = 0; r < slices*SliceHeight; ++r)
+  {
+    if(r < m_rows)
+    {
+      m_sortedRow.coeffRef(m_perm.coeff(r)) = StorageIndex(r);
+      m_rowLength.coeffRef(r) = outerIndex[m_perm.coeff(r)+1] - outerIndex[m_perm.coeff(r)];
+    }
+    else
+    {
+      // padding rows
+      m_perm.coeffRef(r) = 0;
+      m_rowLength.coeffRef(r) = 0;
+    }
+  }
+
+  // the width of each slice is the length of its longest row
+  m_sliceStart.resize(slices+1);
+  m_sliceStart.coeffRef(0) = 0;
+  for(Index s = 0; s < slices; ++s)
+    m_sliceStart.coeffRef(s+1) = m_sliceStart.coeff(s)
+                               + SliceHeight * Index(m_rowLength.segment(s*SliceHeight, SliceHeight).maxCoeff());
+
+  m_values.resize(m_sliceStart.coeff(slices));
+  m_indices.resize(m_sliceStart.coeff(slices));
+  for(Index s = 0; s < slices; ++s)
+  {
+    const Index width = (m_sliceStart.coeff(s+1) - m_sliceStart.coeff(s)) / SliceHeight;
+    for(Index l = 0; l < SliceHeight; ++l)
+    {
+      const Index r = s*SliceHeight + l;
+      const Index len = m_rowLength.coeff(r);
+      const Index start = r < m_rows ? outerIndex[m_perm.coeff(r)] : 0;
+      for(Index k = 0; k < width; ++k)
+      {
+        const Index p = m_sliceStart.coeff(s) + k*SliceHeight + l;
+        if(k < len)
+        {
+          m_values.coeffRef(p) = tmp.valuePtr()[start+k];
+          m_indices.coeffRef(p) = tmp.innerIndexPtr()[start+k];
+        }
+        else
+        {
+          m_values.coeffRef(p) = Scalar(0);
+          m_indices.coeffRef(p) = len > 0 ? tmp.innerIndexPtr()[start+len-1] : 0;
+        }
+      }
+    }
+  }
+  return *this;
+}
+
+template<typename Scalar, int SliceHeight, typename StorageIndex>
+template<typename Dest>
+void SellCSigmaMatrix<Scalar,SliceHeight,StorageIndex>::scaleAndAddTo(Dest& dst, const Scalar* x, const Scalar& alpha) const
+{
+  const Index slices = this->slices();
+#ifdef EIGEN_HAS_OPENMP
+  Eigen::initParallel();
+  Index threads = Eigen::nbThreads();
+  // this threshold represents the minimal amount of work to be done to be worth it
+  if(m_values.size() < 20000 || omp_get_num_threads()>1)
+    threads = 1;
+  #pragma omp parallel for schedule(dynamic,(std::max)(Index(1),(slices+threads*4-1)/(threads*4))) num_threads(threads) if(threads>1)
+#endif
+  for(Index s = 0; s < slices; ++s)
+  {
+    Scalar res[SliceHeight];
+    const Index start = m_sliceStart.coeff(s);
+    internal::sell_c_sigma_slice_product<Scalar,SliceHeight,StorageIndex>::run(m_values.data() + start, m_indices.data() + start,
+                                                                              (m_sliceStart.coeff(s+1) - start) / SliceHeight, x, res);
+    for(Index l = 0; l < SliceHeight && s*SliceHeight + l < m_rows; ++l)
+      dst.coeffRef(m_perm.coeff(s*SliceHeight + l)) += alpha * res[l];
+  }
+}
+
+namespace internal {
+
+template<typename Scalar, int SliceHeight, typename StorageIndex, typename Rhs, int ProductType>
+struct generic_product_impl<SellCSigmaMatrix<Scalar,SliceHeight,StorageIndex>, Rhs, SparseShape, DenseShape, ProductType>
+  : generic_product_impl_base<SellCSigmaMatrix<Scalar,SliceHeight,StorageIndex>, Rhs,
+                              generic_product_impl<SellCSigmaMatrix<Scalar,SliceHeight,StorageIndex>, Rhs, SparseShape, DenseShape, ProductType> >
+{
+  typedef SellCSigmaMatrix<Scalar,SliceHeight,StorageIndex> Lhs;
+
+  template<typename Dest>
+  static void scaleAndAddTo(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Scalar& alpha)
+  {
+    for(Index j = 0; j < rhs.cols(); ++j)
+    {
+      // the gathers need a contiguous right hand side
+      Ref<const Matrix<Scalar,Dynamic,1> > x(rhs.col(j));
+      typename Dest::ColXpr y(dst.col(j));
+      lhs.scaleAndAddTo(y, x.data(), alpha);
+    }
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SELL_C_SIGMA_MATRIX_H
@@ -225,6 +225,62 @@ void test_return_by_value(int len)
     VERIFY( (in1-in).norm() < test_precision<float>() );
 }
 
+template <typename T>
+void test_batch(int nfft,int howmany)
+{
+    typedef typename FFT<T>::Complex Complex;
+    typedef Matrix<Complex,Dynamic,Dynamic> MatrixC;
+    typedef Matrix<T,Dynamic,Dynamic> MatrixR;
+    typedef Matrix<Complex,Dynamic,1> VectorC;
+    typedef Matrix<T,Dynamic,1> VectorR;
+    FFT<T> fft;
+
+    // complex columns
+    MatrixC src = MatrixC::Random(nfft,howmany), dst, back;
+    fft.fwdBatch(dst,src);
+    fft.invBatch(back,dst);
+    for (int k=0;k<howmany;++k) {
+        VectorC ref;
+        fft.fwd(ref,VectorC(src.col(k)));
+        VERIFY( (dst.col(k)-ref).norm() <= test_precision<T>()*ref.norm() );
+    }
+    VERIFY( (back-src).norm() <= test_precision<T>()*src.norm() );
+
+    // complex rows, strided transforms
+    MatrixC srcT = src.transpose(), dstT(howmany,nfft);
+    fft.fwdBatch(dstT.transpose(),srcT.transpose());
+    VERIFY( (dstT.transpose()-dst).norm() <= test_precision<T>()*dst.norm() );
+
+    // every other column of a Map with a Stride
+    Map<MatrixC,0,OuterStride<> > cols(src.data(),nfft,howmany/2,OuterStride<>(2*nfft));
+    MatrixC dst2;
+    fft.fwdBatch(dst2,cols);
+    for (int k=0;k<howmany/2;++k)
+        VERIFY( (dst2.col(k)-dst.col(2*k)).norm() <= test_precision<T>()*dst.norm() );
+
+    // real rows, full and half spectrums
+    MatrixR rsrc = MatrixR::Random(howmany,nfft), rback;
+    MatrixC rdst;
+    fft.fwdBatch(rdst,rsrc.transpose());
+    for (int k=0;k<howmany;++k) {
+        VectorC ref;
+        fft.fwd(ref,VectorR(rsrc.row(k).transpose()));
+        VERIFY( (rdst.col(k)-ref).norm() <= test_precision<T>()*ref.norm() );
+    }
+    fft.invBatch(rback,rdst);
+    VERIFY( (rback.transpose()-rsrc).norm() <= test_precision<T>()*rsrc.norm() );
+
+    fft.SetFlag(fft.HalfSpectrum);
+    MatrixC hdst;
+    fft.fwdBatch(hdst,rsrc.transpose());
+    VERIFY_IS_EQUAL( hdst.rows(), nfft/2+1 );
+    VERIFY( (hdst-rdst.topRows(nfft/2+1)).norm() <= test_precision<T>()*rdst.norm() );
+    if (nfft%2==0) {
+        fft.invBatch(rback,hdst);
+        VERIFY( (rback.transpose()-rsrc).norm() <= test_precision<T>()*rsrc.norm() );
+    }
+}
+
 void test_FFTW()
 {
   CALL_SUBTEST( test_return_by_value(32) );
@@ -237,12 +293,26 @@ void test_FFTW()
   CALL_SUBTEST( test_complex<float>(2*3*4) ); CALL_SUBTEST( test_complex<double>(2*3*4) ); 
   CALL_SUBTEST( test_complex<float>(2*3*4*5) ); CALL_SUBTEST( test_complex<double>(2*3*4*5) ); 
   CALL_SUBTEST( test_complex<float>(2*3*4*5*7) ); CALL_SUBTEST( test_complex<double>(2*3*4*5*7) ); 
+  CALL_SUBTEST( test_complex<float>(3*3*3*3*3) ); CALL_SUBTEST( test_complex<double>(3*3*3*3*3) ); 
+  CALL_SUBTEST( test_complex<float>(5*5*5*5) ); CALL_SUBTEST( test_complex<double>(5*5*5*5) ); 
 
   CALL_SUBTEST( test_scalar<float>(32) ); CALL_SUBTEST( test_scalar<double>(32) ); 
   CALL_SUBTEST( test_scalar<float>(45) ); CALL_SUBTEST( test_scalar<double>(45) ); 
   CALL_SUBTEST( test_scalar<float>(50) ); CALL_SUBTEST( test_scalar<double>(50) ); 
   CALL_SUBTEST( test_scalar<float>(256) ); CALL_SUBTEST( test_scalar<double>(256) ); 
   CALL_SUBTEST( test_scalar<float>(2*3*4*5*7) ); CALL_SUBTEST( test_scalar<double>(2*3*4*5*7) ); 
+  CALL_SUBTEST( test_scalar<float>(2) ); CALL_SUBTEST( test_scalar<double>(2) ); 
+  CALL_SUBTEST( test_scalar<float>(2*3*3*3*3*3) ); CALL_SUBTEST( test_scalar<double>(2*3*3*3*3*3) ); 
+
+  CALL_SUBTEST( test_batch<float>(64,50) ); CALL_SUBTEST( test_batch<double>(64,50) ); 
+  CALL_SUBTEST( test_batch<float>(90,300) ); CALL_SUBTEST( test_batch<double>(45,300) ); 
+
+  // large enough batches to be split across the threads, with several threads even on a single core
+  int nb_threads = Eigen::nbThreads();
+  Eigen::setNbThreads((std::max)(nb_threads,4));
+  CALL_SUBTEST( test_batch<float>(90,300) ); CALL_SUBTEST( test_batch<double>(45,500) );
+  CALL_SUBTEST( test_batch<float>(256,100) );
+  Eigen::setNbThreads(nb_threads);
   
   #ifdef EIGEN_HAS_FFTWL
   CALL_SUBTEST( test_complex<long double>(32) );
@@ -0,0 +1,203 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_USE_THREADS
+
+#include "main.h"
+#include <Eigen/Cholesky>
+#include <Eigen/LU>
+#include <unsupported/Eigen/CXX11/BatchedLinearAlgebra>
+
+using Eigen::Tensor;
+using Eigen::TensorMap;
+
+template<typename Scalar, int Rows, int Cols>
+Matrix<Scalar,Rows,Cols> batch_item(const Tensor<Scalar,3>& t, Index k)
+{
+  Matrix<Scalar,Rows,Cols> m;
+  for(Index j = 0; j < Cols; ++j)
+    for(Index i = 0; i < Rows; ++i)
+      m(i,j) = t(k,i,j);
+  return m;
+}
+
+template<typename Scalar, int Rows, int Cols>
+void set_batch_item(Tensor<Scalar,3>& t, Index k, const Matrix<Scalar,Rows,Cols>& m)
+{
+  for(Index j = 0; j < Cols; ++j)
+    for(Index i = 0; i < Rows; ++i)
+      t(k,i,j) = m(i,j);
+}
+
+template<typename Scalar, int Rows, int Depth, int Cols, typename Device>
+void test_batched_product(const Device& device)
+{
+  const Index batch = internal::random<Index>(1, 200);
+  Tensor<Scalar,3> lhs(batch, Rows, Depth), rhs(batch, Depth, Cols), dst(batch, Rows, Cols);
+  lhs.setRandom();
+  rhs.setRandom();
+
+  batchedProduct<Rows,Depth,Cols>(device, lhs, rhs, dst);
+  for(Index k = 0; k < batch; ++k)
+  {
+    Matrix<Scalar,Rows,Cols> ref = batch_item<Scalar,Rows,Depth>(lhs,k) * batch_item<Scalar,Depth,Cols>(rhs,k);
+    VERIFY_IS_APPROX((batch_item<Scalar,Rows,Cols>(dst,k)), ref);
+  }
+}
+
+template<typename Scalar, int Size, typename Device>
+void test_batched_inverse(const Device& device)
+{
+  typedef Matrix<Scalar,Size,Size> MatrixType;
+  const Index batch = internal::random<Index>(1, 200);
+  Tensor<Scalar,3> src(batch, Size, Size), dst(batch, Size, Size);
+  for(Index k = 0; k < batch; ++k)
+  {
+    // keep the matrices well conditioned
+    MatrixType m = MatrixType::Random();
+    m.diagonal().array() += Scalar(Size);
+    set_batch_item(src, k, m);
+  }
+
+  batchedInverse<Size>(device, src, dst);
+  for(Index k = 0; k < batch; ++k)
+    VERIFY_IS_APPROX((batch_item<Scalar,Size,Size>(dst,k)), (batch_item<Scalar,Size,Size>(src,k).inverse()));
+
+  // in place
+  Tensor<Scalar,3> copy = src;
+  TensorMap<Tensor<Scalar,3> > map(copy.data(), batch, Size, Size);
+  batchedInverse<Size>(device, map, map);
+  for(Index k = 0; k < batch; ++k)
+    VERIFY_IS_APPROX((batch_item<Scalar,Size,Size>(copy,k)), (batch_item<Scalar,Size,Size>(dst,k)));
+}
+
+template<typename Scalar, int Size, typename Device>
+void test_batched_llt(const Device& device)
+{
+  typedef Matrix<Scalar,Size,Size> MatrixType;
+  const Index batch = internal::random<Index>(1, 200);
+  const Index nrhs = internal::random<Index>(1, 3);
+  Tensor<Scalar,3> mat(batch, Size, Size), rhs(batch, Size, nrhs);
+  rhs.setRandom();
+  for(Index k = 0; k < batch; ++k)
+  {
+    MatrixType a = MatrixType::Random();
+    set_batch_item(mat, k, MatrixType(a * a.adjoint() + MatrixType::Identity()));
+  }
+  // make the last matrix not positive definite
+  set_batch_item(mat, batch-1, MatrixType(-MatrixType::Identity()));
+
+  Tensor<Scalar,3> factors = mat, sol = rhs;
+  Tensor<ComputationInfo,1> info(batch);
+  batchedLLT<Size>(device, factors, info);
+  batchedLLTSolve<Size>(device, factors, sol);
+  for(Index k = 0; k < batch-1; ++k)
+  {
+    LLT<MatrixType> llt(batch_item<Scalar,Size,Size>(mat,k));
+    VERIFY_IS_EQUAL(info(k), Success);
+    VERIFY_IS_APPROX((batch_item<Scalar,Size,Size>(factors,k)), MatrixType(llt.matrixL()));
+    for(Index c = 0; c < nrhs; ++c)
+    {
+      Matrix<Scalar,Size,1> b, x;
+      for(Index i = 0; i < Size; ++i)
+      {
+        b(i) = rhs(k,i,c);
+        x(i) = sol(k,i,c);
+      }
+      VERIFY_IS_APPROX(x, llt.solve(b));
+    }
+  }
+  VERIFY_IS_EQUAL(info(batch-1), NumericalIssue);
+}
+
+template<typename Scalar, int Size, typename Device>
+void test_batched_partial_lu(const Device& device)
+{
+  typedef Matrix<Scalar,Size,Size> MatrixType;
+  const Index batch = internal::random<Index>(1, 200);
+  const Index nrhs = internal::random<Index>(1, 3);
+  Tensor<Scalar,3> mat(batch, Size, Size), rhs(batch, Size, nrhs);
+  rhs.setRandom();
+  for(Index k = 0; k < batch; ++k)
+  {
+    // well conditioned matrices whose largest coefficients are off the diagonal, so that pivoting is needed
+    PermutationMatrix<Size> perm;
+    perm.setIdentity();
+    for(Index i = Size-1; i > 0; --i)
+      perm.applyTranspositionOnTheRight(i, internal::random<Index>(0, i));
+    MatrixType m = MatrixType::Random() + Scalar(Size) * MatrixType(perm);
+    set_batch_item(mat, k, m);
+  }
+  // make the last matrix singular
+  set_batch_item(mat, batch-1, MatrixType(MatrixType::Zero()));
+
+  Tensor<Scalar,3> lu = mat, sol = rhs;
+  Tensor<int,2> transpositions(batch, Size);
+  Tensor<ComputationInfo,1> info(batch);
+  batchedPartialPivLU<Size>(device, lu, transpositions, info);
+  batchedPartialPivLUSolve<Size>(device, lu, transpositions, sol);
+  for(Index k = 0; k < batch-1; ++k)
+  {
+    MatrixType a = batch_item<Scalar,Size,Size>(mat,k);
+    PartialPivLU<MatrixType> ref(a);
+    VERIFY_IS_EQUAL(info(k), Success);
+    VERIFY_IS_APPROX((batch_item<Scalar,Size,Size>(lu,k)), ref.matrixLU());
+    for(Index c = 0; c < nrhs; ++c)
+    {
+      Matrix<Scalar,Size,1> b, x;
+      for(Index i = 0; i < Size; ++i)
+      {
+        b(i) = rhs(k,i,c);
+        x(i) = sol(k,i,c);
+      }
+      VERIFY_IS_APPROX(x, ref.solve(b));
+    }
+  }
+  VERIFY_IS_EQUAL(info(batch-1), NumericalIssue);
+}
+
+template<typename Scalar, typename Device>
+void test_batched_all(const Device& device)
+{
+  test_batched_product<Scalar,2,2,2>(device);
+  test_batched_product<Scalar,3,4,2>(device);
+  test_batched_product<Scalar,7,5,6>(device);
+
+  test_batched_inverse<Scalar,1>(device);
+  test_batched_inverse<Scalar,2>(device);
+  test_batched_inverse<Scalar,3>(device);
+  test_batched_inverse<Scalar,4>(device);
+  test_batched_inverse<Scalar,7>(device);
+
+  test_batched_llt<Scalar,2>(device);
+  test_batched_llt<Scalar,4>(device);
+  test_batched_llt<Scalar,7>(device);
+
+  test_batched_partial_lu<Scalar,2>(device);
+  test_batched_partial_lu<Scalar,4>(device);
+  test_batched_partial_lu<Scalar,7>(device);
+}
+
+template<typename Scalar>
+void test_batched_thread_pool()
+{
+  const int num_threads = internal::random<int>(2, 11);
+  ThreadPool threads(num_threads);
+  ThreadPoolDevice device(&threads, num_threads);
+  test_batched_all<Scalar>(device);
+}
+
+void test_cxx11_batched_linear_algebra()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(test_batched_all<float>(DefaultDevice()));
+    CALL_SUBTEST_2(test_batched_all<double>(DefaultDevice()));
+    CALL_SUBTEST_3(test_batched_all<std::complex<double> >(DefaultDevice()));
+    CALL_SUBTEST_4(test_batched_thread_pool<float>());
+    CALL_SUBTEST_4(test_batched_thread_pool<double>());
+  }
+}
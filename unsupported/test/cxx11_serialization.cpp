@@ -0,0 +1,196 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "sparse.h"
+#include <cstdio>
+#include <unsupported/Eigen/CXX11/Serialization>
+
+using Eigen::Tensor;
+using Eigen::TensorFixedSize;
+using Eigen::TensorMap;
+
+static const std::string filename = "cxx11_serialization.bin";
+
+template<typename MatrixType>
+void test_dense_serialization(const MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  VERIFY(saveBinary(m, filename));
+
+  MatrixType m2;
+  VERIFY(loadBinary(m2, filename));
+  VERIFY((m2.array()==m.array()).all());
+
+  MappedBinaryFile file;
+  VERIFY(file.open(filename));
+  VERIFY(file.holds<MatrixType>());
+  VERIFY_IS_EQUAL(file.rank(), 2);
+  VERIFY_IS_EQUAL(file.dimension(0), m.rows());
+  VERIFY_IS_EQUAL(file.dimension(1), m.cols());
+  Map<MatrixType> map = file.map<MatrixType>();
+  VERIFY((map.array()==m.array()).all());
+  if(m.size()>0)
+    VERIFY(internal::UIntPtr(map.data()) % internal::BinaryFormatAlignment == 0);
+
+  // the scalar type and the storage order must match
+  typedef Matrix<typename internal::conditional<internal::is_same<Scalar,float>::value,double,float>::type,Dynamic,Dynamic> OtherScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic,MatrixType::IsRowMajor ? ColMajor : RowMajor> OtherOrder;
+  typedef Matrix<Scalar,3,Dynamic> ThreeRows;
+  VERIFY(!file.holds<OtherScalar>());
+  VERIFY(file.holds<OtherOrder>() == (m.rows()==1 || m.cols()==1));
+  typedef Tensor<Scalar,2> TensorType;
+  VERIFY(!file.holds<TensorType>());
+  VERIFY(!file.holds<SparseMatrix<Scalar> >());
+  VERIFY(!file.holds<ThreeRows>() || m.rows()==3);
+}
+
+template<typename Scalar>
+void test_tensor_serialization()
+{
+  Tensor<Scalar,3> t(internal::random<int>(1,10), internal::random<int>(1,10), internal::random<int>(1,10));
+  t.setRandom();
+  VERIFY(saveBinary(t, filename));
+
+  Tensor<Scalar,3> t2;
+  VERIFY(loadBinary(t2, filename));
+  for(int i = 0; i < 3; ++i)
+    VERIFY_IS_EQUAL(t2.dimension(i), t.dimension(i));
+  for(Index k = 0; k < t.size(); ++k)
+    VERIFY_IS_EQUAL(t2.data()[k], t.data()[k]);
+
+  {
+    MappedBinaryFile file;
+    VERIFY(file.open(filename));
+    typedef Tensor<Scalar,3,RowMajor> OtherOrder;
+    typedef Tensor<Scalar,2> OtherRank;
+    VERIFY(!file.holds<OtherRank>());
+    VERIFY(!file.holds<OtherOrder>());
+    TensorMap<Tensor<Scalar,3> > map = file.map<Tensor<Scalar,3> >();
+    VERIFY_IS_EQUAL(map.dimension(2), t.dimension(2));
+    VERIFY_IS_EQUAL(map(0,0,0), t(0,0,0));
+    // the mapping is private
+    map(0,0,0) = Scalar(0);
+    VERIFY(loadBinary(t2, filename));
+    VERIFY_IS_EQUAL(t2(0,0,0), t(0,0,0));
+  }
+
+  TensorFixedSize<Scalar,Sizes<2,3,4>,RowMajor> f, f2;
+  f.setRandom();
+  VERIFY(saveBinary(f, filename));
+  VERIFY(loadBinary(f2, filename));
+  for(Index k = 0; k < f.size(); ++k)
+    VERIFY_IS_EQUAL(f2.data()[k], f.data()[k]);
+  Tensor<Scalar,3,RowMajor> r;
+  VERIFY(loadBinary(r, filename));
+  VERIFY_IS_EQUAL(r(1,2,3), f(1,2,3));
+  TensorFixedSize<Scalar,Sizes<2,4,3>,RowMajor> g;
+  VERIFY(!loadBinary(g, filename));
+}
+
+template<typename SparseMatrixType>
+void test_sparse_serialization()
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  Index rows = internal::random<Index>(1,100), cols = internal::random<Index>(1,100);
+  SparseMatrixType m(rows, cols), m2;
+  DenseMatrix refMat = DenseMatrix::Zero(rows, cols);
+  initSparse<Scalar>(0.1, refMat, m);
+  m.uncompress();
+  VERIFY(saveBinary(m, filename));
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_EQUAL(DenseMatrix(m2), refMat);
+
+  MappedBinaryFile file;
+  VERIFY(file.open(filename));
+  VERIFY_IS_EQUAL(file.nonZeros(), m.nonZeros());
+  Map<SparseMatrixType> map = file.map<SparseMatrixType>();
+  VERIFY_IS_EQUAL(DenseMatrix(map), refMat);
+  typedef SparseMatrix<Scalar,SparseMatrixType::IsRowMajor ? ColMajor : RowMajor,typename SparseMatrixType::StorageIndex> OtherOrder;
+  typedef SparseMatrix<Scalar,SparseMatrixType::Options,short> OtherIndex;
+  VERIFY(!file.holds<OtherOrder>());
+  VERIFY(!file.holds<OtherIndex>());
+  VERIFY(!file.holds<DenseMatrix>());
+  file.close();
+
+  // same format as the binary sidecar files of the SparseExtra module
+  m2.resize(1, 1);
+  VERIFY(loadMarketBinary(m2, filename));
+  VERIFY_IS_EQUAL(DenseMatrix(m2), refMat);
+  OtherOrder m3;
+  VERIFY(!loadMarketBinary(m3, filename));
+  VERIFY(saveMarketBinary(m, filename));
+  m2.resize(1, 1);
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_EQUAL(DenseMatrix(m2), refMat);
+}
+
+template<typename Scalar>
+void test_stream_writer()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  Index rows = internal::random<Index>(1,100), cols = internal::random<Index>(1,100);
+  MatrixType m = MatrixType::Random(rows, cols), m2;
+
+  // written column block by column block
+  {
+    BinaryStreamWriter<MatrixType> writer;
+    VERIFY(writer.open(filename, rows, cols));
+    for(Index j = 0; j < cols; j += 7)
+      VERIFY(writer.append(m.middleCols(j, (std::min)(Index(7), cols-j))));
+    VERIFY_IS_EQUAL(writer.remaining(), 0);
+    VERIFY(writer.close());
+  }
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_EQUAL(m2, m);
+
+  // an incomplete file cannot be read
+  {
+    BinaryStreamWriter<MatrixType> writer;
+    VERIFY(writer.open(filename, rows, cols+1));
+    VERIFY(writer.append(m));
+    VERIFY(!writer.close());
+  }
+  MappedBinaryFile file;
+  VERIFY(!file.open(filename));
+  VERIFY(!loadBinary(m2, filename));
+
+  // tensors, from raw buffers
+  Tensor<Scalar,4> t(2, 3, internal::random<int>(1,5), 5), t2;
+  t.setRandom();
+  {
+    BinaryStreamWriter<Tensor<Scalar,4> > writer;
+    VERIFY(writer.open(filename, 2, 3, t.dimension(2), 5));
+    for(Index k = 0; k < t.size(); k += 6)
+      VERIFY(writer.append(t.data()+k, 6));
+    VERIFY(writer.close());
+  }
+  VERIFY(loadBinary(t2, filename));
+  VERIFY_IS_EQUAL(t2.dimension(2), t.dimension(2));
+  for(Index k = 0; k < t.size(); ++k)
+    VERIFY_IS_EQUAL(t2.data()[k], t.data()[k]);
+
+  VERIFY(!loadBinary(t2, "cxx11_serialization_missing.bin"));
+}
+
+void test_cxx11_serialization()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( test_dense_serialization(MatrixXd(MatrixXd::Random(internal::random<int>(1,50), internal::random<int>(1,50)))) );
+    CALL_SUBTEST_1( test_dense_serialization(Matrix<float,Dynamic,Dynamic,RowMajor>(Matrix<float,Dynamic,Dynamic,RowMajor>::Random(internal::random<int>(1,50), 3))) );
+    CALL_SUBTEST_1( test_dense_serialization(Matrix3cd::Random().eval()) );
+    CALL_SUBTEST_1( test_dense_serialization(VectorXi::Random(internal::random<int>(1,50)).eval()) );
+    CALL_SUBTEST_1( test_dense_serialization(ArrayXXf::Random(3, internal::random<int>(1,50)).eval()) );
+    CALL_SUBTEST_2( test_tensor_serialization<float>() );
+    CALL_SUBTEST_2( test_tensor_serialization<std::complex<double> >() );
+    CALL_SUBTEST_3( test_sparse_serialization<SparseMatrix<double> >() );
+    CALL_SUBTEST_3(( test_sparse_serialization<SparseMatrix<std::complex<float>,RowMajor,long int> >() ));
+    CALL_SUBTEST_4( test_stream_writer<double>() );
+    CALL_SUBTEST_4( test_stream_writer<std::complex<float> >() );
+  }
+  std::remove(filename.c_str());
+}
@@ -510,6 +510,50 @@ static void test_const_inputs()
   VERIFY_IS_APPROX(mat3(1,1), mat1(1,0)*mat2(0,1) + mat1(1,1)*mat2(1,1) + mat1(1,2)*mat2(2,1));
 }
 
+// Adds a bias to each column of the result, seen as a matrix in its own
+// layout, then applies a relu.
+struct BiasReluOutputKernel {
+  explicit BiasReluOutputKernel(const float* bias) : m_bias(bias) {}
+
+  template <typename Index, typename Scalar>
+  EIGEN_ALWAYS_INLINE void operator()(
+      const internal::blas_data_mapper<Scalar, Index, ColMajor>& output_mapper,
+      const TensorContractionParams& params, Index i, Index j, Index num_rows,
+      Index num_cols) const {
+    for (Index c = 0; c < num_cols; ++c) {
+      for (Index r = 0; r < num_rows; ++r) {
+        // The evaluator computes the transposed product of RowMajor tensors.
+        const Index col = params.swapped_arguments ? i + r : j + c;
+        output_mapper(r, c) = numext::maxi(output_mapper(r, c) + m_bias[col], Scalar(0));
+      }
+    }
+  }
+
+  const float* m_bias;
+};
+
+template<int DataLayout>
+static void test_output_kernel(int m, int k, int n)
+{
+  Tensor<float, 2, DataLayout> t_left(m, k);
+  Tensor<float, 2, DataLayout> t_right(k, n);
+  Tensor<float, 1, DataLayout> bias(n);
+  t_left.setRandom();
+  t_right.setRandom();
+  bias.setRandom();
+
+  Eigen::array<DimPair, 1> dims = {{DimPair(1, 0)}};
+  Tensor<float, 2, DataLayout> t_result(m, n);
+  t_result = t_left.contract(t_right, dims, BiasReluOutputKernel(bias.data()));
+  Tensor<float, 2, DataLayout> expected = t_left.contract(t_right, dims);
+
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      VERIFY_IS_APPROX(t_result(i, j), numext::maxi(expected(i, j) + bias(j), 0.0f));
+    }
+  }
+}
+
 void test_cxx11_tensor_contraction()
 {
   CALL_SUBTEST(test_evals<ColMajor>());
@@ -542,4 +586,11 @@ void test_cxx11_tensor_contraction()
   CALL_SUBTEST(test_tensor_product<RowMajor>());
   CALL_SUBTEST(test_const_inputs<ColMajor>());
   CALL_SUBTEST(test_const_inputs<RowMajor>());
+  CALL_SUBTEST(test_output_kernel<ColMajor>(30, 50, 70));
+  CALL_SUBTEST(test_output_kernel<RowMajor>(30, 50, 70));
+  CALL_SUBTEST(test_output_kernel<ColMajor>(300, 400, 250));
+  CALL_SUBTEST(test_output_kernel<RowMajor>(300, 400, 250));
+  // matrix-vector products
+  CALL_SUBTEST(test_output_kernel<ColMajor>(30, 50, 1));
+  CALL_SUBTEST(test_output_kernel<RowMajor>(1, 50, 30));
 }
@@ -233,6 +233,96 @@ void test_multithread_contraction_agrees_with_singlethread() {
 }
 
 
+// Contractions with a small output and a large contracting dimension are
+// sharded over the contracting dimension.
+template<int DataLayout>
+void test_multithread_contraction_sharded_by_inner_dim() {
+  const int m = internal::random<int>(1, 40);
+  const int n = internal::random<int>(1, 40);
+  const int k = internal::random<int>(10000, 40000);
+
+  Tensor<float, 2, DataLayout> left(m, k);
+  Tensor<float, 2, DataLayout> right(k, n);
+  left.setRandom();
+  right.setRandom();
+  left += left.constant(1.5f);
+  right += right.constant(1.5f);
+
+  typedef Tensor<float, 1>::DimensionPair DimPair;
+  Eigen::array<DimPair, 1> dims({{DimPair(1, 0)}});
+
+  Eigen::ThreadPool tp(internal::random<int>(2, 11));
+  Eigen::ThreadPoolDevice thread_pool_device(&tp, internal::random<int>(2, 11));
+
+  Tensor<float, 2, DataLayout> st_result;
+  st_result = left.contract(right, dims);
+
+  Tensor<float, 2, DataLayout> tp_result(m, n);
+  tp_result.device(thread_pool_device) = left.contract(right, dims);
+
+  // the result buffer is overwritten, not accumulated into
+  tp_result.device(thread_pool_device) = left.contract(right, dims);
+
+  typedef Map<Matrix<float, Dynamic, Dynamic, DataLayout> > MapXf;
+  MapXf m_left(left.data(), m, k);
+  MapXf m_right(right.data(), k, n);
+  Matrix<float, Dynamic, Dynamic, DataLayout> m_result = m_left * m_right;
+
+  for (ptrdiff_t i = 0; i < st_result.size(); i++) {
+    VERIFY_IS_APPROX(st_result.data()[i], tp_result.data()[i]);
+    VERIFY_IS_APPROX(m_result.data()[i], tp_result.data()[i]);
+  }
+}
+
+// Adds a bias to each column of the result, seen as a matrix in its own
+// layout, then applies a relu.
+struct BiasReluOutputKernel {
+  explicit BiasReluOutputKernel(const float* bias) : m_bias(bias) {}
+
+  template <typename Index, typename Scalar>
+  EIGEN_ALWAYS_INLINE void operator()(
+      const internal::blas_data_mapper<Scalar, Index, ColMajor>& output_mapper,
+      const TensorContractionParams& params, Index i, Index j, Index num_rows,
+      Index num_cols) const {
+    for (Index c = 0; c < num_cols; ++c) {
+      for (Index r = 0; r < num_rows; ++r) {
+        // The evaluator computes the transposed product of RowMajor tensors.
+        const Index col = params.swapped_arguments ? i + r : j + c;
+        output_mapper(r, c) = numext::maxi(output_mapper(r, c) + m_bias[col], Scalar(0));
+      }
+    }
+  }
+
+  const float* m_bias;
+};
+
+template<int DataLayout>
+void test_multithread_contraction_with_output_kernel(int m, int k, int n) {
+  Tensor<float, 2, DataLayout> left(m, k);
+  Tensor<float, 2, DataLayout> right(k, n);
+  Tensor<float, 1, DataLayout> bias(n);
+  left.setRandom();
+  right.setRandom();
+  bias.setRandom();
+
+  typedef Tensor<float, 1>::DimensionPair DimPair;
+  Eigen::array<DimPair, 1> dims({{DimPair(1, 0)}});
+
+  Eigen::ThreadPool tp(internal::random<int>(2, 11));
+  Eigen::ThreadPoolDevice thread_pool_device(&tp, internal::random<int>(2, 11));
+
+  Tensor<float, 2, DataLayout> tp_result(m, n);
+  tp_result.device(thread_pool_device) = left.contract(right, dims, BiasReluOutputKernel(bias.data()));
+  Tensor<float, 2, DataLayout> expected(m, n);
+  expected.device(thread_pool_device) = left.contract(right, dims);
+
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      VERIFY_IS_APPROX(tp_result(i, j), numext::maxi(expected(i, j) + bias(j), 0.0f));
+    }
+  }
+}
+
 template<int DataLayout>
 void test_full_contraction() {
   int contract_size1 = internal::random<int>(1, 500);
@@ -344,6 +434,33 @@ void test_multithread_shuffle()
   }
 }
 
+template<int DataLayout>
+void test_multithread_fft()
+{
+  // power of two and Bluestein lengths, along contiguous and strided dimensions
+  Tensor<float, 3, DataLayout> tensor(64, 37, 5);
+  tensor.setRandom();
+
+  const int num_threads = internal::random<int>(2, 11);
+  ThreadPool threads(num_threads);
+  Eigen::ThreadPoolDevice device(&threads, num_threads);
+
+  array<ptrdiff_t, 2> fft;
+  fft[0] = 0;
+  fft[1] = 1;
+
+  Tensor<std::complex<float>, 3, DataLayout> st_forward = tensor.template fft<BothParts, FFT_FORWARD>(fft);
+  Tensor<std::complex<float>, 3, DataLayout> tp_forward(64, 37, 5);
+  tp_forward.device(device) = tensor.template fft<BothParts, FFT_FORWARD>(fft);
+  Tensor<float, 3, DataLayout> tp_reverse(64, 37, 5);
+  tp_reverse.device(device) = tp_forward.template fft<RealPart, FFT_REVERSE>(fft);
+
+  for (ptrdiff_t i = 0; i < tensor.size(); ++i) {
+    VERIFY_IS_EQUAL(st_forward.data()[i], tp_forward.data()[i]);
+    VERIFY_IS_APPROX(tensor.data()[i] + 1.0f, tp_reverse.data()[i] + 1.0f);
+  }
+}
+
 
 void test_cxx11_tensor_thread_pool()
 {
@@ -355,6 +472,17 @@ void test_cxx11_tensor_thread_pool()
 
   CALL_SUBTEST_3(test_multithread_contraction_agrees_with_singlethread<ColMajor>());
   CALL_SUBTEST_3(test_multithread_contraction_agrees_with_singlethread<RowMajor>());
+  CALL_SUBTEST_3(test_multithread_contraction_sharded_by_inner_dim<ColMajor>());
+  CALL_SUBTEST_3(test_multithread_contraction_sharded_by_inner_dim<RowMajor>());
+  CALL_SUBTEST_3(test_multithread_contraction_with_output_kernel<ColMajor>(
+      internal::random<int>(100, 300), internal::random<int>(100, 300), internal::random<int>(100, 300)));
+  CALL_SUBTEST_3(test_multithread_contraction_with_output_kernel<RowMajor>(
+      internal::random<int>(100, 300), internal::random<int>(100, 300), internal::random<int>(100, 300)));
+  // sharded by the contracting dimension
+  CALL_SUBTEST_3(test_multithread_contraction_with_output_kernel<ColMajor>(
+      internal::random<int>(1, 40), internal::random<int>(10000, 40000), internal::random<int>(1, 40)));
+  CALL_SUBTEST_3(test_multithread_contraction_with_output_kernel<RowMajor>(
+      internal::random<int>(1, 40), internal::random<int>(10000, 40000), internal::random<int>(1, 40)));
 
   // Exercise various cases that have been problematic in the past.
   CALL_SUBTEST_4(test_contraction_corner_cases<ColMajor>());
@@ -370,4 +498,7 @@ void test_cxx11_tensor_thread_pool()
   CALL_SUBTEST_6(test_multithread_random());
   CALL_SUBTEST_6(test_multithread_shuffle<ColMajor>());
   CALL_SUBTEST_6(test_multithread_shuffle<RowMajor>());
+
+  CALL_SUBTEST_6(test_multithread_fft<ColMajor>());
+  CALL_SUBTEST_6(test_multithread_fft<RowMajor>());
 }
@@ -0,0 +1,129 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/QR>
+#include <unsupported/Eigen/IterativeSolvers>
+
+// returns a random matrix of size \a size whose singular values range from 1 to 1/cond
+template<typename MatrixType>
+MatrixType random_with_condition(Index size, typename MatrixType::RealScalar cond)
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  MatrixType u = HouseholderQR<MatrixType>(MatrixType::Random(size,size)).householderQ();
+  MatrixType v = HouseholderQR<MatrixType>(MatrixType::Random(size,size)).householderQ();
+  Matrix<RealScalar,Dynamic,1> s(size);
+  for(Index i = 0; i < size; ++i)
+    s(i) = std::pow(cond, -RealScalar(i)/RealScalar(numext::maxi<Index>(size-1,1)));
+  return u * s.asDiagonal() * v.adjoint();
+}
+
+template<typename MatrixType, typename Factorization, typename Reference>
+void check_mixed_precision(const MatrixType& a, const MatrixType& full)
+{
+  Index size = a.rows();
+  MatrixType b = MatrixType::Random(size, internal::random<Index>(1,4));
+  Matrix<typename MatrixType::Scalar,Dynamic,1> b1 = MatrixType::Random(size,1);
+
+  MixedPrecisionRefinement<MatrixType,Factorization> solver(a);
+  Reference ref(a);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY(!solver.usesFullPrecision());
+
+  MatrixType x = solver.solve(b);
+  VERIFY(solver.iterations() >= 0);
+  VERIFY(!solver.usesFullPrecision());
+  VERIFY_IS_APPROX(x, ref.solve(b));
+  VERIFY_IS_APPROX(full*x, b);
+
+  Matrix<typename MatrixType::Scalar,Dynamic,1> x1 = solver.solve(b1);
+  VERIFY_IS_APPROX(x1, ref.solve(b1));
+
+  // the solution reaches the full precision, contrary to the low precision factorization alone
+  typedef typename Factorization::MatrixType FactorMatrixType;
+  MatrixType xf = solver.factorization().solve(b.template cast<typename FactorMatrixType::Scalar>()).template cast<typename MatrixType::Scalar>();
+  VERIFY((full*x-b).norm() <= (full*xf-b).norm());
+}
+
+template<typename MatrixType, typename Factorization>
+void mixed_precision_fallback()
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  Index size = internal::random<Index>(20,60);
+  MatrixType b = MatrixType::Random(size, 2);
+
+  // too ill-conditioned for the low precision factorization, the refinement cannot converge
+  MatrixType a = random_with_condition<MatrixType>(size, RealScalar(1e10));
+  MixedPrecisionRefinement<MatrixType,Factorization> solver(a);
+  MatrixType x = solver.solve(b);
+  VERIFY(solver.usesFullPrecision());
+  VERIFY_IS_EQUAL(solver.iterations(), -1);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY_IS_APPROX(x, PartialPivLU<MatrixType>(a).solve(b));
+
+  // not representable in low precision
+  a = random_with_condition<MatrixType>(size, RealScalar(10)) * RealScalar(1e300);
+  solver.compute(a);
+  VERIFY(solver.usesFullPrecision());
+  x = solver.solve(b);
+  VERIFY_IS_APPROX(a*x, b);
+
+  // a new matrix starts again with the low precision factorization
+  a = random_with_condition<MatrixType>(size, RealScalar(10));
+  solver.compute(a);
+  VERIFY(!solver.usesFullPrecision());
+  x = solver.solve(b);
+  VERIFY(!solver.usesFullPrecision());
+  VERIFY_IS_APPROX(a*x, b);
+
+  // the maximal number of iterations is honored
+  solver.setMaxIterations(0);
+  x = solver.solve(b);
+  VERIFY(solver.usesFullPrecision());
+  VERIFY_IS_APPROX(a*x, b);
+}
+
+template<typename Scalar> void mixed_precision_lu()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<typename internal::conditional<NumTraits<Scalar>::IsComplex,std::complex<float>,float>::type,Dynamic,Dynamic> FactorMatrixType;
+  Index size = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+  MatrixType a = random_with_condition<MatrixType>(size, typename MatrixType::RealScalar(100));
+  check_mixed_precision<MatrixType, PartialPivLU<FactorMatrixType>, PartialPivLU<MatrixType> >(a, a);
+}
+
+template<typename Scalar> void mixed_precision_cholesky()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<typename internal::conditional<NumTraits<Scalar>::IsComplex,std::complex<float>,float>::type,Dynamic,Dynamic> FactorMatrixType;
+  Index size = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+  MatrixType c = random_with_condition<MatrixType>(size, typename MatrixType::RealScalar(10));
+  MatrixType a = c * c.adjoint();
+
+  check_mixed_precision<MatrixType, LLT<FactorMatrixType>, LLT<MatrixType> >(a, a);
+  check_mixed_precision<MatrixType, LDLT<FactorMatrixType>, LDLT<MatrixType> >(a, a);
+
+  // only the referenced triangular part is used
+  MatrixType upper = a.template triangularView<Upper>();
+  check_mixed_precision<MatrixType, LLT<FactorMatrixType,Upper>, LLT<MatrixType,Upper> >(upper, a);
+
+  // not positive definite
+  MixedPrecisionRefinement<MatrixType, LLT<FactorMatrixType> > llt(-a);
+  VERIFY(llt.usesFullPrecision());
+  VERIFY_IS_EQUAL(llt.info(), NumericalIssue);
+}
+
+void test_mixed_precision_refinement()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( mixed_precision_lu<double>() );
+    CALL_SUBTEST_1(( mixed_precision_fallback<MatrixXd, PartialPivLU<MatrixXf> >() ));
+    CALL_SUBTEST_2( mixed_precision_cholesky<double>() );
+    CALL_SUBTEST_3( mixed_precision_lu<std::complex<double> >() );
+    CALL_SUBTEST_3( mixed_precision_cholesky<std::complex<double> >() );
+  }
+}
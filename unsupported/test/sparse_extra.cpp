@@ -130,6 +130,261 @@ template<typename SparseMatrixType> void sparse_extra(const SparseMatrixType& re
 
 }
 
+template<typename SparseMatrixType> void sparse_market_io(Index rows, Index cols)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  const std::string filename = "sparse_extra_market_io.mtx";
+  const std::string binaryname = filename + ".bin";
+
+  double density = (std::max)(8./(rows*cols), 0.01);
+  SparseMatrixType m(rows, cols), m2;
+  DenseMatrix refMat = DenseMatrix::Zero(rows, cols);
+  initSparse<Scalar>(density, refMat, m);
+
+  // the values are written with enough digits to be read back exactly
+  VERIFY(saveMarket(m, filename));
+  VERIFY(loadMarket(m2, filename));
+  VERIFY_IS_EQUAL(m2.rows(), rows);
+  VERIFY_IS_EQUAL(m2.cols(), cols);
+  VERIFY_IS_EQUAL(m2.nonZeros(), m.nonZeros());
+  VERIFY_IS_EQUAL(DenseMatrix(m2), refMat);
+
+  // binary sidecar
+  m.uncompress();
+  VERIFY(saveMarketBinary(m, binaryname));
+  m2.resize(1,1);
+  VERIFY(loadMarketBinary(m2, binaryname));
+  VERIFY_IS_EQUAL(DenseMatrix(m2), refMat);
+  {
+    MappedMarketBinary<SparseMatrixType> file;
+    VERIFY(file.open(binaryname));
+    Map<SparseMatrixType> map = file.matrix();
+    VERIFY_IS_EQUAL(map.nonZeros(), m.nonZeros());
+    VERIFY_IS_EQUAL(DenseMatrix(map), refMat);
+    // the mapping is private
+    if(map.nonZeros()>0)
+      map.valuePtr()[0] = Scalar(0);
+    MappedMarketBinary<SparseMatrixType> other;
+    VERIFY(other.open(binaryname));
+    VERIFY_IS_EQUAL(DenseMatrix(other.matrix()), refMat);
+  }
+
+  // the binary file must hold the same matrix type
+  typedef SparseMatrix<Scalar, SparseMatrixType::IsRowMajor ? ColMajor : RowMajor, typename SparseMatrixType::StorageIndex> OtherOrder;
+  OtherOrder m3;
+  VERIFY(!loadMarketBinary(m3, binaryname));
+  SparseMatrix<float,SparseMatrixType::Options> m4;
+  VERIFY(!loadMarketBinary(m4, binaryname));
+  VERIFY(!loadMarketBinary(m2, filename));
+  VERIFY(!loadMarketBinary(m2, "sparse_extra_missing_file.bin"));
+  VERIFY(!loadMarket(m2, "sparse_extra_missing_file.mtx"));
+
+  std::remove(filename.c_str());
+  std::remove(binaryname.c_str());
+}
+
+void sparse_market_parse()
+{
+  const std::string filename = "sparse_extra_market_parse.mtx";
+  {
+    std::ofstream out(filename.c_str());
+    out << "%%MatrixMarket matrix coordinate real general\n"
+        << "% a comment\n"
+        << "\n"
+        << "  4 3   6\r\n"
+        << "1 1 1.5\n"
+        << "% a comment among the entries\n"
+        << "2\t3 -2e-3\r\n"
+        << "  4 2 .25E+2\n"
+        << "3 1 +7\n"
+        << "\n"
+        << "3 1 1.00000000000000000000000000000000001\n"
+        << "4 3 -0.1234567890123456789e-300";
+  }
+  SparseMatrix<double> m;
+  VERIFY(loadMarket(m, filename));
+  MatrixXd ref = MatrixXd::Zero(4,3);
+  ref(0,0) = 1.5;
+  ref(1,2) = -2e-3;
+  ref(3,1) = 25;
+  ref(2,0) = 8;
+  ref(3,2) = -0.1234567890123456789e-300;
+  VERIFY_IS_EQUAL(m.nonZeros(), 5);
+  VERIFY_IS_EQUAL(MatrixXd(m), ref);
+
+  // large enough to be split into several chunks
+  SparseMatrix<std::complex<double>,RowMajor> c(1000,2000), c2;
+  c.reserve(VectorXi::Constant(1000,60));
+  for(Index i=0; i<1000; ++i)
+    for(Index k=0; k<60; ++k)
+      c.insert(i, (i*37+k*31)%2000) = internal::random<std::complex<double> >();
+  c.makeCompressed();
+  VERIFY(saveMarket(c, filename));
+  VERIFY(loadMarket(c2, filename));
+  VERIFY_IS_EQUAL(c2.nonZeros(), c.nonZeros());
+  VERIFY_IS_EQUAL(MatrixXcd(c2), MatrixXcd(c));
+
+  std::remove(filename.c_str());
+}
+
+template<typename Scalar, int SliceHeight> void sparse_sell_c_sigma(Index rows, Index cols)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  typedef SellCSigmaMatrix<Scalar,SliceHeight> SellMatrix;
+  SparseMatrix<Scalar> m(rows, cols);
+  DenseMatrix refMat = DenseMatrix::Zero(rows, cols);
+  initSparse<Scalar>(0.2, refMat, m);
+  // rows of very different lengths, and some empty rows
+  for(Index j = 0; j < cols; ++j)
+    if(rows > 1 && refMat(rows/2, j) == Scalar(0))
+      m.coeffRef(rows/2, j) = refMat(rows/2, j) = internal::random<Scalar>();
+  for(Index j = 0; j < cols; ++j)
+    m.coeffRef(0, j) = refMat(0, j) = Scalar(0);
+  m.prune(Scalar(0));
+
+  DenseVector x = DenseVector::Random(cols), y = DenseVector::Random(rows);
+  DenseMatrix X = DenseMatrix::Random(cols, 3), Y = DenseMatrix::Random(3, cols);
+  Index sigmas[] = { 1, SliceHeight, internal::random<Index>(1,200), 32*SliceHeight };
+  for(int k = 0; k < 4; ++k)
+  {
+    SellMatrix a(m, sigmas[k]);
+    VERIFY_IS_EQUAL(a.rows(), rows);
+    VERIFY_IS_EQUAL(a.cols(), cols);
+    VERIFY_IS_EQUAL(a.nonZeros(), m.nonZeros());
+    VERIFY(a.storedCoefficients() >= a.nonZeros());
+    VERIFY(a.storedCoefficients() % SliceHeight == 0);
+    VERIFY_IS_EQUAL(DenseMatrix(a.toSparse()), refMat);
+
+    VERIFY_IS_APPROX(DenseVector(a * x), refMat * x);
+    DenseVector y2 = y;
+    y2.noalias() += Scalar(2) * (a * x);
+    VERIFY_IS_APPROX(y2, y + Scalar(2) * (refMat * x));
+    VERIFY_IS_APPROX(DenseMatrix(a * X), refMat * X);
+    VERIFY_IS_APPROX(DenseVector(a * X.col(1)), refMat * X.col(1));
+    VERIFY_IS_APPROX(DenseVector(a * Y.row(1).transpose()), refMat * Y.row(1).transpose());
+  }
+
+  // sorting the rows over the whole matrix reduces the padding
+  SellMatrix sorted(m, rows), unsorted(m, 1);
+  VERIFY(sorted.storedCoefficients() <= unsorted.storedCoefficients());
+
+  // iterative solvers
+  if(rows == cols)
+  {
+    SparseMatrix<Scalar> spd = m.adjoint() * m;
+    for(Index i = 0; i < rows; ++i)
+      spd.coeffRef(i, i) += Scalar(1);
+    DenseVector b = DenseVector::Random(rows);
+    SellMatrix a(spd);
+    ConjugateGradient<SellMatrix, Lower|Upper> cg(a);
+    cg.setTolerance(test_precision<Scalar>());
+    DenseVector sol = cg.solve(b);
+    VERIFY_IS_EQUAL(cg.info(), Success);
+    VERIFY((DenseMatrix(spd) * sol - b).norm() <= 10 * test_precision<Scalar>() * b.norm());
+
+    SparseMatrix<Scalar> gen = spd;
+    for(Index i = 0; i + 1 < rows; ++i)
+      gen.coeffRef(i, i+1) += Scalar(0.5);
+    SellMatrix g(gen);
+    BiCGSTAB<SellMatrix> bicg(g);
+    bicg.setTolerance(test_precision<Scalar>());
+    sol = bicg.solve(b);
+    VERIFY_IS_EQUAL(bicg.info(), Success);
+    VERIFY((DenseMatrix(gen) * sol - b).norm() <= 10 * test_precision<Scalar>() * b.norm());
+  }
+}
+
+template<typename Scalar, int BlockSize, int Options> void sparse_block_product(Index blockRows, Index blockCols, Index blockSize)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  typedef BlockSparseMatrix<Scalar,BlockSize,Options> BlockMatrix;
+  if(BlockSize != Dynamic)
+    blockSize = BlockSize;
+  const Index rows = blockRows*blockSize, cols = blockCols*blockSize;
+  SparseMatrix<Scalar,Options> m(rows, cols);
+  DenseMatrix refMat = DenseMatrix::Zero(rows, cols);
+  initSparse<Scalar>(0.1, refMat, m);
+
+  BlockMatrix b(blockRows, blockCols);
+  b.setBlockSize(blockSize);
+  b = m;
+  VERIFY_IS_EQUAL(b.rows(), rows);
+  VERIFY_IS_EQUAL(b.cols(), cols);
+  VERIFY(b.nonZeros() >= m.nonZeros());
+
+  DenseVector x = DenseVector::Random(cols), y = DenseVector::Random(rows);
+  DenseMatrix X = DenseMatrix::Random(cols, 3), Y = DenseMatrix::Random(3, cols);
+  VERIFY_IS_APPROX(DenseVector(b * x), refMat * x);
+  DenseVector y2 = y;
+  y2.noalias() += Scalar(2) * (b * x);
+  VERIFY_IS_APPROX(y2, y + Scalar(2) * (refMat * x));
+  VERIFY_IS_APPROX(DenseMatrix(b * X), refMat * X);
+  VERIFY_IS_APPROX(DenseVector(b * Y.row(1).transpose()), refMat * Y.row(1).transpose());
+}
+
+template<typename Scalar, int BlockSize, int Options> void sparse_block_from_sparse(Index blockRows, Index blockCols)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  SparseMatrix<Scalar,Options> m(blockRows*BlockSize, blockCols*BlockSize);
+  DenseMatrix refMat = DenseMatrix::Zero(m.rows(), m.cols());
+  initSparse<Scalar>(0.1, refMat, m);
+
+  // the block layout is deduced from the fixed block size
+  BlockSparseMatrix<Scalar,BlockSize,Options> b(m);
+  VERIFY_IS_EQUAL(b.rows(), m.rows());
+  VERIFY_IS_EQUAL(b.cols(), m.cols());
+  DenseVector x = DenseVector::Random(m.cols());
+  VERIFY_IS_APPROX(DenseVector(b * x), refMat * x);
+}
+
+template<typename Scalar, int Options> void sparse_variable_block_product(Index blockRows, Index blockCols)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,Dynamic,Options> BlockType;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  typedef BlockSparseMatrix<Scalar,Dynamic,Options> BlockMatrix;
+  VectorXi rowBlocks(blockRows), colBlocks(blockCols);
+  for(Index i = 0; i < blockRows; ++i) rowBlocks(i) = internal::random<int>(1,5);
+  for(Index j = 0; j < blockCols; ++j) colBlocks(j) = internal::random<int>(1,5);
+  VectorXi rowStart(blockRows), colStart(blockCols);
+  rowStart(0) = colStart(0) = 0;
+  for(Index i = 1; i < blockRows; ++i) rowStart(i) = rowStart(i-1) + rowBlocks(i-1);
+  for(Index j = 1; j < blockCols; ++j) colStart(j) = colStart(j-1) + colBlocks(j-1);
+
+  // the layout is deduced from the blocks, such that each block row and column needs a nonzero block
+  Matrix<bool,Dynamic,Dynamic> pattern = Matrix<bool,Dynamic,Dynamic>::Constant(blockRows, blockCols, false);
+  for(Index i = 0; i < blockRows; ++i) pattern(i, i % blockCols) = true;
+  for(Index j = 0; j < blockCols; ++j) pattern(j % blockRows, j) = true;
+  for(Index k = 0; k < blockRows*blockCols/8; ++k)
+    pattern(internal::random<Index>(0,blockRows-1), internal::random<Index>(0,blockCols-1)) = true;
+
+  typedef Triplet<BlockType> BlockTriplet;
+  std::vector<BlockTriplet> triplets;
+  DenseMatrix refMat = DenseMatrix::Zero(rowBlocks.sum(), colBlocks.sum());
+  for(Index i = 0; i < blockRows; ++i)
+    for(Index j = 0; j < blockCols; ++j)
+      if(pattern(i, j))
+      {
+        BlockType block = BlockType::Random(rowBlocks(i), colBlocks(j));
+        refMat.block(rowStart(i), colStart(j), rowBlocks(i), colBlocks(j)) = block;
+        triplets.push_back(BlockTriplet(i, j, block));
+      }
+
+  BlockMatrix b(blockRows, blockCols);
+  b.setFromTriplets(triplets.begin(), triplets.end());
+  VERIFY_IS_EQUAL(b.rows(), refMat.rows());
+  VERIFY_IS_EQUAL(b.cols(), refMat.cols());
+
+  DenseVector x = DenseVector::Random(refMat.cols());
+  DenseMatrix X = DenseMatrix::Random(refMat.cols(), 2);
+  VERIFY_IS_APPROX(DenseVector(b * x), refMat * x);
+  VERIFY_IS_APPROX(DenseMatrix(b * X), refMat * X);
+}
+
 void test_sparse_extra()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -144,5 +399,37 @@ void test_sparse_extra()
 
 //    CALL_SUBTEST_3( (sparse_product<DynamicSparseMatrix<float, ColMajor> >()) );
 //    CALL_SUBTEST_3( (sparse_product<DynamicSparseMatrix<float, RowMajor> >()) );
+
+    CALL_SUBTEST_4( (sparse_market_io<SparseMatrix<double> >(s, s+1)) );
+    CALL_SUBTEST_4( (sparse_market_io<SparseMatrix<float,RowMajor,long int> >(s+1, s)) );
+    CALL_SUBTEST_4( (sparse_market_io<SparseMatrix<std::complex<double> > >(s, s)) );
+    TEST_SET_BUT_UNUSED_VARIABLE(s)
+  }
+  CALL_SUBTEST_4( sparse_market_parse() );
+
+  for(int i = 0; i < g_repeat; i++) {
+    Index n = internal::random<Index>(1,300);
+    CALL_SUBTEST_5(( sparse_sell_c_sigma<double,8>(n, n) ));
+    CALL_SUBTEST_5(( sparse_sell_c_sigma<float,16>(n, internal::random<Index>(1,300)) ));
+    CALL_SUBTEST_5(( sparse_sell_c_sigma<double,3>(internal::random<Index>(1,300), n) ));
+    CALL_SUBTEST_5(( sparse_sell_c_sigma<std::complex<double>,4>(n, n) ));
+    TEST_SET_BUT_UNUSED_VARIABLE(n)
+  }
+  CALL_SUBTEST_5(( sparse_sell_c_sigma<double,8>(1000, 1000) ));
+
+  for(int i = 0; i < g_repeat; i++) {
+    Index br = internal::random<Index>(1,60), bc = internal::random<Index>(1,60);
+    CALL_SUBTEST_6(( sparse_block_product<double,3,ColMajor>(br, bc, 3) ));
+    CALL_SUBTEST_6(( sparse_block_product<double,4,RowMajor>(br, bc, 4) ));
+    CALL_SUBTEST_6(( sparse_block_product<std::complex<double>,2,RowMajor>(br, bc, 2) ));
+    CALL_SUBTEST_6(( sparse_block_product<float,Dynamic,RowMajor>(br, bc, internal::random<Index>(1,6)) ));
+    CALL_SUBTEST_6(( sparse_block_from_sparse<double,3,ColMajor>(br, bc) ));
+    CALL_SUBTEST_6(( sparse_block_from_sparse<float,2,RowMajor>(br, bc) ));
+    CALL_SUBTEST_6(( sparse_variable_block_product<double,ColMajor>(br, bc) ));
+    CALL_SUBTEST_6(( sparse_variable_block_product<double,RowMajor>(br, bc) ));
+    TEST_SET_BUT_UNUSED_VARIABLE(br)
+    TEST_SET_BUT_UNUSED_VARIABLE(bc)
   }
+  // large enough for the block rows to be computed in parallel
+  CALL_SUBTEST_6(( sparse_block_product<double,4,RowMajor>(300, 300, 4) ));
 }